@@ -75,8 +75,21 @@ typedef enum {
 	POSITION_UPDATED = 0,   ///< This type is used when position information is updated.
 	VELOCITY_UPDATED,       ///< This type is used when velocity information is updated.
 	SATELLITE_UPDATED,		///< This type is used when satellite information is updated.
+	FIX_UPDATED,            ///< This type is used when the fix of an epoch is updated, with the "fix-updates" property.
+	BATCH_UPDATED,          ///< This type is used when a batch of positions is delivered, with the "batch-size" property.
 } LocationUpdateType;
 
+/**
+ * @brief This represents the update types a callback added by #location_subscribe is called for.
+ */
+typedef enum {
+	LOCATION_UPDATE_MASK_POSITION = 1 << POSITION_UPDATED,		///< Position updates, data is a #LocationPosition.
+	LOCATION_UPDATE_MASK_VELOCITY = 1 << VELOCITY_UPDATED,		///< Velocity updates, data is a #LocationVelocity.
+	LOCATION_UPDATE_MASK_SATELLITE = 1 << SATELLITE_UPDATED,	///< Satellite updates, data is a #LocationSatellite.
+	LOCATION_UPDATE_MASK_FIX = 1 << FIX_UPDATED,			///< Fix updates, data is a #LocationFix.
+	LOCATION_UPDATE_MASK_BATCH = 1 << BATCH_UPDATED,		///< Batch updates, data is a #LocationBatch.
+} LocationUpdateMask;
+
 /**
  * @brief Location object redefined by GObject.
  */
@@ -108,11 +121,26 @@ typedef struct _LocationVelocity   LocationVelocity;
  */
 typedef struct _LocationAccuracy   LocationAccuracy;
 
+/**
+ * @brief This represents position, velocity, accuracy and satellite information of one epoch.
+ */
+typedef struct _LocationFix   LocationFix;
+
+/**
+ * @brief This represents the positions received since the previous batch.
+ */
+typedef struct _LocationBatch   LocationBatch;
+
 /**
  * @brief This represents boundary information such as rectangular or circle area.
  */
 typedef struct _LocationBoundary   LocationBoundary;
 
+/**
+ * @brief This represents the callback added by #location_subscribe, called with the same arguments as the "service-updated" signal.
+ */
+typedef void (*LocationUpdateCB)(LocationObject *obj, LocationUpdateType type, gconstpointer data, const LocationAccuracy *accuracy, gpointer userdata);
+
 /**
  * @}@}
  */
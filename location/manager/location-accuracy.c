@@ -24,8 +24,15 @@
 #endif
 
 #include "location-accuracy.h"
+#include "location-snapshot.h"
 #include "location-log.h"
 
+/* Layout of the accuracy_snapshot_*() copies, see location-snapshot.h */
+typedef struct {
+	LocationAccuracy accuracy;
+	volatile gint ref_count;
+} AccuracySnapshot;
+
 GType
 location_accuracy_get_type (void)
 {
@@ -45,7 +52,7 @@ location_accuracy_new (LocationAccuracyLevel level,
 	gdouble horizontal_accuracy,
 	gdouble vertical_accuracy)
 {
-	LocationAccuracy* accuracy = g_slice_new0 (LocationAccuracy);
+	LocationAccuracy *accuracy = g_slice_new0 (LocationAccuracy);
 	accuracy->level = level;
 	accuracy->horizontal_accuracy = horizontal_accuracy;
 	accuracy->vertical_accuracy = vertical_accuracy;
@@ -60,6 +67,47 @@ location_accuracy_free (LocationAccuracy* accuracy)
 	g_slice_free (LocationAccuracy, accuracy);
 }
 
+LocationAccuracy *
+accuracy_snapshot_new (const LocationAccuracy *accuracy)
+{
+	AccuracySnapshot *snapshot = g_slice_new0 (AccuracySnapshot);
+	if (accuracy) snapshot->accuracy = *accuracy;
+	snapshot->ref_count = 1;
+	return &snapshot->accuracy;
+}
+
+LocationAccuracy *
+accuracy_snapshot_ref (LocationAccuracy *snapshot)
+{
+	g_return_val_if_fail (snapshot, NULL);
+
+	g_atomic_int_inc (&((AccuracySnapshot *) snapshot)->ref_count);
+	return snapshot;
+}
+
+void
+accuracy_snapshot_unref (LocationAccuracy *snapshot)
+{
+	g_return_if_fail (snapshot);
+
+	if (g_atomic_int_dec_and_test (&((AccuracySnapshot *) snapshot)->ref_count))
+		g_slice_free (AccuracySnapshot, (AccuracySnapshot *) snapshot);
+}
+
+void
+accuracy_snapshot_update (LocationAccuracy **snapshot, const LocationAccuracy *accuracy)
+{
+	g_return_if_fail (snapshot);
+	g_return_if_fail (accuracy);
+
+	if (*snapshot && g_atomic_int_get (&((AccuracySnapshot *) *snapshot)->ref_count) == 1) {
+		**snapshot = *accuracy;
+		return;
+	}
+	if (*snapshot) accuracy_snapshot_unref (*snapshot);
+	*snapshot = accuracy_snapshot_new (accuracy);
+}
+
 static int
 comp_int(int a, int b){
 	if (a < b) return -1;
@@ -0,0 +1,337 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <unistd.h>
+#include "location-boundary.h"
+#include "location-fence-set.h"
+#include "location-log.h"
+
+#define ASSET_CHUNK_SIZE	64	/* assets claimed at once by a worker */
+
+/**
+ * The assets of a batch are cut into chunks that the caller and the pool threads claim one by one
+ * from a shared counter, so a thread done with cheap chunks keeps taking more while another one is
+ * busy with expensive ones. All the records of an asset go to the same chunk, in their batch order.
+ * Each chunk writes its own transitions, concatenated in chunk order at the end, so the result does
+ * not depend on the scheduling.
+ * The fence set is only read during a batch; the monitor and the set are changed from the caller thread.
+ */
+typedef struct {
+	guint asset_id;
+	GArray *inside;		/* LocationBoundary pointers containing the last position, sorted */
+	guint serial;		/* last batch with records of the asset */
+	gint first;		/* first and last record of the asset in the batch */
+	gint last;
+} AssetState;
+
+typedef struct {
+	const LocationAssetPosition *records;
+	gint *next;		/* next record of the same asset, -1 at the end */
+	AssetState **work;
+	guint work_count;
+	guint chunk_count;
+	volatile gint next_chunk;
+} AssetBatch;
+
+struct _LocationAssetMonitor {
+	LocationFenceSubscription *subscription;
+	const LocationBoundaryIndex *index;
+	GHashTable *assets;	/* asset id -> AssetState */
+	GThreadPool *pool;
+	guint thread_count;
+	GAsyncQueue *done;	/* one AssetBatch pushed per pool task finished */
+	AssetBatch *batch;
+	guint serial;
+	GPtrArray *chunk_transitions;	/* GArray of LocationZoneTransition per chunk */
+	GArray *transitions;
+};
+
+static gint
+_compare_pointer (gconstpointer a, gconstpointer b)
+{
+	gconstpointer pa = *(gconstpointer *) a;
+	gconstpointer pb = *(gconstpointer *) b;
+	return (pa > pb) - (pa < pb);
+}
+
+typedef struct {
+	const LocationPosition *position;
+	GArray *inside_list;	/* LocationBoundary pointers */
+} AssetScan;
+
+static gboolean
+_collect_inside (LocationBoundary *boundary, gpointer user_data)
+{
+	AssetScan *scan = (AssetScan *) user_data;
+
+	if (location_boundary_if_inside (boundary, (LocationPosition *) scan->position)) {
+		g_array_append_val (scan->inside_list, boundary);
+	}
+	return FALSE;
+}
+
+static void
+_append_transition (GArray *transitions, const LocationAssetPosition *record, gpointer boundary, gboolean entered)
+{
+	LocationZoneTransition transition;
+
+	transition.asset_id = record->asset_id;
+	transition.timestamp = record->position.timestamp;
+	transition.boundary = (LocationBoundary *) boundary;
+	transition.entered = entered;
+	g_array_append_val (transitions, transition);
+}
+
+static void
+_update_asset (const LocationAssetMonitor *monitor, const AssetBatch *batch, AssetState *state, GArray *scratch, GArray *transitions)
+{
+	gint i;
+
+	for (i = state->first; i >= 0; i = batch->next[i]) {
+		const LocationAssetPosition *record = &batch->records[i];
+		gpointer *now = NULL, *before = NULL;
+		guint now_len, before_len, a = 0, b = 0;
+
+		AssetScan scan = { &record->position, scratch };
+
+		g_array_set_size (scratch, 0);
+		boundary_index_foreach_candidate (monitor->index, &record->position, _collect_inside, &scan);
+
+		now = (gpointer *) scratch->data;
+		now_len = scratch->len;
+		qsort (now, now_len, sizeof (gpointer), _compare_pointer);
+		before = (gpointer *) state->inside->data;
+		before_len = state->inside->len;
+
+		/* Merge of the two sorted sets */
+		while (a < now_len || b < before_len) {
+			if (b == before_len || (a < now_len && now[a] < before[b])) {
+				_append_transition (transitions, record, now[a++], TRUE);
+			} else if (a == now_len || before[b] < now[a]) {
+				_append_transition (transitions, record, before[b++], FALSE);
+			} else {
+				a++;
+				b++;
+			}
+		}
+
+		g_array_set_size (state->inside, 0);
+		g_array_append_vals (state->inside, now, now_len);
+	}
+}
+
+static void
+_run_chunks (LocationAssetMonitor *monitor, AssetBatch *batch)
+{
+	GArray *scratch = g_array_new (FALSE, FALSE, sizeof (gpointer));
+	gint chunk;
+
+	while ((chunk = g_atomic_int_add (&batch->next_chunk, 1)) < (gint) batch->chunk_count) {
+		GArray *transitions = (GArray *) g_ptr_array_index (monitor->chunk_transitions, chunk);
+		guint i, last = MIN((chunk + 1) * ASSET_CHUNK_SIZE, batch->work_count);
+
+		g_array_set_size (transitions, 0);
+		for (i = chunk * ASSET_CHUNK_SIZE; i < last; i++)
+			_update_asset (monitor, batch, batch->work[i], scratch, transitions);
+	}
+
+	g_array_free (scratch, TRUE);
+}
+
+static void
+_pool_func (gpointer data, gpointer user_data)
+{
+	LocationAssetMonitor *monitor = (LocationAssetMonitor *) user_data;
+	AssetBatch *batch = (AssetBatch *) data;
+
+	_run_chunks (monitor, batch);
+	g_async_queue_push (monitor->done, batch);
+}
+
+static void
+_free_asset (gpointer data)
+{
+	AssetState *state = (AssetState *) data;
+	g_array_free (state->inside, TRUE);
+	g_slice_free (AssetState, state);
+}
+
+static void
+_fence_removed (LocationBoundary *boundary, gpointer user_data)
+{
+	LocationAssetMonitor *monitor = (LocationAssetMonitor *) user_data;
+	GHashTableIter iter;
+	gpointer value = NULL;
+	guint i;
+
+	g_hash_table_iter_init (&iter, monitor->assets);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		GArray *inside = ((AssetState *) value)->inside;
+		for (i = 0; i < inside->len; i++) {
+			if (g_array_index (inside, gpointer, i) == boundary) {
+				g_array_remove_index (inside, i);
+				break;
+			}
+		}
+	}
+}
+
+EXPORT_API LocationAssetMonitor *
+location_asset_monitor_new (guint fence_set, guint thread_count)
+{
+	fence_set_lock ();
+	LocationFenceSet *set = fence_set_lookup (fence_set);
+	if (!set) {
+		fence_set_unlock ();
+		LOCATION_LOGW("No fence set [%u]", fence_set);
+		return NULL;
+	}
+
+	LocationAssetMonitor *monitor = g_slice_new0 (LocationAssetMonitor);
+
+	if (thread_count == 0) {
+		long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+		thread_count = cpus > 0 ? (guint) cpus : 1;
+	}
+
+	monitor->subscription = fence_set_subscribe (set);
+	fence_subscription_set_removed_func (monitor->subscription, _fence_removed, monitor);
+	monitor->index = fence_set_get_index (set);
+	fence_set_unlock ();
+	monitor->assets = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, _free_asset);
+	monitor->thread_count = thread_count;
+	if (thread_count > 1) {
+		/* The caller thread takes part in every batch */
+		monitor->pool = g_thread_pool_new (_pool_func, monitor, thread_count - 1, TRUE, NULL);
+		if (!monitor->pool) {
+			LOCATION_LOGW("Fail to create the thread pool, evaluating in the caller thread");
+			monitor->thread_count = 1;
+		}
+	}
+	monitor->done = g_async_queue_new ();
+	monitor->chunk_transitions = g_ptr_array_new ();
+	monitor->transitions = g_array_new (FALSE, FALSE, sizeof (LocationZoneTransition));
+
+	return monitor;
+}
+
+EXPORT_API void
+location_asset_monitor_free (LocationAssetMonitor *monitor)
+{
+	g_return_if_fail (monitor);
+
+	guint i;
+
+	if (monitor->pool) g_thread_pool_free (monitor->pool, FALSE, TRUE);
+	fence_set_unsubscribe (monitor->subscription);
+	g_hash_table_destroy (monitor->assets);
+	g_async_queue_unref (monitor->done);
+	for (i = 0; i < monitor->chunk_transitions->len; i++)
+		g_array_free ((GArray *) g_ptr_array_index (monitor->chunk_transitions, i), TRUE);
+	g_ptr_array_free (monitor->chunk_transitions, TRUE);
+	g_array_free (monitor->transitions, TRUE);
+	g_slice_free (LocationAssetMonitor, monitor);
+}
+
+EXPORT_API int
+location_asset_monitor_update (LocationAssetMonitor *monitor,
+	const LocationAssetPosition *records,
+	guint count,
+	GArray **transitions)
+{
+	g_return_val_if_fail (monitor, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (records || !count, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (transitions, LOCATION_ERROR_PARAMETER);
+
+	AssetBatch batch;
+	guint i, tasks = 0;
+
+	memset (&batch, 0, sizeof (batch));
+	batch.records = records;
+	batch.next = g_new (gint, count);
+	batch.work = g_new (AssetState *, count);
+	monitor->serial++;
+
+	/* Asset states are created here, the workers only read the table */
+	for (i = 0; i < count; i++) {
+		AssetState *state = g_hash_table_lookup (monitor->assets, GUINT_TO_POINTER(records[i].asset_id));
+		if (!state) {
+			state = g_slice_new0 (AssetState);
+			state->asset_id = records[i].asset_id;
+			state->inside = g_array_new (FALSE, FALSE, sizeof (gpointer));
+			g_hash_table_insert (monitor->assets, GUINT_TO_POINTER(state->asset_id), state);
+		}
+
+		batch.next[i] = -1;
+		if (state->serial != monitor->serial) {
+			state->serial = monitor->serial;
+			state->first = i;
+			batch.work[batch.work_count++] = state;
+		} else {
+			batch.next[state->last] = i;
+		}
+		state->last = i;
+	}
+
+	batch.chunk_count = (batch.work_count + ASSET_CHUNK_SIZE - 1) / ASSET_CHUNK_SIZE;
+	while (monitor->chunk_transitions->len < batch.chunk_count)
+		g_ptr_array_add (monitor->chunk_transitions, g_array_new (FALSE, FALSE, sizeof (LocationZoneTransition)));
+
+	/* No fence is removed from the set while the workers read its index */
+	fence_set_lock ();
+	if (monitor->pool) {
+		tasks = MIN(monitor->thread_count - 1, batch.chunk_count > 0 ? batch.chunk_count - 1 : 0);
+		for (i = 0; i < tasks; i++)
+			g_thread_pool_push (monitor->pool, &batch, NULL);
+	}
+
+	_run_chunks (monitor, &batch);
+
+	for (i = 0; i < tasks; i++)
+		g_async_queue_pop (monitor->done);
+	fence_set_unlock ();
+
+	g_array_set_size (monitor->transitions, 0);
+	for (i = 0; i < batch.chunk_count; i++) {
+		GArray *chunk = (GArray *) g_ptr_array_index (monitor->chunk_transitions, i);
+		g_array_append_vals (monitor->transitions, chunk->data, chunk->len);
+	}
+
+	g_free (batch.next);
+	g_free (batch.work);
+
+	*transitions = monitor->transitions;
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_asset_monitor_remove_asset (LocationAssetMonitor *monitor, guint asset_id)
+{
+	g_return_val_if_fail (monitor, LOCATION_ERROR_PARAMETER);
+
+	if (!g_hash_table_remove (monitor->assets, GUINT_TO_POINTER(asset_id))) return LOCATION_ERROR_PARAMETER;
+	return LOCATION_ERROR_NONE;
+}
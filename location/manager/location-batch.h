@@ -0,0 +1,72 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_BATCH_H_
+#define __LOCATION_BATCH_H_
+
+#include <location-types.h>
+#include <location-position.h>
+#include <location-accuracy.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @file location-batch.h
+ * @brief This file contains the definitions and structures related to the batches of positions.
+ */
+/**
+ * @addtogroup LocationAPI
+ * @{
+ * @defgroup LocationAPIBatch Location Batch
+ * @breif This provides APIs related to Location Batch
+ * @addtogroup LocationAPIBatch
+ * @{
+ */
+
+/**
+ * @brief The largest "batch-size" of an object, in positions.
+ */
+#define LOCATION_BATCH_SIZE_MAX		3600
+
+/**
+ * @brief The largest and the default "batch-latency" of an object, in seconds.
+ */
+#define LOCATION_BATCH_LATENCY_MAX	3600
+#define LOCATION_BATCH_LATENCY_DEFAULT	60
+
+/**
+ * @brief This represents the positions received since the previous batch, given by a "service-updated" signal of #BATCH_UPDATED type.
+ * It is owned by the object and valid only during the signal.
+ */
+struct _LocationBatch
+{
+	guint count;			///< Number of positions in the batch.
+	LocationPosition *positions;	///< Positions, oldest first.
+	LocationAccuracy *accuracies;	///< Accuracy of each position.
+};
+
+/**
+ * @} @}
+ */
+
+G_END_DECLS
+
+#endif
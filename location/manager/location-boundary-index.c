@@ -0,0 +1,630 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include "location-boundary-index.h"
+#include "location-polygon.h"
+#include "location-fence-set.h"
+#include "location-geodesic.h"
+#include "location-log.h"
+
+#define INDEX_ROWS	((guint) ceil (180.0 / LOCATION_BOUNDARY_INDEX_CELL_SIZE))
+#define INDEX_COLS	((guint) ceil (360.0 / LOCATION_BOUNDARY_INDEX_CELL_SIZE))
+
+/**
+ * Uniform latitude/longitude grid over the bounding box of each boundary.
+ * A cell keeps the boundaries whose bounding box overlaps it, so a position only needs the exact test
+ * against the boundaries of its own cell. Boundaries spanning more than LOCATION_BOUNDARY_INDEX_MAX_CELLS
+ * cells are kept aside in wide_list and are always candidates.
+ * Every boundary is registered by its fingerprint together with its link in the boundary list of the
+ * object, so duplicates are found and boundaries are unlinked in O(1).
+ * The index also keeps the zone state of each boundary: the set of boundaries containing the last
+ * position, and the set of boundaries added since then whose state is not known yet.
+ * In crossing mode, the path from the last position is tested as well, so a boundary passed through
+ * between two positions is reported as entered and left at once.
+ * The index does not own the boundaries. It owns the memory-mapped store attached to the object, if any,
+ * and the subscriptions of the object to shared fence sets.
+ */
+struct _LocationBoundaryIndex {
+	GHashTable *cells;	/* cell key -> GList of LocationBoundary */
+	GList *wide_list;
+	GHashTable *registry;	/* LocationBoundary -> its GList link */
+	GHashTable *inside;	/* set of LocationBoundary */
+	GHashTable *unknown;	/* set of LocationBoundary */
+	GHashTable *scan;	/* scratch set of LocationBoundary, empty between calls */
+	LocationBoundaryStore *store;
+	gboolean crossing;
+	GList *subscription_list;	/* LocationFenceSubscription */
+};
+
+typedef struct {
+	LocationPosition *position;
+	GHashTable *inside;
+} ZoneScan;
+
+typedef struct {
+	GHashTable *visited;	/* set of LocationBoundary */
+	GList *candidate_list;
+} PathScan;
+
+static gboolean
+_get_extent (const LocationBoundary *boundary, const LocationBoundaryBox **extent)
+{
+	if (boundary->type == LOCATION_BOUNDARY_NONE || !boundary->hash) return FALSE;
+
+	/* Bounding box computed when the boundary is created */
+	*extent = &boundary->bbox;
+	return TRUE;
+}
+
+static guint
+_get_row (gdouble latitude)
+{
+	guint row = (guint) floor ((latitude + 90) / LOCATION_BOUNDARY_INDEX_CELL_SIZE);
+	return MIN(row, INDEX_ROWS - 1);
+}
+
+static guint
+_get_col (gdouble longitude)
+{
+	guint col = (guint) floor ((longitude + 180) / LOCATION_BOUNDARY_INDEX_CELL_SIZE);
+	return MIN(col, INDEX_COLS - 1);
+}
+
+typedef void (*CellFunc) (LocationBoundaryIndex *index, guint key, gpointer user_data);
+
+static void
+_foreach_cell (LocationBoundaryIndex *index, const LocationBoundaryBox *extent, CellFunc func, gpointer user_data)
+{
+	guint row, col;
+	guint row_first = _get_row (extent->min_latitude);
+	guint row_last = _get_row (extent->max_latitude);
+	guint col_first = _get_col (extent->min_longitude);
+	guint col_last = _get_col (extent->max_longitude);
+
+	for (row = row_first; row <= row_last; row++) {
+		if (col_first <= col_last) {
+			for (col = col_first; col <= col_last; col++)
+				func (index, row * INDEX_COLS + col, user_data);
+		} else {
+			for (col = col_first; col < INDEX_COLS; col++)
+				func (index, row * INDEX_COLS + col, user_data);
+			for (col = 0; col <= col_last; col++)
+				func (index, row * INDEX_COLS + col, user_data);
+		}
+	}
+}
+
+static guint
+_count_cells (const LocationBoundaryBox *extent)
+{
+	guint rows = _get_row (extent->max_latitude) - _get_row (extent->min_latitude) + 1;
+	guint col_first = _get_col (extent->min_longitude);
+	guint col_last = _get_col (extent->max_longitude);
+	guint cols = 0;
+
+	if (col_first <= col_last) cols = col_last - col_first + 1;
+	else cols = INDEX_COLS - col_first + col_last + 1;
+
+	return rows * cols;
+}
+
+static void
+_cell_add (LocationBoundaryIndex *index, guint key, gpointer user_data)
+{
+	LocationBoundary *boundary = (LocationBoundary *) user_data;
+	GList *cell = g_hash_table_lookup (index->cells, GUINT_TO_POINTER(key));
+	cell = g_list_prepend (cell, boundary);
+	g_hash_table_insert (index->cells, GUINT_TO_POINTER(key), cell);
+}
+
+static void
+_cell_remove (LocationBoundaryIndex *index, guint key, gpointer user_data)
+{
+	LocationBoundary *boundary = (LocationBoundary *) user_data;
+	GList *cell = g_hash_table_lookup (index->cells, GUINT_TO_POINTER(key));
+	cell = g_list_remove (cell, boundary);
+	if (cell) g_hash_table_insert (index->cells, GUINT_TO_POINTER(key), cell);
+	else g_hash_table_remove (index->cells, GUINT_TO_POINTER(key));
+}
+
+static void
+_free_cell (gpointer key, gpointer value, gpointer user_data)
+{
+	g_list_free ((GList *) value);
+}
+
+LocationBoundaryIndex *
+boundary_index_new (void)
+{
+	LocationBoundaryIndex *index = g_slice_new0 (LocationBoundaryIndex);
+	index->cells = g_hash_table_new (g_direct_hash, g_direct_equal);
+	index->wide_list = NULL;
+	index->registry = g_hash_table_new ((GHashFunc) location_boundary_hash, (GEqualFunc) location_boundary_equal);
+	index->inside = g_hash_table_new (g_direct_hash, g_direct_equal);
+	index->unknown = g_hash_table_new (g_direct_hash, g_direct_equal);
+	index->scan = g_hash_table_new (g_direct_hash, g_direct_equal);
+	return index;
+}
+
+void
+boundary_index_free (LocationBoundaryIndex *index)
+{
+	g_return_if_fail (index);
+
+	g_hash_table_foreach (index->cells, _free_cell, NULL);
+	g_hash_table_destroy (index->cells);
+	g_list_free (index->wide_list);
+	g_hash_table_destroy (index->registry);
+	g_hash_table_destroy (index->inside);
+	g_hash_table_destroy (index->unknown);
+	g_hash_table_destroy (index->scan);
+	if (index->store) boundary_store_close (index->store);
+	g_list_free_full (index->subscription_list, (GDestroyNotify) fence_set_unsubscribe);
+	g_slice_free (LocationBoundaryIndex, index);
+}
+
+void
+boundary_index_add (LocationBoundaryIndex *index, GList *link)
+{
+	g_return_if_fail (index);
+	g_return_if_fail (link);
+	g_return_if_fail (link->data);
+
+	LocationBoundary *boundary = (LocationBoundary *) link->data;
+	const LocationBoundaryBox *extent = NULL;
+	if (!_get_extent (boundary, &extent)) {
+		LOCATION_LOGW("boundary type is undefined.[%d]", boundary->type);
+		return;
+	}
+
+	if (_count_cells (extent) > LOCATION_BOUNDARY_INDEX_MAX_CELLS) {
+		index->wide_list = g_list_prepend (index->wide_list, boundary);
+	} else {
+		_foreach_cell (index, extent, _cell_add, boundary);
+	}
+	g_hash_table_insert (index->registry, boundary, link);
+	g_hash_table_insert (index->unknown, boundary, boundary);
+}
+
+void
+boundary_index_remove (LocationBoundaryIndex *index, LocationBoundary *boundary)
+{
+	g_return_if_fail (index);
+	g_return_if_fail (boundary);
+
+	const LocationBoundaryBox *extent = NULL;
+	if (!_get_extent (boundary, &extent)) return;
+
+	if (_count_cells (extent) > LOCATION_BOUNDARY_INDEX_MAX_CELLS) {
+		index->wide_list = g_list_remove (index->wide_list, boundary);
+	} else {
+		_foreach_cell (index, extent, _cell_remove, boundary);
+	}
+	g_hash_table_remove (index->registry, boundary);
+	g_hash_table_remove (index->inside, boundary);
+	g_hash_table_remove (index->unknown, boundary);
+}
+
+guint
+boundary_index_size (const LocationBoundaryIndex *index)
+{
+	g_return_val_if_fail (index, 0);
+	return g_hash_table_size (index->registry);
+}
+
+GList *
+boundary_index_lookup (const LocationBoundaryIndex *index, const LocationBoundary *boundary)
+{
+	g_return_val_if_fail (index, NULL);
+	g_return_val_if_fail (boundary, NULL);
+
+	return (GList *) g_hash_table_lookup (index->registry, boundary);
+}
+
+gboolean
+boundary_index_foreach_candidate (const LocationBoundaryIndex *index,
+	const LocationPosition *position,
+	LocationBoundaryIndexFunc func,
+	gpointer user_data)
+{
+	g_return_val_if_fail (index, FALSE);
+	g_return_val_if_fail (position, FALSE);
+	g_return_val_if_fail (func, FALSE);
+
+	guint key = _get_row (position->latitude) * INDEX_COLS + _get_col (position->longitude);
+	GList *cur = g_hash_table_lookup (index->cells, GUINT_TO_POINTER(key));
+
+	for (; cur; cur = g_list_next (cur)) {
+		if (func ((LocationBoundary *) cur->data, user_data)) return TRUE;
+	}
+
+	for (cur = index->wide_list; cur; cur = g_list_next (cur)) {
+		if (func ((LocationBoundary *) cur->data, user_data)) return TRUE;
+	}
+
+	return FALSE;
+}
+
+static void
+_cell_collect (LocationBoundaryIndex *index, guint key, gpointer user_data)
+{
+	PathScan *scan = (PathScan *) user_data;
+	GList *cur = g_hash_table_lookup (index->cells, GUINT_TO_POINTER(key));
+
+	for (; cur; cur = g_list_next (cur)) {
+		if (g_hash_table_lookup (scan->visited, cur->data)) continue;
+		g_hash_table_insert (scan->visited, cur->data, cur->data);
+		scan->candidate_list = g_list_prepend (scan->candidate_list, cur->data);
+	}
+}
+
+/* Boundaries whose bounding box may meet the path between from and to */
+static GList *
+_get_path_candidates (LocationBoundaryIndex *index, const LocationPosition *from, const LocationPosition *to)
+{
+	PathScan scan = { NULL, NULL };
+	LocationBoundaryBox extent;
+	GList *cur = NULL;
+	gdouble span = to->longitude - from->longitude;
+
+	extent.min_latitude = MIN(from->latitude, to->latitude);
+	extent.max_latitude = MAX(from->latitude, to->latitude);
+	if ((span >= 0 && span <= 180) || span < -180) {
+		extent.min_longitude = from->longitude;
+		extent.max_longitude = to->longitude;
+	} else {
+		extent.min_longitude = to->longitude;
+		extent.max_longitude = from->longitude;
+	}
+
+	if (_count_cells (&extent) > LOCATION_BOUNDARY_INDEX_MAX_CELLS) {
+		GHashTableIter iter;
+		gpointer key = NULL;
+
+		g_hash_table_iter_init (&iter, index->registry);
+		while (g_hash_table_iter_next (&iter, &key, NULL)) {
+			scan.candidate_list = g_list_prepend (scan.candidate_list, key);
+		}
+		return scan.candidate_list;
+	}
+
+	scan.visited = g_hash_table_new (g_direct_hash, g_direct_equal);
+	_foreach_cell (index, &extent, _cell_collect, &scan);
+	for (cur = index->wide_list; cur; cur = g_list_next (cur)) {
+		scan.candidate_list = g_list_prepend (scan.candidate_list, cur->data);
+	}
+	g_hash_table_destroy (scan.visited);
+
+	return scan.candidate_list;
+}
+
+static gboolean
+_collect_inside (LocationBoundary *boundary, gpointer user_data)
+{
+	ZoneScan *scan = (ZoneScan *) user_data;
+
+	if (location_boundary_if_inside (boundary, scan->position)) {
+		g_hash_table_insert (scan->inside, boundary, boundary);
+	}
+	return FALSE;
+}
+
+gboolean
+boundary_index_update_zone (LocationBoundaryIndex *index,
+	const LocationPosition *last_position,
+	const LocationPosition *position,
+	GList **entered,
+	GList **left)
+{
+	g_return_val_if_fail (index, FALSE);
+	g_return_val_if_fail (position, FALSE);
+	g_return_val_if_fail (entered, FALSE);
+	g_return_val_if_fail (left, FALSE);
+
+	ZoneScan scan = { (LocationPosition *) position, index->scan };
+	GHashTableIter iter;
+	gpointer key = NULL;
+	GList *cur = NULL;
+	GList *crossed_list = NULL;
+	gboolean is_inside = FALSE;
+
+	*entered = NULL;
+	*left = NULL;
+
+	boundary_index_foreach_candidate (index, position, _collect_inside, &scan);
+
+	/* Boundaries outside at both positions but passed through in between */
+	if (index->crossing && last_position) {
+		GList *candidate_list = _get_path_candidates (index, last_position, position);
+		for (cur = candidate_list; cur; cur = g_list_next (cur)) {
+			if (g_hash_table_lookup (index->inside, cur->data) || g_hash_table_lookup (index->unknown, cur->data)) continue;
+			if (g_hash_table_lookup (scan.inside, cur->data)) continue;
+			if (location_boundary_if_crossed ((LocationBoundary *) cur->data, (LocationPosition *) last_position, (LocationPosition *) position)) {
+				crossed_list = g_list_prepend (crossed_list, cur->data);
+			}
+		}
+		g_list_free (candidate_list);
+	}
+
+	/* Boundaries that left the zone since the last position */
+	g_hash_table_iter_init (&iter, index->inside);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		if (!g_hash_table_lookup (scan.inside, key)) {
+			*left = g_list_prepend (*left, key);
+			g_hash_table_iter_remove (&iter);
+		}
+	}
+
+	g_hash_table_iter_init (&iter, scan.inside);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		g_hash_table_remove (index->unknown, key);
+		if (!g_hash_table_lookup (index->inside, key)) {
+			*entered = g_list_prepend (*entered, key);
+			g_hash_table_insert (index->inside, key, key);
+		}
+	}
+
+	/* Newly added boundaries not containing the position report their initial state once */
+	g_hash_table_iter_init (&iter, index->unknown);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		*left = g_list_prepend (*left, key);
+	}
+	g_hash_table_remove_all (index->unknown);
+
+	for (cur = crossed_list; cur; cur = g_list_next (cur)) {
+		*entered = g_list_prepend (*entered, cur->data);
+		*left = g_list_prepend (*left, cur->data);
+	}
+
+	g_list_free (crossed_list);
+	g_hash_table_remove_all (scan.inside);
+
+	is_inside = g_hash_table_size (index->inside) > 0;
+
+	/* Shared fence sets, evaluated once per position for all of their subscribers */
+	for (cur = index->subscription_list; cur; cur = g_list_next (cur)) {
+		if (fence_subscription_update_zone ((LocationFenceSubscription *) cur->data, position, entered, left)) is_inside = TRUE;
+	}
+
+	return is_inside;
+}
+
+void
+boundary_index_set_store (LocationBoundaryIndex *index, LocationBoundaryStore *store)
+{
+	g_return_if_fail (index);
+
+	if (index->store == store) return;
+	if (index->store) boundary_store_close (index->store);
+	index->store = store;
+}
+
+LocationBoundaryStore *
+boundary_index_get_store (const LocationBoundaryIndex *index)
+{
+	g_return_val_if_fail (index, NULL);
+	return index->store;
+}
+
+void
+boundary_index_set_crossing (LocationBoundaryIndex *index, gboolean crossing)
+{
+	g_return_if_fail (index);
+	index->crossing = crossing;
+}
+
+gboolean
+boundary_index_get_crossing (const LocationBoundaryIndex *index)
+{
+	g_return_val_if_fail (index, FALSE);
+	return index->crossing;
+}
+
+static gdouble
+_get_clearance (const LocationBoundary *boundary, const LocationPosition *position)
+{
+	gdouble clearance = 0.0;
+	GList *cur = NULL;
+	LocationPosition *prev = NULL;
+
+	switch (boundary->type) {
+		case LOCATION_BOUNDARY_CIRCLE:
+			return polygon_circle_distance (position->latitude, position->longitude,
+				boundary->circle.center->latitude, boundary->circle.center->longitude, boundary->circle.radius);
+		case LOCATION_BOUNDARY_RECT:
+			return fabs (polygon_box_distance (position->latitude, position->longitude,
+				boundary->bbox.min_latitude, boundary->bbox.max_latitude, boundary->bbox.min_longitude, boundary->bbox.max_longitude));
+		case LOCATION_BOUNDARY_POLYGON:
+			clearance = polygon_box_distance (position->latitude, position->longitude,
+				boundary->bbox.min_latitude, boundary->bbox.max_latitude, boundary->bbox.min_longitude, boundary->bbox.max_longitude);
+			if (clearance >= 0) return clearance;
+
+			clearance = G_MAXDOUBLE;
+			prev = (LocationPosition *) g_list_last (boundary->polygon.position_list)->data;
+			for (cur = boundary->polygon.position_list; cur; cur = g_list_next (cur)) {
+				LocationPosition *pos = (LocationPosition *) cur->data;
+				clearance = MIN(clearance, polygon_segment_distance (position->latitude, position->longitude,
+					prev->latitude, prev->longitude, pos->latitude, pos->longitude));
+				prev = pos;
+			}
+			return clearance;
+		default:
+			break;
+	}
+	return G_MAXDOUBLE;
+}
+
+gdouble
+boundary_index_foreach_ring (const LocationPosition *position, guint ring, LocationBoundaryCellFunc func, gpointer user_data)
+{
+	g_return_val_if_fail (position, G_MAXDOUBLE);
+	g_return_val_if_fail (func, G_MAXDOUBLE);
+
+	const gint rows = INDEX_ROWS, cols = INDEX_COLS;
+	gint row_center = _get_row (position->latitude);
+	gint col_center = _get_col (position->longitude);
+	gint size = ring, row, col, step;
+	gdouble south = (row_center - size) * LOCATION_BOUNDARY_INDEX_CELL_SIZE - 90;
+	gdouble north = (row_center + size + 1) * LOCATION_BOUNDARY_INDEX_CELL_SIZE - 90;
+	gdouble west = (col_center - size) * LOCATION_BOUNDARY_INDEX_CELL_SIZE - 180;
+	gdouble east = (col_center + size + 1) * LOCATION_BOUNDARY_INDEX_CELL_SIZE - 180;
+	gdouble gap_latitude = G_MAXDOUBLE, gap_longitude = G_MAXDOUBLE;
+
+	for (row = MAX(row_center - size, 0); row <= MIN(row_center + size, rows - 1); row++) {
+		/* The whole first and last rows of the ring, both ends of the rows between */
+		step = (row == row_center - size || row == row_center + size) ? 1 : 2 * size;
+		for (col = col_center - size; col <= col_center + size; col += step) {
+			func ((guint) (row * cols + (col % cols + cols) % cols), user_data);
+		}
+	}
+
+	if (row_center - size > 0) gap_latitude = MAX(position->latitude - south, 0);
+	if (row_center + size + 1 < rows) gap_latitude = MIN(gap_latitude, MAX(north - position->latitude, 0));
+	if (2 * size + 1 < cols) {
+		/* A degree of longitude is the shortest at the latitude of the rings nearest to a pole */
+		gdouble scale = cos (MIN(MAX(fabs (south), fabs (north)), 90) * M_PI / 180);
+		gap_longitude = MAX(MIN(position->longitude - west, east - position->longitude), 0) * scale;
+	}
+
+	if (gap_latitude == G_MAXDOUBLE && gap_longitude == G_MAXDOUBLE) return G_MAXDOUBLE;
+	return MIN(gap_latitude, gap_longitude) * GEODESIC_METERS_PER_DEGREE_MIN;
+}
+
+typedef struct {
+	LocationBoundaryIndex *index;
+	const LocationPosition *position;
+	gdouble clearance;
+	guint cells;
+} ClearanceScan;
+
+static void
+_visit_clearance (ClearanceScan *scan, LocationBoundary *boundary)
+{
+	if (g_hash_table_lookup (scan->index->scan, boundary)) return;
+	g_hash_table_insert (scan->index->scan, boundary, boundary);
+	scan->clearance = MIN(scan->clearance, _get_clearance (boundary, scan->position));
+}
+
+static void
+_cell_clearance (guint key, gpointer user_data)
+{
+	ClearanceScan *scan = (ClearanceScan *) user_data;
+	GList *cur = g_hash_table_lookup (scan->index->cells, GUINT_TO_POINTER(key));
+
+	scan->cells++;
+	for (; cur; cur = g_list_next (cur)) {
+		_visit_clearance (scan, (LocationBoundary *) cur->data);
+	}
+}
+
+gdouble
+boundary_index_get_clearance (LocationBoundaryIndex *index, const LocationPosition *position)
+{
+	g_return_val_if_fail (index, -1.0);
+	g_return_val_if_fail (position, -1.0);
+
+	ClearanceScan scan = { index, position, G_MAXDOUBLE, 0 };
+	GHashTableIter iter;
+	gpointer key = NULL;
+	GList *cur = NULL;
+	guint ring = 0;
+
+	if (!boundary_index_is_watching (index)) return -1.0;
+
+	for (cur = index->wide_list; cur; cur = g_list_next (cur)) {
+		_visit_clearance (&scan, (LocationBoundary *) cur->data);
+	}
+
+	/* Rings of cells outward until no boundary beyond them can be nearer than the nearest edge found.
+	 * Once the rings have cost more cells than there are boundaries, the rest are visited directly. */
+	if (g_hash_table_size (index->cells)) {
+		for (ring = 0; scan.clearance > boundary_index_foreach_ring (position, ring, _cell_clearance, &scan); ring++) {
+			if (scan.cells <= g_hash_table_size (index->registry)) continue;
+
+			g_hash_table_iter_init (&iter, index->registry);
+			while (g_hash_table_iter_next (&iter, &key, NULL)) {
+				_visit_clearance (&scan, (LocationBoundary *) key);
+			}
+			break;
+		}
+	}
+	g_hash_table_remove_all (index->scan);
+
+	if (index->store) scan.clearance = MIN(scan.clearance, boundary_store_get_clearance (index->store, position));
+	for (cur = index->subscription_list; cur; cur = g_list_next (cur)) {
+		scan.clearance = MIN(scan.clearance, fence_subscription_get_clearance ((LocationFenceSubscription *) cur->data, position));
+	}
+
+	return scan.clearance;
+}
+
+gboolean
+boundary_index_is_watching (const LocationBoundaryIndex *index)
+{
+	g_return_val_if_fail (index, FALSE);
+	return g_hash_table_size (index->registry) > 0 || index->store || index->subscription_list;
+}
+
+static GList *
+_find_subscription (const LocationBoundaryIndex *index, guint handle)
+{
+	GList *cur = NULL;
+
+	for (cur = index->subscription_list; cur; cur = g_list_next (cur)) {
+		if (fence_subscription_get_handle ((LocationFenceSubscription *) cur->data) == handle) return cur;
+	}
+	return NULL;
+}
+
+int
+boundary_index_subscribe (LocationBoundaryIndex *index, guint handle)
+{
+	g_return_val_if_fail (index, LOCATION_ERROR_PARAMETER);
+
+	int ret = LOCATION_ERROR_NONE;
+
+	fence_set_lock ();
+	LocationFenceSet *set = fence_set_lookup (handle);
+	if (!set) ret = LOCATION_ERROR_PARAMETER;
+	else if (!_find_subscription (index, handle))
+		index->subscription_list = g_list_prepend (index->subscription_list, fence_set_subscribe (set));
+	fence_set_unlock ();
+
+	return ret;
+}
+
+int
+boundary_index_unsubscribe (LocationBoundaryIndex *index, guint handle)
+{
+	g_return_val_if_fail (index, LOCATION_ERROR_PARAMETER);
+
+	GList *link = _find_subscription (index, handle);
+	if (!link) return LOCATION_ERROR_PARAMETER;
+
+	fence_set_unsubscribe ((LocationFenceSubscription *) link->data);
+	index->subscription_list = g_list_delete_link (index->subscription_list, link);
+	return LOCATION_ERROR_NONE;
+}
@@ -0,0 +1,85 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_BOUNDARY_INDEX_H__
+#define __LOCATION_BOUNDARY_INDEX_H__
+
+#include <location-boundary.h>
+#include <location-boundary-store.h>
+
+/**
+ * @file location-boundary-index.h
+ * @brief This file contains the spatial index over the boundaries registered on a LocationObject.
+ */
+
+G_BEGIN_DECLS
+
+#define LOCATION_BOUNDARY_INDEX_CELL_SIZE	0.1	/* degree */
+#define LOCATION_BOUNDARY_INDEX_MAX_CELLS	1024
+
+/* Return TRUE to stop the iteration */
+typedef gboolean (*LocationBoundaryIndexFunc) (LocationBoundary *boundary, gpointer user_data);
+
+typedef struct _LocationBoundaryIndex LocationBoundaryIndex;
+
+typedef void (*LocationBoundaryCellFunc) (guint key, gpointer user_data);
+
+LocationBoundaryIndex *boundary_index_new (void);
+void boundary_index_free (LocationBoundaryIndex *index);
+/* link is the element of the boundary list holding the boundary to add */
+void boundary_index_add (LocationBoundaryIndex *index, GList *link);
+void boundary_index_remove (LocationBoundaryIndex *index, LocationBoundary *boundary);
+guint boundary_index_size (const LocationBoundaryIndex *index);
+/* Returns the link of the registered boundary equal to boundary, or NULL */
+GList *boundary_index_lookup (const LocationBoundaryIndex *index, const LocationBoundary *boundary);
+gboolean boundary_index_foreach_candidate (const LocationBoundaryIndex *index, const LocationPosition *position, LocationBoundaryIndexFunc func, gpointer user_data);
+
+/* Updates the zone state of every boundary for a new position and returns TRUE if any boundary contains it.
+ * entered and left get the boundaries whose state changed; free the lists (not the boundaries) with g_list_free().
+ * In crossing mode, a boundary passed through between last_position and position is in both lists.
+ * last_position may be NULL. */
+gboolean boundary_index_update_zone (LocationBoundaryIndex *index, const LocationPosition *last_position, const LocationPosition *position, GList **entered, GList **left);
+void boundary_index_set_crossing (LocationBoundaryIndex *index, gboolean crossing);
+gboolean boundary_index_get_crossing (const LocationBoundaryIndex *index);
+
+/* Distance in meters from position to the nearest edge of the boundaries, store fences and fence sets, never more than
+ * the actual one. Negative if there is nothing to watch. */
+gdouble boundary_index_get_clearance (LocationBoundaryIndex *index, const LocationPosition *position);
+
+/* Calls func on the key of every grid cell ring cells away from the cell of position (the cell itself for 0), and
+ * returns the distance in meters that nothing outside rings 0 to ring can be nearer than, G_MAXDOUBLE once they
+ * cover the whole grid. Clearance searches grow the ring until it exceeds the nearest edge found. */
+gdouble boundary_index_foreach_ring (const LocationPosition *position, guint ring, LocationBoundaryCellFunc func, gpointer user_data);
+
+/* TRUE if there is any boundary, store or fence set to evaluate on a new position */
+gboolean boundary_index_is_watching (const LocationBoundaryIndex *index);
+
+/* Subscriptions to the shared fence sets, evaluated by boundary_index_update_zone() along with the own boundaries */
+int boundary_index_subscribe (LocationBoundaryIndex *index, guint handle);
+int boundary_index_unsubscribe (LocationBoundaryIndex *index, guint handle);
+
+/* The index takes the ownership of store, NULL detaches the current one */
+void boundary_index_set_store (LocationBoundaryIndex *index, LocationBoundaryStore *store);
+LocationBoundaryStore *boundary_index_get_store (const LocationBoundaryIndex *index);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,610 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+#include "location-boundary-store.h"
+#include "location-boundary-index.h"
+#include "location-polygon.h"
+#include "location-geodesic.h"
+#include "location-log.h"
+
+#define STORE_BYTE_ORDER	0x01020304
+
+/**
+ * File layout, in host byte order:
+ *   StoreHeader
+ *   StoreFence[fence_count]          fence id is the position in this table
+ *   gdouble[vertex_count * 2]        packed (latitude, longitude) pairs of the polygons
+ *   StoreCell[cell_count]            grid cells sorted by key, same grid as LocationBoundaryIndex
+ *   guint32[cell_ref_count]          fence ids of the cells
+ *   guint32[wide_count]              fence ids spanning too many cells, always candidates
+ */
+typedef struct {
+	gchar magic[8];
+	guint32 version;
+	guint32 byte_order;
+	guint32 fence_count;
+	guint32 vertex_count;
+	guint32 cell_count;
+	guint32 cell_ref_count;
+	guint32 wide_count;
+	guint32 reserved;
+	gdouble cell_size;
+	guint64 fence_offset;
+	guint64 vertex_offset;
+	guint64 cell_offset;
+	guint64 cell_ref_offset;
+	guint64 wide_offset;
+	guint64 file_size;
+} StoreHeader;
+
+typedef struct {
+	guint32 type;
+	guint32 vertex_count;
+	guint32 vertex_first;
+	guint32 reserved;
+	gdouble min_latitude;
+	gdouble max_latitude;
+	gdouble min_longitude;
+	gdouble max_longitude;
+	gdouble center_latitude;
+	gdouble center_longitude;
+	gdouble radius;
+} StoreFence;
+
+typedef struct {
+	guint32 key;
+	guint32 first;
+	guint32 count;
+} StoreCell;
+
+enum {
+	FENCE_STATE_OUT = 0,
+	FENCE_STATE_IN,
+	FENCE_STATE_IN_NOW,
+};
+
+struct _LocationBoundaryStore {
+	GMappedFile *file;
+	const StoreHeader *header;
+	const StoreFence *fences;
+	const gdouble *vertices;
+	const StoreCell *cells;
+	const guint32 *cell_refs;
+	const guint32 *wide;
+	guint cols;
+	guint rows;
+	guint8 *state;		/* FENCE_STATE_* per fence */
+	guint32 *visit;		/* last clearance pass per fence */
+	guint32 pass;
+	GArray *inside_ids;
+	GArray *now_ids;
+	GArray *entered;
+	GArray *left;
+};
+
+static guint
+_get_cols (gdouble cell_size)
+{
+	return (guint) ceil (360.0 / cell_size);
+}
+
+static guint
+_get_rows (gdouble cell_size)
+{
+	return (guint) ceil (180.0 / cell_size);
+}
+
+static guint
+_get_key (gdouble cell_size, gdouble latitude, gdouble longitude)
+{
+	guint row = MIN((guint) floor ((latitude + 90) / cell_size), _get_rows (cell_size) - 1);
+	guint col = MIN((guint) floor ((longitude + 180) / cell_size), _get_cols (cell_size) - 1);
+	return row * _get_cols (cell_size) + col;
+}
+
+static void
+_append_cell_ref (GHashTable *cells, guint key, guint32 id)
+{
+	GArray *refs = g_hash_table_lookup (cells, GUINT_TO_POINTER(key));
+	if (!refs) {
+		refs = g_array_new (FALSE, FALSE, sizeof (guint32));
+		g_hash_table_insert (cells, GUINT_TO_POINTER(key), refs);
+	}
+	g_array_append_val (refs, id);
+}
+
+static void
+_free_cell_refs (gpointer data)
+{
+	g_array_free ((GArray *) data, TRUE);
+}
+
+static gint
+_compare_key (gconstpointer a, gconstpointer b)
+{
+	guint key1 = *(const guint *) a;
+	guint key2 = *(const guint *) b;
+	return key1 < key2 ? -1 : (key1 > key2 ? 1 : 0);
+}
+
+/* Adds the fence to the cells overlapping its box, or returns FALSE if it spans too many of them */
+static gboolean
+_add_fence_cells (GHashTable *cells, const LocationBoundaryBox *box, guint32 id)
+{
+	gdouble cell_size = LOCATION_BOUNDARY_INDEX_CELL_SIZE;
+	guint cols = _get_cols (cell_size);
+	guint first = _get_key (cell_size, box->min_latitude, box->min_longitude);
+	guint last = _get_key (cell_size, box->max_latitude, box->max_longitude);
+	guint row, col;
+	guint row_first = first / cols, row_last = last / cols;
+	guint col_first = first % cols, col_last = last % cols;
+	guint col_count = col_first <= col_last ? col_last - col_first + 1 : cols - col_first + col_last + 1;
+
+	if ((row_last - row_first + 1) * col_count > LOCATION_BOUNDARY_INDEX_MAX_CELLS) return FALSE;
+
+	for (row = row_first; row <= row_last; row++) {
+		for (col = col_first; ; col = (col + 1) % cols) {
+			_append_cell_ref (cells, row * cols + col, id);
+			if (col == col_last) break;
+		}
+	}
+	return TRUE;
+}
+
+int
+boundary_store_write (const gchar *path, GList *boundary_list)
+{
+	g_return_val_if_fail (path, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (boundary_list, LOCATION_ERROR_PARAMETER);
+
+	GHashTable *cells = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, _free_cell_refs);
+	GArray *wide = g_array_new (FALSE, FALSE, sizeof (guint32));
+	GArray *keys = NULL;
+	GList *cur = NULL, *pos_cur = NULL;
+	StoreHeader *header = NULL;
+	StoreFence *fence = NULL;
+	StoreCell *cell = NULL;
+	gdouble *vertex = NULL;
+	guint32 *ref = NULL;
+	gchar *buffer = NULL;
+	guint32 fence_count = 0, vertex_count = 0, cell_ref_count = 0;
+	guint64 size = 0;
+	guint i;
+	GError *error = NULL;
+	int ret = LOCATION_ERROR_NONE;
+
+	for (cur = boundary_list; cur; cur = g_list_next (cur)) {
+		LocationBoundary *boundary = (LocationBoundary *) cur->data;
+		if (!boundary || !boundary->hash || boundary->type == LOCATION_BOUNDARY_NONE) {
+			LOCATION_LOGW("Boundary [%u] is not valid", fence_count);
+			ret = LOCATION_ERROR_PARAMETER;
+			goto out;
+		}
+		if (boundary->type == LOCATION_BOUNDARY_POLYGON)
+			vertex_count += g_list_length (boundary->polygon.position_list);
+		if (!_add_fence_cells (cells, &boundary->bbox, fence_count))
+			g_array_append_val (wide, fence_count);
+		fence_count++;
+	}
+
+	keys = g_array_sized_new (FALSE, FALSE, sizeof (guint), g_hash_table_size (cells));
+	{
+		GHashTableIter iter;
+		gpointer key = NULL, value = NULL;
+		g_hash_table_iter_init (&iter, cells);
+		while (g_hash_table_iter_next (&iter, &key, &value)) {
+			guint k = GPOINTER_TO_UINT(key);
+			g_array_append_val (keys, k);
+			cell_ref_count += ((GArray *) value)->len;
+		}
+	}
+	g_array_sort (keys, _compare_key);
+
+	size = sizeof (StoreHeader) + sizeof (StoreFence) * fence_count + sizeof (gdouble) * 2 * vertex_count
+		+ sizeof (StoreCell) * keys->len + sizeof (guint32) * (cell_ref_count + wide->len);
+	buffer = g_malloc0 (size);
+
+	header = (StoreHeader *) buffer;
+	memcpy (header->magic, LOCATION_BOUNDARY_STORE_MAGIC, sizeof (header->magic));
+	header->version = LOCATION_BOUNDARY_STORE_VERSION;
+	header->byte_order = STORE_BYTE_ORDER;
+	header->fence_count = fence_count;
+	header->vertex_count = vertex_count;
+	header->cell_count = keys->len;
+	header->cell_ref_count = cell_ref_count;
+	header->wide_count = wide->len;
+	header->cell_size = LOCATION_BOUNDARY_INDEX_CELL_SIZE;
+	header->fence_offset = sizeof (StoreHeader);
+	header->vertex_offset = header->fence_offset + sizeof (StoreFence) * fence_count;
+	header->cell_offset = header->vertex_offset + sizeof (gdouble) * 2 * vertex_count;
+	header->cell_ref_offset = header->cell_offset + sizeof (StoreCell) * keys->len;
+	header->wide_offset = header->cell_ref_offset + sizeof (guint32) * cell_ref_count;
+	header->file_size = size;
+
+	fence = (StoreFence *) (buffer + header->fence_offset);
+	vertex = (gdouble *) (buffer + header->vertex_offset);
+	for (cur = boundary_list; cur; cur = g_list_next (cur), fence++) {
+		LocationBoundary *boundary = (LocationBoundary *) cur->data;
+
+		fence->type = boundary->type;
+		fence->min_latitude = boundary->bbox.min_latitude;
+		fence->max_latitude = boundary->bbox.max_latitude;
+		fence->min_longitude = boundary->bbox.min_longitude;
+		fence->max_longitude = boundary->bbox.max_longitude;
+		fence->center_latitude = boundary->center_latitude;
+		fence->center_longitude = boundary->center_longitude;
+
+		if (boundary->type == LOCATION_BOUNDARY_CIRCLE) {
+			fence->radius = boundary->circle.radius;
+		} else if (boundary->type == LOCATION_BOUNDARY_POLYGON) {
+			fence->vertex_first = (vertex - (gdouble *) (buffer + header->vertex_offset)) / 2;
+			for (pos_cur = boundary->polygon.position_list; pos_cur; pos_cur = g_list_next (pos_cur)) {
+				LocationPosition *pos = (LocationPosition *) pos_cur->data;
+				*vertex++ = pos->latitude;
+				*vertex++ = pos->longitude;
+				fence->vertex_count++;
+			}
+		}
+	}
+
+	cell = (StoreCell *) (buffer + header->cell_offset);
+	ref = (guint32 *) (buffer + header->cell_ref_offset);
+	for (i = 0; i < keys->len; i++, cell++) {
+		guint key = g_array_index (keys, guint, i);
+		GArray *refs = g_hash_table_lookup (cells, GUINT_TO_POINTER(key));
+
+		cell->key = key;
+		cell->first = ref - (guint32 *) (buffer + header->cell_ref_offset);
+		cell->count = refs->len;
+		memcpy (ref, refs->data, sizeof (guint32) * refs->len);
+		ref += refs->len;
+	}
+	memcpy (buffer + header->wide_offset, wide->data, sizeof (guint32) * wide->len);
+
+	if (!g_file_set_contents (path, buffer, size, &error)) {
+		LOCATION_LOGW("Fail to write [%s]: %s", path, error->message);
+		g_error_free (error);
+		ret = LOCATION_ERROR_UNKNOWN;
+	} else {
+		LOCATION_LOGD("Boundary store [%s]: fences [%u], vertices [%u], cells [%u]", path, fence_count, vertex_count, keys->len);
+	}
+
+out:
+	g_free (buffer);
+	if (keys) g_array_free (keys, TRUE);
+	g_array_free (wide, TRUE);
+	g_hash_table_destroy (cells);
+	return ret;
+}
+
+static gboolean
+_check_section (const StoreHeader *header, guint64 offset, guint64 count, gsize item_size)
+{
+	if (offset % sizeof (guint32)) return FALSE;
+	if (count > (header->file_size - MIN(offset, header->file_size)) / item_size) return FALSE;
+	return offset <= header->file_size;
+}
+
+static gboolean
+_check_store (const LocationBoundaryStore *store, gsize length)
+{
+	const StoreHeader *header = store->header;
+	guint i;
+
+	if (length < sizeof (StoreHeader)) return FALSE;
+	if (memcmp (header->magic, LOCATION_BOUNDARY_STORE_MAGIC, sizeof (header->magic))) return FALSE;
+	if (header->version != LOCATION_BOUNDARY_STORE_VERSION || header->byte_order != STORE_BYTE_ORDER) return FALSE;
+	/* The grid must match the one the store was built with, so cell keys stay in range */
+	if (header->file_size != length || header->cell_size != LOCATION_BOUNDARY_INDEX_CELL_SIZE) return FALSE;
+	if (header->fence_offset % sizeof (gdouble) || header->vertex_offset % sizeof (gdouble)) return FALSE;
+
+	if (!_check_section (header, header->fence_offset, header->fence_count, sizeof (StoreFence)) ||
+		!_check_section (header, header->vertex_offset, header->vertex_count, sizeof (gdouble) * 2) ||
+		!_check_section (header, header->cell_offset, header->cell_count, sizeof (StoreCell)) ||
+		!_check_section (header, header->cell_ref_offset, header->cell_ref_count, sizeof (guint32)) ||
+		!_check_section (header, header->wide_offset, header->wide_count, sizeof (guint32)))
+		return FALSE;
+
+	for (i = 0; i < header->fence_count; i++) {
+		const StoreFence *fence = &store->fences[i];
+		if (fence->type == LOCATION_BOUNDARY_POLYGON &&
+			(fence->vertex_count < 3 || fence->vertex_count > header->vertex_count ||
+			 fence->vertex_first > header->vertex_count - fence->vertex_count))
+			return FALSE;
+	}
+	for (i = 0; i < header->cell_count; i++) {
+		if (store->cells[i].count > header->cell_ref_count ||
+			store->cells[i].first > header->cell_ref_count - store->cells[i].count) return FALSE;
+	}
+	for (i = 0; i < header->cell_ref_count; i++) {
+		if (store->cell_refs[i] >= header->fence_count) return FALSE;
+	}
+	for (i = 0; i < header->wide_count; i++) {
+		if (store->wide[i] >= header->fence_count) return FALSE;
+	}
+	return TRUE;
+}
+
+LocationBoundaryStore *
+boundary_store_open (const gchar *path)
+{
+	g_return_val_if_fail (path, NULL);
+
+	GError *error = NULL;
+	GMappedFile *file = g_mapped_file_new (path, FALSE, &error);
+	const gchar *contents = NULL;
+	LocationBoundaryStore *store = NULL;
+
+	if (!file) {
+		LOCATION_LOGW("Fail to map [%s]: %s", path, error->message);
+		g_error_free (error);
+		return NULL;
+	}
+
+	contents = g_mapped_file_get_contents (file);
+	store = g_slice_new0 (LocationBoundaryStore);
+	store->file = file;
+	store->header = (const StoreHeader *) contents;
+
+	if (g_mapped_file_get_length (file) >= sizeof (StoreHeader)) {
+		store->fences = (const StoreFence *) (contents + store->header->fence_offset);
+		store->vertices = (const gdouble *) (contents + store->header->vertex_offset);
+		store->cells = (const StoreCell *) (contents + store->header->cell_offset);
+		store->cell_refs = (const guint32 *) (contents + store->header->cell_ref_offset);
+		store->wide = (const guint32 *) (contents + store->header->wide_offset);
+	}
+
+	if (!_check_store (store, g_mapped_file_get_length (file))) {
+		LOCATION_LOGW("[%s] is not a valid boundary store", path);
+		g_mapped_file_unref (file);
+		g_slice_free (LocationBoundaryStore, store);
+		return NULL;
+	}
+
+	store->cols = _get_cols (store->header->cell_size);
+	store->rows = _get_rows (store->header->cell_size);
+	store->state = g_malloc0 (MAX(store->header->fence_count, 1));
+	store->visit = g_new0 (guint32, MAX(store->header->fence_count, 1));
+	store->inside_ids = g_array_new (FALSE, FALSE, sizeof (guint32));
+	store->now_ids = g_array_new (FALSE, FALSE, sizeof (guint32));
+	store->entered = g_array_new (FALSE, FALSE, sizeof (guint32));
+	store->left = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+	LOCATION_LOGD("Boundary store [%s] is attached: fences [%u]", path, store->header->fence_count);
+	return store;
+}
+
+void
+boundary_store_close (LocationBoundaryStore *store)
+{
+	g_return_if_fail (store);
+
+	g_array_free (store->inside_ids, TRUE);
+	g_array_free (store->now_ids, TRUE);
+	g_array_free (store->entered, TRUE);
+	g_array_free (store->left, TRUE);
+	g_free (store->state);
+	g_free (store->visit);
+	g_mapped_file_unref (store->file);
+	g_slice_free (LocationBoundaryStore, store);
+}
+
+guint
+boundary_store_size (const LocationBoundaryStore *store)
+{
+	g_return_val_if_fail (store, 0);
+	return store->header->fence_count;
+}
+
+static gboolean
+_fence_contains (const LocationBoundaryStore *store, const StoreFence *fence, const LocationPosition *position)
+{
+	gdouble y = position->latitude;
+	gdouble x = position->longitude;
+
+	if (y < fence->min_latitude || y > fence->max_latitude) return FALSE;
+	if (fence->min_longitude <= fence->max_longitude) {
+		if (x < fence->min_longitude || x > fence->max_longitude) return FALSE;
+	} else if (x < fence->min_longitude && x > fence->max_longitude) {
+		return FALSE;
+	}
+
+	switch (fence->type) {
+		case LOCATION_BOUNDARY_RECT: {
+			/* Same test as location_boundary_if_inside(), the box is the rectangle itself */
+			gdouble lt_y = fence->max_latitude, lt_x = fence->min_longitude;
+			gdouble rb_y = fence->min_latitude, rb_x = fence->max_longitude;
+
+			if (lt_x - rb_x < 180 && lt_x - rb_x > -180)
+				return (rb_y < y && y < lt_y) && (lt_x < x && x < rb_x);
+			return (rb_y < y && y < lt_y) && (lt_x < x || x < rb_x);
+		}
+		case LOCATION_BOUNDARY_CIRCLE:
+			return geodesic_within_radius (fence->center_latitude, fence->center_longitude, y, x, fence->radius);
+		case LOCATION_BOUNDARY_POLYGON:
+			return polygon_vertices_count_crossing (store->vertices + (gsize) fence->vertex_first * 2, fence->vertex_count, y, x) & 1;
+		default:
+			return FALSE;
+	}
+}
+
+static void
+_check_fence (LocationBoundaryStore *store, guint32 id, const LocationPosition *position)
+{
+	if (store->state[id] == FENCE_STATE_IN_NOW) return;
+	if (!_fence_contains (store, &store->fences[id], position)) return;
+
+	if (store->state[id] == FENCE_STATE_OUT) g_array_append_val (store->entered, id);
+	store->state[id] = FENCE_STATE_IN_NOW;
+	g_array_append_val (store->now_ids, id);
+}
+
+static const StoreCell *
+_find_cell (const LocationBoundaryStore *store, guint key)
+{
+	guint low = 0, high = store->header->cell_count;
+
+	while (low < high) {
+		guint mid = low + (high - low) / 2;
+		if (store->cells[mid].key < key) low = mid + 1;
+		else high = mid;
+	}
+	if (low < store->header->cell_count && store->cells[low].key == key) return &store->cells[low];
+	return NULL;
+}
+
+gboolean
+boundary_store_update_zone (LocationBoundaryStore *store,
+	const LocationPosition *position,
+	GArray **entered,
+	GArray **left)
+{
+	g_return_val_if_fail (store, FALSE);
+	g_return_val_if_fail (position, FALSE);
+	g_return_val_if_fail (entered, FALSE);
+	g_return_val_if_fail (left, FALSE);
+
+	const StoreCell *cell = _find_cell (store, _get_key (store->header->cell_size, position->latitude, position->longitude));
+	GArray *swap = NULL;
+	guint i;
+
+	g_array_set_size (store->entered, 0);
+	g_array_set_size (store->left, 0);
+	g_array_set_size (store->now_ids, 0);
+
+	if (cell) {
+		for (i = 0; i < cell->count; i++)
+			_check_fence (store, store->cell_refs[cell->first + i], position);
+	}
+	for (i = 0; i < store->header->wide_count; i++)
+		_check_fence (store, store->wide[i], position);
+
+	/* Fences still marked IN were not found this time */
+	for (i = 0; i < store->inside_ids->len; i++) {
+		guint32 id = g_array_index (store->inside_ids, guint32, i);
+		if (store->state[id] == FENCE_STATE_IN) {
+			store->state[id] = FENCE_STATE_OUT;
+			g_array_append_val (store->left, id);
+		}
+	}
+	for (i = 0; i < store->now_ids->len; i++)
+		store->state[g_array_index (store->now_ids, guint32, i)] = FENCE_STATE_IN;
+
+	swap = store->inside_ids;
+	store->inside_ids = store->now_ids;
+	store->now_ids = swap;
+
+	*entered = store->entered;
+	*left = store->left;
+	return store->inside_ids->len > 0;
+}
+
+static gdouble
+_get_fence_clearance (const LocationBoundaryStore *store, const StoreFence *fence, const LocationPosition *position)
+{
+	gdouble gap = 0.0;
+
+	switch (fence->type) {
+		case LOCATION_BOUNDARY_CIRCLE:
+			return polygon_circle_distance (position->latitude, position->longitude,
+				fence->center_latitude, fence->center_longitude, fence->radius);
+		case LOCATION_BOUNDARY_RECT:
+			return fabs (polygon_box_distance (position->latitude, position->longitude,
+				fence->min_latitude, fence->max_latitude, fence->min_longitude, fence->max_longitude));
+		case LOCATION_BOUNDARY_POLYGON:
+			gap = polygon_box_distance (position->latitude, position->longitude,
+				fence->min_latitude, fence->max_latitude, fence->min_longitude, fence->max_longitude);
+			if (gap >= 0) return gap;
+			return polygon_vertices_distance (store->vertices + (gsize) fence->vertex_first * 2, fence->vertex_count,
+				position->latitude, position->longitude);
+		default:
+			break;
+	}
+	return G_MAXDOUBLE;
+}
+
+typedef struct {
+	LocationBoundaryStore *store;
+	const LocationPosition *position;
+	gdouble clearance;
+	guint cells;
+} StoreScan;
+
+static void
+_visit_fence (StoreScan *scan, guint32 id)
+{
+	LocationBoundaryStore *store = scan->store;
+
+	if (store->visit[id] == store->pass) return;
+	store->visit[id] = store->pass;
+	scan->clearance = MIN(scan->clearance, _get_fence_clearance (store, &store->fences[id], scan->position));
+}
+
+static void
+_cell_clearance (guint key, gpointer user_data)
+{
+	StoreScan *scan = (StoreScan *) user_data;
+	const StoreCell *cell = _find_cell (scan->store, key);
+	guint i;
+
+	scan->cells++;
+	if (!cell) return;
+	for (i = 0; i < cell->count; i++)
+		_visit_fence (scan, scan->store->cell_refs[cell->first + i]);
+}
+
+gdouble
+boundary_store_get_clearance (LocationBoundaryStore *store, const LocationPosition *position)
+{
+	g_return_val_if_fail (store, G_MAXDOUBLE);
+	g_return_val_if_fail (position, G_MAXDOUBLE);
+
+	StoreScan scan = { store, position, G_MAXDOUBLE, 0 };
+	guint32 id;
+	guint i, ring;
+
+	/* A new stamp marks the fences visited by this pass, the stamps are cleared when it wraps around */
+	if (++store->pass == 0) {
+		memset (store->visit, 0, sizeof (guint32) * MAX(store->header->fence_count, 1));
+		store->pass = 1;
+	}
+
+	for (i = 0; i < store->header->wide_count; i++)
+		_visit_fence (&scan, store->wide[i]);
+
+	/* Same outward search as the index, on the same grid */
+	if (store->header->cell_count) {
+		for (ring = 0; scan.clearance > boundary_index_foreach_ring (position, ring, _cell_clearance, &scan); ring++) {
+			if (scan.cells <= store->header->fence_count) continue;
+
+			for (id = 0; id < store->header->fence_count; id++)
+				_visit_fence (&scan, id);
+			break;
+		}
+	}
+	return scan.clearance;
+}
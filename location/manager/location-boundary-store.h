@@ -0,0 +1,53 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_BOUNDARY_STORE_H__
+#define __LOCATION_BOUNDARY_STORE_H__
+
+#include <location-boundary.h>
+
+/**
+ * @file location-boundary-store.h
+ * @brief This file contains the memory-mapped geofence store, evaluated in place by position_signaling().
+ */
+
+G_BEGIN_DECLS
+
+#define LOCATION_BOUNDARY_STORE_MAGIC		"LOCFENCE"
+#define LOCATION_BOUNDARY_STORE_VERSION	1
+
+typedef struct _LocationBoundaryStore LocationBoundaryStore;
+
+int boundary_store_write (const gchar *path, GList *boundary_list);
+LocationBoundaryStore *boundary_store_open (const gchar *path);
+void boundary_store_close (LocationBoundaryStore *store);
+guint boundary_store_size (const LocationBoundaryStore *store);
+
+/* Updates the zone state of the fences for a new position and returns TRUE if any fence contains it.
+ * entered and left get arrays of guint32 fence ids owned by the store, valid until the next update. */
+gboolean boundary_store_update_zone (LocationBoundaryStore *store, const LocationPosition *position, GArray **entered, GArray **left);
+
+/* Distance in meters from position to the nearest fence edge, never more than the actual one. G_MAXDOUBLE without fences. */
+gdouble boundary_store_get_clearance (LocationBoundaryStore *store, const LocationPosition *position);
+
+G_END_DECLS
+
+#endif
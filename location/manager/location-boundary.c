@@ -57,8 +57,17 @@
 #include <math.h>
 #include <string.h>
 #include "location-boundary.h"
+#include "location-polygon.h"
+#include "location-geodesic.h"
+#include "location-boundary-store.h"
+#include "location-fence-set.h"
 #include "location-log.h"
 
+#define		DEG2RAD(x)	((x) * M_PI / 180)
+
+/* The shortest arc of a degree of latitude on WGS-84 (meters), used to keep the circle box conservative. */
+#define METERS_PER_DEGREE_MIN	110574.0
+
 GType
 location_boundary_get_type (void)
 {
@@ -93,6 +102,290 @@ static void _free_polygon_position(gpointer data)
 	location_position_free(position);
 }
 
+static guint _hash_double(gdouble value)
+{
+	guint64 bits = 0;
+
+	if (value == 0) value = 0;	/* -0.0 and 0.0 are equal */
+	memcpy(&bits, &value, sizeof(bits));
+	bits ^= bits >> 33;
+	bits *= G_GUINT64_CONSTANT(0xff51afd7ed558ccd);
+	bits ^= bits >> 33;
+	return (guint) bits;
+}
+
+static guint _hash_position(const LocationPosition *position)
+{
+	return _hash_double(position->latitude) ^
+		(_hash_double(position->longitude) * 0x9e3779b1U) ^
+		(_hash_double(position->altitude) * 0x85ebca6bU);
+}
+
+static guint _compute_boundary_hash(const LocationBoundary *boundary)
+{
+	guint hash = boundary->type * 0xc2b2ae35U;
+	GList *cur = NULL;
+
+	if (boundary->type == LOCATION_BOUNDARY_RECT) {
+		hash ^= _hash_position(boundary->rect.left_top);
+		hash ^= _hash_position(boundary->rect.right_bottom) * 0x27d4eb2dU;
+	} else if (boundary->type == LOCATION_BOUNDARY_CIRCLE) {
+		hash ^= _hash_position(boundary->circle.center);
+		hash ^= _hash_double(boundary->circle.radius) * 0x27d4eb2dU;
+	} else if (boundary->type == LOCATION_BOUNDARY_POLYGON) {
+		/* Order independent, since a rotated or reversed vertex list is the same polygon */
+		for (cur = boundary->polygon.position_list; cur; cur = g_list_next(cur)) {
+			hash += _hash_position((LocationPosition *) cur->data);
+		}
+	}
+
+	return hash ? hash : 1;	/* 0 is kept for "not computed" */
+}
+
+static void _get_circle_box(const LocationBoundary *boundary, LocationBoundaryBox *box)
+{
+	gdouble lat = boundary->circle.center->latitude;
+	gdouble lon = boundary->circle.center->longitude;
+	gdouble delta_lat = boundary->circle.radius / METERS_PER_DEGREE_MIN;
+	gdouble delta_lon = 0.0;
+
+	box->min_latitude = lat - delta_lat;
+	box->max_latitude = lat + delta_lat;
+
+	if (box->min_latitude <= -90 || box->max_latitude >= 90) {
+		/* The circle covers a pole */
+		box->min_latitude = MAX(box->min_latitude, -90.0);
+		box->max_latitude = MIN(box->max_latitude, 90.0);
+		box->min_longitude = -180;
+		box->max_longitude = 180;
+		return;
+	}
+
+	delta_lon = delta_lat / cos(DEG2RAD(MAX(fabs(box->min_latitude), fabs(box->max_latitude))));
+	if (delta_lon >= 180) {
+		box->min_longitude = -180;
+		box->max_longitude = 180;
+		return;
+	}
+
+	box->min_longitude = lon - delta_lon;
+	box->max_longitude = lon + delta_lon;
+	if (box->min_longitude < -180) box->min_longitude += 360;
+	if (box->max_longitude > 180) box->max_longitude -= 360;
+}
+
+static void _get_polygon_box(const LocationBoundary *boundary, LocationBoundaryBox *box)
+{
+	GList *position_list = boundary->polygon.position_list;
+	GList *cur = NULL;
+	LocationPosition *pos = NULL;
+	LocationPosition *prev = (LocationPosition *) g_list_last(position_list)->data;
+	gdouble lon = 0.0, sum_lat = 0.0;
+	gdouble min_lon = 360, max_lon = -360, min_shifted = 360, max_shifted = -360;
+	int crossing = 0;
+	int count = 0;
+
+	box->min_latitude = 90;
+	box->max_latitude = -90;
+
+	for (cur = position_list; cur; cur = g_list_next(cur)) {
+		pos = (LocationPosition *) cur->data;
+
+		box->min_latitude = MIN(box->min_latitude, pos->latitude);
+		box->max_latitude = MAX(box->max_latitude, pos->latitude);
+		sum_lat += pos->latitude;
+		count++;
+
+		min_lon = MIN(min_lon, pos->longitude);
+		max_lon = MAX(max_lon, pos->longitude);
+
+		lon = pos->longitude < 0 ? pos->longitude + 360 : pos->longitude;
+		min_shifted = MIN(min_shifted, lon);
+		max_shifted = MAX(max_shifted, lon);
+
+		/* Same rule as location_boundary_if_inside() for the edges near 180th meridian */
+		if (fabs(pos->longitude - prev->longitude) > 180) crossing++;
+		prev = pos;
+	}
+
+	if (crossing == 0) {
+		box->min_longitude = min_lon;
+		box->max_longitude = max_lon;
+	} else if (crossing % 2 == 0) {
+		box->min_longitude = min_shifted > 180 ? min_shifted - 360 : min_shifted;
+		box->max_longitude = max_shifted > 180 ? max_shifted - 360 : max_shifted;
+	} else {
+		/* The polygon surrounds a pole */
+		box->min_longitude = -180;
+		box->max_longitude = 180;
+		if (sum_lat / count > 0) box->max_latitude = 90;
+		else box->min_latitude = -90;
+	}
+}
+
+static void _get_polygon_centroid(const LocationBoundary *boundary, gdouble *latitude, gdouble *longitude)
+{
+	GList *cur = NULL;
+	LocationPosition *first = (LocationPosition *) boundary->polygon.position_list->data;
+	gdouble x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0, cross = 0.0;
+	gdouble area = 0.0, sum_x = 0.0, sum_y = 0.0, mean_x = 0.0, mean_y = 0.0;
+	int count = 0;
+
+	/* Longitudes are unwrapped along the edges and taken relative to the first vertex */
+	for (cur = boundary->polygon.position_list; cur; cur = g_list_next(cur)) {
+		LocationPosition *pos = (LocationPosition *) cur->data;
+		LocationPosition *next = (LocationPosition *) (cur->next ? cur->next->data : first);
+		gdouble interval = next->longitude - pos->longitude;
+
+		if (interval > 180) interval -= 360;
+		else if (interval < -180) interval += 360;
+
+		x1 = x0 + interval;
+		y1 = next->latitude - first->latitude;
+		cross = x0 * y1 - x1 * y0;
+		area += cross;
+		sum_x += (x0 + x1) * cross;
+		sum_y += (y0 + y1) * cross;
+		mean_x += x0;
+		mean_y += y0;
+		count++;
+
+		x0 = x1;
+		y0 = y1;
+	}
+
+	if (fabs(area) > 1e-12) {
+		mean_x = sum_x / (3 * area);
+		mean_y = sum_y / (3 * area);
+	} else {
+		/* Degenerated polygon */
+		mean_x /= count;
+		mean_y /= count;
+	}
+
+	*latitude = first->latitude + mean_y;
+	*longitude = first->longitude + mean_x;
+	if (*longitude > 180) *longitude -= 360;
+	else if (*longitude <= -180) *longitude += 360;
+}
+
+static gboolean _get_boundary_box(const LocationBoundary *boundary, LocationBoundaryBox *box)
+{
+	switch (boundary->type) {
+		case LOCATION_BOUNDARY_RECT:
+			box->min_latitude = boundary->rect.right_bottom->latitude;
+			box->max_latitude = boundary->rect.left_top->latitude;
+			box->min_longitude = boundary->rect.left_top->longitude;
+			box->max_longitude = boundary->rect.right_bottom->longitude;
+			break;
+		case LOCATION_BOUNDARY_CIRCLE:
+			_get_circle_box(boundary, box);
+			break;
+		case LOCATION_BOUNDARY_POLYGON:
+			_get_polygon_box(boundary, box);
+			break;
+		default:
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean _get_boundary_center(const LocationBoundary *boundary, gdouble *latitude, gdouble *longitude)
+{
+	switch (boundary->type) {
+		case LOCATION_BOUNDARY_RECT: {
+			gdouble lt_x = boundary->rect.left_top->longitude;
+			gdouble rb_x = boundary->rect.right_bottom->longitude;
+
+			*latitude = (boundary->rect.left_top->latitude + boundary->rect.right_bottom->latitude) / 2;
+			if (lt_x - rb_x < 180 && lt_x - rb_x > -180) {
+				*longitude = (lt_x + rb_x) / 2;
+			} else {
+				*longitude = (lt_x + rb_x + 360) / 2;
+				if (*longitude > 180) *longitude -= 360;
+			}
+			break;
+		}
+		case LOCATION_BOUNDARY_CIRCLE:
+			*latitude = boundary->circle.center->latitude;
+			*longitude = boundary->circle.center->longitude;
+			break;
+		case LOCATION_BOUNDARY_POLYGON:
+			_get_polygon_centroid(boundary, latitude, longitude);
+			break;
+		default:
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean _box_contains(const LocationBoundaryBox *box, gdouble latitude, gdouble longitude)
+{
+	if (latitude < box->min_latitude || latitude > box->max_latitude) return FALSE;
+	if (box->min_longitude <= box->max_longitude)
+		return box->min_longitude <= longitude && longitude <= box->max_longitude;
+	return box->min_longitude <= longitude || longitude <= box->max_longitude;
+}
+
+/* Fills the data computed once at creation */
+static void _set_boundary_cache(LocationBoundary *boundary)
+{
+	_get_boundary_box(boundary, &boundary->bbox);
+	_get_boundary_center(boundary, &boundary->center_latitude, &boundary->center_longitude);
+	boundary->hash = _compute_boundary_hash(boundary);
+}
+
+static gboolean _polygon_equal(const LocationBoundary *boundary1, const LocationBoundary *boundary2)
+{
+	GList *boundary1_next = NULL;
+	GList *boundary2_start = NULL, *boundary2_prev = NULL, *boundary2_next = NULL;
+	LocationPosition *first = NULL;
+
+	if (g_list_length(boundary1->polygon.position_list) != g_list_length(boundary2->polygon.position_list)) {
+		return FALSE;
+	}
+
+	// Find a matching index of Boundary2 with Boundary1's 1st postion.
+	first = (LocationPosition *) g_list_nth_data(boundary1->polygon.position_list, 0);
+	for (boundary2_start = boundary2->polygon.position_list; boundary2_start; boundary2_start = g_list_next(boundary2_start)) {
+		if (location_position_equal(first, (LocationPosition *) boundary2_start->data)) break;
+	}
+	if (boundary2_start == NULL) return FALSE;
+
+	boundary2_prev = g_list_previous(boundary2_start);
+	boundary2_next = g_list_next(boundary2_start);
+	if (boundary2_prev == NULL) boundary2_prev = g_list_last(boundary2->polygon.position_list);
+	if (boundary2_next == NULL) boundary2_next = g_list_first(boundary2->polygon.position_list);
+
+	boundary1_next = g_list_next(boundary1->polygon.position_list);
+	if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*)boundary2_prev->data) == TRUE){
+		boundary1_next = g_list_next(boundary1_next);
+		while (boundary1_next) {
+			boundary2_prev = g_list_previous(boundary2_prev);
+			if (boundary2_prev == NULL) boundary2_prev = g_list_last(boundary2->polygon.position_list);
+			if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*) boundary2_prev->data) == FALSE){
+				return FALSE;
+			}
+			boundary1_next = g_list_next(boundary1_next);
+		}
+		return TRUE;
+	}
+	else if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*)boundary2_next->data) == TRUE) {
+		boundary1_next = g_list_next(boundary1_next);
+		while(boundary1_next) {
+			boundary2_next = g_list_next(boundary2_next);
+			if (boundary2_next == NULL) boundary2_next = g_list_first(boundary2->polygon.position_list);
+			if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*) boundary2_next->data) == FALSE){
+				return FALSE;
+			}
+			boundary1_next = g_list_next(boundary1_next);
+		}
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
 
 EXPORT_API LocationBoundary *
 location_boundary_new_for_rect (LocationPosition* left_top,
@@ -104,7 +397,7 @@ location_boundary_new_for_rect (LocationPosition* left_top,
 	gdouble lon_interval = right_bottom->longitude - left_top->longitude;
 
 	if(lon_interval < 180 && lon_interval > -180) {
-		if(right_bottom->longitude <= left_top->longitude || right_bottom->latitude <= left_top->latitude)
+		if(right_bottom->longitude <= left_top->longitude || right_bottom->latitude >= left_top->latitude)
 			return NULL;
 	}
 	else {
@@ -116,6 +409,7 @@ location_boundary_new_for_rect (LocationPosition* left_top,
 	boundary->type = LOCATION_BOUNDARY_RECT;
 	boundary->rect.left_top = location_position_copy(left_top);
 	boundary->rect.right_bottom = location_position_copy(right_bottom);
+	_set_boundary_cache(boundary);
 	return boundary;
 }
 
@@ -129,6 +423,7 @@ location_boundary_new_for_circle (LocationPosition* center,
 	boundary->type = LOCATION_BOUNDARY_CIRCLE;
 	boundary->circle.center = location_position_copy(center);
 	boundary->circle.radius = radius;
+	_set_boundary_cache(boundary);
 	return boundary;
 }
 
@@ -143,6 +438,8 @@ location_boundary_new_for_polygon(GList *position_list)
 	g_list_foreach(position_list, (GFunc)_append_polygon_position, boundary);
 	boundary->type = LOCATION_BOUNDARY_POLYGON;
 	boundary->polygon.position_list = g_list_first(boundary->polygon.position_list);
+	boundary->polygon.edges = polygon_edges_new(boundary->polygon.position_list);
+	_set_boundary_cache(boundary);
 
 	return boundary;
 }
@@ -159,6 +456,7 @@ location_boundary_free (LocationBoundary* boundary)
 		location_position_free(boundary->circle.center);
 	} else if (boundary->type == LOCATION_BOUNDARY_POLYGON) {
 		g_list_free_full(boundary->polygon.position_list, (GDestroyNotify)_free_polygon_position);
+		if (boundary->polygon.edges) polygon_edges_free(boundary->polygon.edges);
 	}
 	g_slice_free(LocationBoundary, boundary);
 }
@@ -177,6 +475,39 @@ location_boundary_copy (const LocationBoundary* boundary)
 	return NULL;
 }
 
+EXPORT_API gboolean
+location_boundary_equal (const LocationBoundary *boundary1,
+	const LocationBoundary *boundary2)
+{
+	g_return_val_if_fail(boundary1, FALSE);
+	g_return_val_if_fail(boundary2, FALSE);
+
+	if (boundary1 == boundary2) return TRUE;
+	if (boundary1->type != boundary2->type) return FALSE;
+	if (boundary1->hash && boundary2->hash && boundary1->hash != boundary2->hash) return FALSE;
+
+	switch (boundary1->type) {
+		case LOCATION_BOUNDARY_CIRCLE:
+			return location_position_equal(boundary1->circle.center, boundary2->circle.center)
+				&& boundary1->circle.radius == boundary2->circle.radius;
+		case LOCATION_BOUNDARY_RECT:
+			return location_position_equal(boundary1->rect.left_top, boundary2->rect.left_top)
+				&& location_position_equal(boundary1->rect.right_bottom, boundary2->rect.right_bottom);
+		case LOCATION_BOUNDARY_POLYGON:
+			return _polygon_equal(boundary1, boundary2);
+		default:
+			return FALSE;
+	}
+}
+
+EXPORT_API guint
+location_boundary_hash (const LocationBoundary *boundary)
+{
+	g_return_val_if_fail(boundary, 0);
+
+	if (boundary->hash) return boundary->hash;
+	return _compute_boundary_hash(boundary);
+}
 
 EXPORT_API gboolean
 location_boundary_if_inside (LocationBoundary* boundary,
@@ -187,6 +518,11 @@ location_boundary_if_inside (LocationBoundary* boundary,
 
 	gboolean is_inside = FALSE;
 
+	/* The hash is set together with the bounding box at creation */
+	if (boundary->hash && !_box_contains(&boundary->bbox, position->latitude, position->longitude)) {
+		return FALSE;
+	}
+
 	switch(boundary->type) {
 
 		case LOCATION_BOUNDARY_RECT: {
@@ -214,14 +550,9 @@ location_boundary_if_inside (LocationBoundary* boundary,
 		}
 		case LOCATION_BOUNDARY_CIRCLE: {
 
-			LocationPosition center;
-			gulong distance = 0;
-
-			center.latitude = boundary->circle.center->latitude;
-			center.longitude = boundary->circle.center->longitude;
-
-			location_get_distance(&center, position, &distance);
-			if (distance  < boundary->circle.radius){
+			/* Most positions are decided by the equirectangular distance, Vincenty only near the circle */
+			if (geodesic_within_radius(boundary->circle.center->latitude, boundary->circle.center->longitude,
+						position->latitude, position->longitude, boundary->circle.radius)) {
 				LOCATION_LOGD("\tInside Circle boundary");
 				is_inside = TRUE;
 			}
@@ -229,6 +560,13 @@ location_boundary_if_inside (LocationBoundary* boundary,
 		}
 		case LOCATION_BOUNDARY_POLYGON: {
 
+			if (boundary->polygon.edges) {
+				int crossing_num = polygon_edges_count_crossing(boundary->polygon.edges, position->latitude, position->longitude);
+				LOCATION_LOGD("num[%d]", crossing_num);
+				is_inside = crossing_num & 1; // Odd : inside, Even : outside
+				break;
+			}
+
 			int i, j;
 			double interval_x = 0.0, interval_y = 0.0;
 			double x0, y0;
@@ -308,6 +646,148 @@ location_boundary_if_inside (LocationBoundary* boundary,
 	return is_inside;
 }
 
+static gdouble _unwrap_longitude(gdouble longitude, gdouble reference)
+{
+	while (longitude - reference > 180) longitude -= 360;
+	while (longitude - reference < -180) longitude += 360;
+	return longitude;
+}
+
+static gdouble _orientation(gdouble ax, gdouble ay, gdouble bx, gdouble by, gdouble cx, gdouble cy)
+{
+	return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+static gboolean _on_segment(gdouble ax, gdouble ay, gdouble bx, gdouble by, gdouble cx, gdouble cy)
+{
+	return MIN(ax, bx) <= cx && cx <= MAX(ax, bx) && MIN(ay, by) <= cy && cy <= MAX(ay, by);
+}
+
+static gboolean _segments_intersect(gdouble ax, gdouble ay, gdouble bx, gdouble by,
+	gdouble cx, gdouble cy, gdouble dx, gdouble dy)
+{
+	gdouble d1 = _orientation(cx, cy, dx, dy, ax, ay);
+	gdouble d2 = _orientation(cx, cy, dx, dy, bx, by);
+	gdouble d3 = _orientation(ax, ay, bx, by, cx, cy);
+	gdouble d4 = _orientation(ax, ay, bx, by, dx, dy);
+
+	if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) return TRUE;
+	if (d1 == 0 && _on_segment(cx, cy, dx, dy, ax, ay)) return TRUE;
+	if (d2 == 0 && _on_segment(cx, cy, dx, dy, bx, by)) return TRUE;
+	if (d3 == 0 && _on_segment(ax, ay, bx, by, cx, cy)) return TRUE;
+	if (d4 == 0 && _on_segment(ax, ay, bx, by, dx, dy)) return TRUE;
+	return FALSE;
+}
+
+/* Liang-Barsky clipping of the segment (x0, y0) - (x1, y1) against the box */
+static gboolean _segment_hits_box(gdouble x0, gdouble y0, gdouble x1, gdouble y1,
+	gdouble left, gdouble bottom, gdouble right, gdouble top)
+{
+	gdouble p[4] = { x0 - x1, x1 - x0, y0 - y1, y1 - y0 };
+	gdouble q[4] = { x0 - left, right - x0, y0 - bottom, top - y0 };
+	gdouble t0 = 0.0, t1 = 1.0;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		if (p[i] == 0) {
+			if (q[i] < 0) return FALSE;
+		} else {
+			gdouble t = q[i] / p[i];
+			if (p[i] < 0) t0 = MAX(t0, t);
+			else t1 = MIN(t1, t);
+			if (t0 > t1) return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static gboolean _segment_crosses_circle(const LocationBoundary *boundary, const LocationPosition *from, const LocationPosition *to)
+{
+	GeodesicPlane plane;
+	gdouble p0[3], p1[3], closest[3];
+	gdouble dx, dy, length, t = 0.0;
+	gdouble distance, error, latitude, longitude, altitude;
+
+	/* Planar geometry in the tangent frame of the center */
+	geodesic_plane_init(&plane, boundary->circle.center->latitude, boundary->circle.center->longitude, 0);
+	geodesic_plane_forward(&plane, from->latitude, from->longitude, 0, p0);
+	geodesic_plane_forward(&plane, to->latitude, to->longitude, 0, p1);
+	dx = p1[0] - p0[0];
+	dy = p1[1] - p0[1];
+	length = dx * dx + dy * dy;
+
+	/* Closest point to the center on the segment */
+	if (length > 0) t = CLAMP(-(p0[0] * dx + p0[1] * dy) / length, 0.0, 1.0);
+	closest[0] = p0[0] + t * dx;
+	closest[1] = p0[1] + t * dy;
+	closest[2] = p0[2] + t * (p1[2] - p0[2]);
+
+	distance = hypot(closest[0], closest[1]);
+	error = GEODESIC_PLANE_ERROR(MAX(hypot(p0[0], p0[1]), hypot(p1[0], p1[1])));
+	if (distance * (1 - error) >= boundary->circle.radius) return FALSE;
+	if (distance * (1 + error) < boundary->circle.radius) return TRUE;
+
+	geodesic_plane_inverse(&plane, closest, &latitude, &longitude, &altitude);
+	return geodesic_within_radius(boundary->circle.center->latitude, boundary->circle.center->longitude,
+				latitude, longitude, boundary->circle.radius);
+}
+
+static gboolean _segment_crosses_polygon(const LocationBoundary *boundary, gdouble x0, gdouble y0, gdouble x1, gdouble y1)
+{
+	GList *cur = NULL;
+	LocationPosition *prev = (LocationPosition *) g_list_last(boundary->polygon.position_list)->data;
+	gdouble reference = (x0 + x1) / 2;
+
+	for (cur = boundary->polygon.position_list; cur; cur = g_list_next(cur)) {
+		LocationPosition *pos = (LocationPosition *) cur->data;
+		gdouble ax = _unwrap_longitude(prev->longitude, reference);
+		gdouble bx = _unwrap_longitude(pos->longitude, ax);
+
+		if (_segments_intersect(x0, y0, x1, y1, ax, prev->latitude, bx, pos->latitude)) return TRUE;
+		prev = pos;
+	}
+	return FALSE;
+}
+
+EXPORT_API gboolean
+location_boundary_if_crossed (LocationBoundary *boundary,
+	LocationPosition *from,
+	LocationPosition *to)
+{
+	g_return_val_if_fail(boundary, FALSE);
+	g_return_val_if_fail(from, FALSE);
+	g_return_val_if_fail(to, FALSE);
+
+	gdouble x0 = from->longitude, y0 = from->latitude;
+	gdouble x1 = _unwrap_longitude(to->longitude, x0), y1 = to->latitude;
+
+	if (boundary->hash && (MAX(y0, y1) < boundary->bbox.min_latitude || MIN(y0, y1) > boundary->bbox.max_latitude))
+		return FALSE;
+
+	if (location_boundary_if_inside(boundary, from) || location_boundary_if_inside(boundary, to))
+		return TRUE;
+
+	switch (boundary->type) {
+		case LOCATION_BOUNDARY_RECT: {
+			gdouble width = boundary->rect.right_bottom->longitude - boundary->rect.left_top->longitude;
+			gdouble center = 0.0;
+
+			if (width < 0) width += 360;
+			center = _unwrap_longitude(boundary->rect.left_top->longitude + width / 2, (x0 + x1) / 2);
+			return _segment_hits_box(x0, y0, x1, y1, center - width / 2, boundary->rect.right_bottom->latitude,
+				center + width / 2, boundary->rect.left_top->latitude);
+		}
+		case LOCATION_BOUNDARY_CIRCLE:
+			return _segment_crosses_circle(boundary, from, to);
+		case LOCATION_BOUNDARY_POLYGON:
+			return _segment_crosses_polygon(boundary, x0, y0, x1, y1);
+		default:
+			LOCATION_LOGW("\tboundary type is undefined.[%d]", boundary->type);
+			break;
+	}
+	return FALSE;
+}
+
 EXPORT_API int
 location_boundary_add(const LocationObject *obj, const LocationBoundary *boundary)
 {
@@ -335,6 +815,122 @@ location_boundary_remove(const LocationObject *obj, const LocationBoundary *boun
 	return LOCATION_ERROR_NONE;
 }
 
+EXPORT_API int
+location_boundary_add_list(const LocationObject *obj, GList *boundary_list)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (boundary_list, LOCATION_ERROR_PARAMETER);
+
+	g_object_set(G_OBJECT(obj), "boundary", boundary_list, NULL);
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_boundary_remove_list(const LocationObject *obj, GList *boundary_list)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (boundary_list, LOCATION_ERROR_PARAMETER);
+
+	g_object_set(G_OBJECT(obj), "removal-boundary-list", boundary_list, NULL);
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_boundary_store_write(const gchar *path, GList *boundary_list)
+{
+	g_return_val_if_fail (path, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (boundary_list, LOCATION_ERROR_PARAMETER);
+
+	return boundary_store_write(path, boundary_list);
+}
+
+EXPORT_API int
+location_boundary_attach_store(const LocationObject *obj, const gchar *path)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (path, LOCATION_ERROR_PARAMETER);
+
+	LocationBoundaryStore *store = boundary_store_open(path);
+	if (store == NULL) return LOCATION_ERROR_NOT_FOUND;
+
+	g_object_set(G_OBJECT(obj), "boundary-store", store, NULL);
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_boundary_detach_store(const LocationObject *obj)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+
+	g_object_set(G_OBJECT(obj), "boundary-store", NULL, NULL);
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_fence_set_new(guint *handle)
+{
+	g_return_val_if_fail (handle, LOCATION_ERROR_PARAMETER);
+
+	*handle = fence_set_new();
+
+	return LOCATION_ERROR_NONE;
+}
+EXPORT_API int
+location_fence_set_free(guint handle)
+{
+	return fence_set_free(handle);
+}
+EXPORT_API int
+location_fence_set_add(guint handle, GList *boundary_list)
+{
+	g_return_val_if_fail (boundary_list, LOCATION_ERROR_PARAMETER);
+
+	int ret = LOCATION_ERROR_PARAMETER;
+
+	fence_set_lock();
+	LocationFenceSet *set = fence_set_lookup(handle);
+	if (set) ret = fence_set_add(set, boundary_list);
+	fence_set_unlock();
+
+	return ret;
+}
+EXPORT_API int
+location_fence_set_remove(guint handle, const LocationBoundary *boundary)
+{
+	g_return_val_if_fail (boundary, LOCATION_ERROR_PARAMETER);
+
+	int ret = LOCATION_ERROR_PARAMETER;
+
+	fence_set_lock();
+	LocationFenceSet *set = fence_set_lookup(handle);
+	if (set) ret = fence_set_remove(set, boundary);
+	fence_set_unlock();
+
+	return ret;
+}
+EXPORT_API int
+location_fence_set_subscribe(const LocationObject *obj, guint handle)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	if (fence_set_lookup(handle) == NULL) return LOCATION_ERROR_PARAMETER;
+
+	g_object_set(G_OBJECT(obj), "subscribe-fence-set", handle, NULL);
+
+	return LOCATION_ERROR_NONE;
+}
+EXPORT_API int
+location_fence_set_unsubscribe(const LocationObject *obj, guint handle)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+
+	g_object_set(G_OBJECT(obj), "unsubscribe-fence-set", handle, NULL);
+
+	return LOCATION_ERROR_NONE;
+}
 EXPORT_API int
 location_boundary_foreach(const LocationObject *obj, LocationBoundaryFunc func, gpointer user_data)
 {
@@ -359,6 +955,26 @@ location_boundary_get_bounding_box (LocationBoundary *boundary)
 {
 	g_return_val_if_fail (boundary, NULL);
 	LocationBoundary *bbox = NULL;
+	LocationBoundaryBox box = boundary->bbox;
+
+	gdouble span = 0.0;
+
+	if (!boundary->hash && !_get_boundary_box(boundary, &box)) return NULL;
+
+	/* A rectangle spans less than 180 degrees of longitude, a wider box is the whole band of latitudes */
+	span = box.max_longitude - box.min_longitude;
+	if (span < 0) span += 360;
+	if (span >= 180) {
+		box.min_longitude = -180;
+		box.max_longitude = 180;
+	}
+
+	/* Built in place, location_boundary_new_for_rect() rejects the whole band and the boxes of a single latitude */
+	bbox = g_slice_new0 (LocationBoundary);
+	bbox->type = LOCATION_BOUNDARY_RECT;
+	bbox->rect.left_top = location_position_new(0, box.max_latitude, box.min_longitude, 0, LOCATION_STATUS_2D_FIX);
+	bbox->rect.right_bottom = location_position_new(0, box.min_latitude, box.max_longitude, 0, LOCATION_STATUS_2D_FIX);
+	_set_boundary_cache(bbox);
 
 	return bbox;
 }
@@ -368,6 +984,12 @@ location_boundary_get_center_position (LocationBoundary *boundary)
 {
 	g_return_val_if_fail (boundary, NULL);
 	LocationPosition *center = NULL;
+	gdouble latitude = boundary->center_latitude;
+	gdouble longitude = boundary->center_longitude;
+
+	if (!boundary->hash && !_get_boundary_center(boundary, &latitude, &longitude)) return NULL;
+
+	center = location_position_new(0, latitude, longitude, 0, LOCATION_STATUS_2D_FIX);
 
 	return center;
 }
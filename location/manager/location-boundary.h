@@ -81,8 +81,19 @@ typedef struct {
  */
 typedef struct {
 	GList *position_list; 	///< The collection of positions
+	gpointer edges;		///< The edge table compiled from position_list, owned by the boundary.
 } LocationPolygon;
 
+/**
+ * @brief This represents the bounding box of a boundary.
+ */
+typedef struct {
+	gdouble min_latitude;    ///< The southern edge of the box.
+	gdouble max_latitude;    ///< The northern edge of the box.
+	gdouble min_longitude;   ///< The western edge of the box.
+	gdouble max_longitude;   ///< The eastern edge of the box, less than min_longitude when the box crosses the 180th meridian.
+} LocationBoundaryBox;
+
 /**
  * @brief This represents boundary information such as rectangular or circle area.
  */
@@ -93,6 +104,10 @@ struct _LocationBoundary{
 		LocationCircle circle;       ///< The geographical information of a circle.
 		LocationPolygon polygon;		///< The geographical information of a polygon.
 	};
+	guint hash;                  ///< The fingerprint of this information, computed at creation.
+	LocationBoundaryBox bbox;    ///< The bounding box of this information, computed at creation.
+	gdouble center_latitude;     ///< The latitude of the center (the centroid of a polygon), computed at creation.
+	gdouble center_longitude;    ///< The longitude of the center (the centroid of a polygon), computed at creation.
 };
 
 /**
@@ -151,12 +166,42 @@ void location_boundary_free (LocationBoundary *boundary);
  */
 LocationBoundary *location_boundary_copy (const LocationBoundary* boundary);
 
+/**
+ * @brief   Compares two boundaries for equality, returning TRUE if they are equal.
+ * @remarks Polygons are equal if they have the same vertices in the same cyclic order, in either direction.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  boundary1 - a #LocationBoundary
+ * @param [in]  boundary2 - a #LocationBoundary
+ * @return gboolean
+ * @retval\n
+ * TRUE - if equal\n
+ * FALSE - if not equal\n
+ */
+gboolean location_boundary_equal (const LocationBoundary *boundary1, const LocationBoundary *boundary2);
+
+/**
+ * @brief   Gets the fingerprint of a #LocationBoundary.
+ * @remarks Equal boundaries (see #location_boundary_equal) have the same fingerprint, so it can be used as a #GHashFunc.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  boundary - a #LocationBoundary
+ * @return guint
+ */
+guint location_boundary_hash (const LocationBoundary *boundary);
+
 /**
  * @brief
  * Add Boundary on LocationFW.
  * You should call this fuction when you want to receive a crossing signal(zone-in/zone-out) from #LocationBoundary.
  * @remarks It supports multi-boundaries. \n
-    However a duplicated boundary would not be allowed.
+    However a duplicated boundary would not be allowed. \n
+    Besides zone-in/zone-out, a "zone-changed" signal is emitted once per position update with the lists of boundaries
+    entered and left (GList of #LocationBoundary, valid only during the callback). A newly added boundary is reported once with its initial state.
+    When the "zone-crossing" property is TRUE, a boundary passed through between two position updates is reported as
+    both entered and left, and zone-in is followed by zone-out.
+    For GPS and hybrid, when the "zone-duty-cycle" property is TRUE, the positioning is paused while no boundary can be reached
+    at the current speed, and resumed in time to get a fix before the nearest one.
  * @pre
  * #location_new should be called before.\n
  * @post None.
@@ -234,6 +279,253 @@ void location_test_boundary_remove(LocationObject *loc)
  */
 int location_boundary_remove(const LocationObject *obj, const LocationBoundary *boundary);
 
+/**
+ * @brief
+ * Add a list of Boundaries on LocationFW at once.
+ * @remarks The whole list is registered in a single property change. Duplicated boundaries are skipped.
+ * @pre
+ * #location_new should be called before.\n
+ * @post None.
+ * @param [in]  obj - a #LocationObject
+ * @param [in]  boundary_list - a GList of #LocationBoundary
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ * @see location_boundary_add
+ */
+int location_boundary_add_list(const LocationObject *obj, GList *boundary_list);
+
+/**
+ * @brief
+ * Remove a list of Boundaries on LocationFW at once.
+ * @remarks The whole list is removed in a single property change.
+ * @pre
+ * #location_new should be called before.\n
+ * @post None.
+ * @param [in]  obj - a #LocationObject
+ * @param [in]  boundary_list - a GList of #LocationBoundary
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ * @see location_boundary_remove
+ */
+int location_boundary_remove_list(const LocationObject *obj, GList *boundary_list);
+
+/**
+ * @brief
+ * Write a list of Boundaries into a geofence store file.
+ * @remarks The file keeps the fences in a packed form with a prebuilt grid, to be attached with #location_boundary_attach_store.
+    The id of a fence is its position in boundary_list, starting from 0.
+ * @pre     #location_init should be called before.\n
+ * @post None.
+ * @param [in]  path - the file to write
+ * @param [in]  boundary_list - a GList of #LocationBoundary
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_boundary_store_write(const gchar *path, GList *boundary_list);
+
+/**
+ * @brief
+ * Attach a geofence store file written by #location_boundary_store_write to a #LocationObject.
+ * @remarks The file is memory-mapped and its fences are evaluated in place on every position update, without creating #LocationBoundary. \n
+    Changes are notified by a "fence-changed" signal carrying two GArray of guint32 fence ids (entered, left), the position and the accuracy.
+    The arrays are valid only during the callback. Fences of the store start outside, and only changes are notified. \n
+    Attaching a store replaces the previous one. It works alongside the boundaries added by #location_boundary_add.
+ * @pre
+ * #location_new should be called before.\n
+ * @post None.
+ * @param [in]  obj - a #LocationObject
+ * @param [in]  path - the geofence store file
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_NOT_FOUND       The file can not be mapped or is not a geofence store
+ * Please refer #LocationError for more information.
+ */
+int location_boundary_attach_store(const LocationObject *obj, const gchar *path);
+
+/**
+ * @brief
+ * Detach the geofence store attached to a #LocationObject.
+ * @remarks None.
+ * @pre
+ * #location_new should be called before.\n
+ * @post None.
+ * @param [in]  obj - a #LocationObject
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_boundary_detach_store(const LocationObject *obj);
+
+/**
+ * @brief
+ * Create a fence set shared by the LocationObjects of the process.
+ * @remarks The fences of a set are stored and indexed once, and evaluated once per position for all of the
+    LocationObjects subscribed to it by #location_fence_set_subscribe. \n
+    Each subscriber keeps its own zone state and gets the fences of the set in its "zone-changed" signal and in zone-in/zone-out,
+    the same way as its own boundaries. Fence sets are used from the main loop.
+ * @pre     #location_init should be called before.\n
+ * @post    #location_fence_set_free should be called when the set is no longer needed.
+ * @param [out] handle - the handle of the new fence set, never 0
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_fence_set_new(guint *handle);
+
+/**
+ * @brief
+ * Release the handle of a fence set.
+ * @remarks The fences are freed once the last subscriber unsubscribes.
+ * @pre     #location_fence_set_new should be called before.\n
+ * @post None.
+ * @param [in]  handle - a fence set handle
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_fence_set_free(guint handle);
+
+/**
+ * @brief
+ * Add a list of Boundaries to a fence set.
+ * @remarks The boundaries are copied. Duplicated boundaries are skipped.
+ * @pre     #location_fence_set_new should be called before.\n
+ * @post None.
+ * @param [in]  handle - a fence set handle
+ * @param [in]  boundary_list - a GList of #LocationBoundary
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_fence_set_add(guint handle, GList *boundary_list);
+
+/**
+ * @brief
+ * Remove a Boundary from a fence set.
+ * @remarks The subscribers are not notified about the removed boundary.
+ * @pre     #location_fence_set_new should be called before.\n
+ * @post None.
+ * @param [in]  handle - a fence set handle
+ * @param [in]  boundary - a #LocationBoundary
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_fence_set_remove(guint handle, const LocationBoundary *boundary);
+
+/**
+ * @brief
+ * Subscribe a #LocationObject to a fence set.
+ * @remarks The first position update after subscribing reports the initial state of every fence of the set.
+    Zone crossing between positions is not checked on fence sets.
+ * @pre
+ * #location_new should be called before.\n
+ * @post None.
+ * @param [in]  obj - a #LocationObject
+ * @param [in]  handle - a fence set handle
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_fence_set_subscribe(const LocationObject *obj, guint handle);
+
+/**
+ * @brief
+ * Unsubscribe a #LocationObject from a fence set.
+ * @remarks None.
+ * @pre
+ * #location_new should be called before.\n
+ * @post None.
+ * @param [in]  obj - a #LocationObject
+ * @param [in]  handle - a fence set handle
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_fence_set_unsubscribe(const LocationObject *obj, guint handle);
+
+/**
+ * @brief This represents a position of a tracked asset, given to #location_asset_monitor_update.
+ */
+typedef struct {
+	guint asset_id;			///< The caller defined id of the asset.
+	LocationPosition position;	///< The position of the asset.
+} LocationAssetPosition;
+
+/**
+ * @brief This represents a zone change of a tracked asset, returned by #location_asset_monitor_update.
+ */
+typedef struct {
+	guint asset_id;			///< The id of the asset.
+	guint timestamp;		///< The timestamp of the position which changed the zone.
+	LocationBoundary *boundary;	///< The boundary of the fence set, owned by the set.
+	gboolean entered;		///< TRUE if the asset entered the boundary, FALSE if it left.
+} LocationZoneTransition;
+
+typedef struct _LocationAssetMonitor LocationAssetMonitor;
+
+/**
+ * @brief
+ * Create a monitor evaluating the positions of many assets against a fence set.
+ * @remarks The monitor keeps the zone state of every asset it has seen. Assets start outside of every fence. \n
+    Batches are evaluated by the caller thread together with a pool of thread_count - 1 threads.
+    The monitor and the fence set must be used from a single thread.
+ * @pre     #location_fence_set_new should be called before.\n
+ * @post    #location_asset_monitor_free should be called when the monitor is no longer needed.
+ * @param [in]  fence_set - a fence set handle
+ * @param [in]  thread_count - the number of threads evaluating a batch, 0 for the number of online processors
+ * @return a new #LocationAssetMonitor
+ * @retval NULL if error occured
+ */
+LocationAssetMonitor *location_asset_monitor_new (guint fence_set, guint thread_count);
+
+/**
+ * @brief
+ * Free a #LocationAssetMonitor.
+ * @remarks None.
+ * @pre     #location_asset_monitor_new should be called before.\n
+ * @post None.
+ * @param [in]  monitor - a #LocationAssetMonitor
+ * @return None.
+ */
+void location_asset_monitor_free (LocationAssetMonitor *monitor);
+
+/**
+ * @brief
+ * Evaluate a batch of asset positions and get the zone transitions.
+ * @remarks The positions of an asset are applied in their order in the batch.
+    The transitions are grouped by asset, in the order of the first position of each asset in the batch. \n
+    transitions is a GArray of #LocationZoneTransition owned by the monitor, valid until the next update or until a fence is removed from the set.
+ * @pre     #location_asset_monitor_new should be called before.\n
+ * @post None.
+ * @param [in]  monitor - a #LocationAssetMonitor
+ * @param [in]  records - an array of #LocationAssetPosition
+ * @param [in]  count - the number of records
+ * @param [out] transitions - a GArray of #LocationZoneTransition
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_asset_monitor_update (LocationAssetMonitor *monitor, const LocationAssetPosition *records, guint count, GArray **transitions);
+
+/**
+ * @brief
+ * Forget the zone state of an asset.
+ * @remarks The next position of the asset starts outside of every fence again.
+ * @pre     #location_asset_monitor_new should be called before.\n
+ * @post None.
+ * @param [in]  monitor - a #LocationAssetMonitor
+ * @param [in]  asset_id - the id of the asset
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_PARAMETER       The asset is unknown
+ * Please refer #LocationError for more information.
+ */
+int location_asset_monitor_remove_asset (LocationAssetMonitor *monitor, guint asset_id);
+
 /**
  * @brief
  * Call a function for each element of a Boundary list.
@@ -297,14 +589,43 @@ void location_test_boundary_if_inside(LocationObject *loc, LocationBoundary *bou
  */
 gboolean location_boundary_if_inside (LocationBoundary *boundary, LocationPosition *position);
 
+/**
+ * @brief   Check if the path between two #LocationPosition passes through #LocationBoundary.
+ * @remarks The path is the straight line between the positions in latitude and longitude, taking the shorter way across the 180th meridian.
+    It is TRUE as well when either position is inside.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  boundary - a #LocationBoundary
+ * @param [in]  from - a #LocationPosition
+ * @param [in]  to - a #LocationPosition
+ * @return gboolean
+ * @retval\n
+ * TRUE - if crossed\n
+ * FALSE - if not crossed\n
+ */
+gboolean location_boundary_if_crossed (LocationBoundary *boundary, LocationPosition *from, LocationPosition *to);
+
 /**
  * @brief Get bounding box of #LocationBoundary
+ * @remarks The box of a circle is conservative, it may be a little larger than the circle.\n
+ * A boundary spanning 180 degrees of longitude or more, e.g. a circle or a polygon around a pole, gets the whole band of its latitudes.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  boundary - a #LocationBoundary
+ * @return a new rectangular #LocationBoundary, free with #location_boundary_free
+ * @retval NULL if boundary is not a valid boundary
  */
 LocationBoundary *location_boundary_get_bounding_box (LocationBoundary *boundary);
 
 
 /**
  * @brief Get the center position of #LocationBoundary
+ * @remarks The center of a polygon is its centroid.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  boundary - a #LocationBoundary
+ * @return a new #LocationPosition, free with #location_position_free
+ * @retval NULL if error occured
  */
 LocationPosition * location_boundary_get_center_position (LocationBoundary *boundary);
 
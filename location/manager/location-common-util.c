@@ -24,6 +24,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <location-appman.h>
@@ -78,147 +79,70 @@ int location_application_enabled (void)
 	return enabled;
 }
 
-static gint compare_position (gconstpointer a, gconstpointer b)
-{
-	g_return_val_if_fail(a, 1);
-	g_return_val_if_fail(b, -1);
-
-	if(location_position_equal((LocationPosition*) a, (LocationPosition *)b) == TRUE) {
-		return 0;
-	}
-
-	return -1;
-}
-
-static int
-boundary_compare (gconstpointer comp1, gconstpointer comp2)
-{
-	g_return_val_if_fail(comp1, 1);
-	g_return_val_if_fail(comp2, -1);
-
-	int ret = -1;
-
-	LocationBoundary *boundary1 = (LocationBoundary *)comp1;
-	LocationBoundary *boundary2 = (LocationBoundary *)comp2;
-
-	if (boundary1->type == boundary2->type) {
-		switch (boundary1->type) {
-			case LOCATION_BOUNDARY_CIRCLE: {
-				if (location_position_equal(boundary1->circle.center, boundary2->circle.center)
-					&& boundary1->circle.radius == boundary2->circle.radius) {
-					ret = 0;
-				}
-				break;
-			}
-			case LOCATION_BOUNDARY_RECT: {
-				if (location_position_equal(boundary1->rect.left_top, boundary2->rect.left_top)
-					&& location_position_equal(boundary1->rect.right_bottom, boundary2->rect.right_bottom)) {
-					ret = 0;
-				}
-				break;
-			}
-			case LOCATION_BOUNDARY_POLYGON: {
-
-				GList *boundary1_next = NULL;
-				GList *boundary2_start = NULL, *boundary2_prev = NULL, *boundary2_next = NULL;
-				if (g_list_length(boundary1->polygon.position_list) != g_list_length(boundary2->polygon.position_list)) {
-					return -1;
-				}
-
-				// Find a matching index of Boundary2 with Boundary1's 1st postion.
-				boundary2_start = g_list_find_custom(boundary2->polygon.position_list, g_list_nth_data(boundary1->polygon.position_list, 0), (GCompareFunc) compare_position);
-				if (boundary2_start == NULL) return -1;
-
-				boundary2_prev = g_list_previous(boundary2_start);
-				boundary2_next = g_list_next(boundary2_start);
-				if (boundary2_prev == NULL) boundary2_prev = g_list_last(boundary2->polygon.position_list);
-				if (boundary2_next == NULL) boundary2_next = g_list_first(boundary2->polygon.position_list);
-
-				boundary1_next = g_list_next(boundary1->polygon.position_list);
-				if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*)boundary2_prev->data) == TRUE){
-					boundary1_next = g_list_next(boundary1_next);
-					while (boundary1_next) {
-						boundary2_prev = g_list_previous(boundary2_prev);
-						if (boundary2_prev == NULL) boundary2_prev = g_list_last(boundary2->polygon.position_list);
-						if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*) boundary2_prev->data) == FALSE){
-							return -1;
-						}
-						boundary1_next = g_list_next(boundary1_next);
-					}
-					ret = 0;
-				}
-				else if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*)boundary2_next->data) == TRUE) {
-					boundary1_next = g_list_next(boundary1_next);
-					while(boundary1_next) {
-						boundary2_next = g_list_next(boundary2_next);
-						if (boundary2_next == NULL) boundary2_next = g_list_first(boundary2->polygon.position_list);
-						if (location_position_equal((LocationPosition*)boundary1_next->data, (LocationPosition*) boundary2_next->data) == FALSE){
-							return -1;
-						}
-						boundary1_next = g_list_next(boundary1_next);
-					}
-					ret = 0;
-				}
-				else {
-					return -1;
-				}
-				break;
-			}
-			default:{
-				 ret = -1;
-				 break;
-			}
-
-		}
-	}
-
-	return ret;
-}
-
-int set_prop_boundary(GList **prev_boundary_list, GList *new_boundary_list)
+int set_prop_boundary(GList **prev_boundary_list, LocationBoundaryIndex *boundary_index, GList *new_boundary_list)
 {
 	g_return_val_if_fail(new_boundary_list, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(boundary_index, LOCATION_ERROR_PARAMETER);
 
-	int index;
-	GList *check_list = NULL;
+	GList *cur = NULL;
+	GList *added_list = NULL;
 
 	LocationBoundary *new_boundary = NULL;
 	LocationBoundary *copy_boundary = NULL;
 
-	index = 0;
-	while((new_boundary = (LocationBoundary*) g_list_nth_data(new_boundary_list, index)) != NULL) {
+	for (cur = new_boundary_list; cur; cur = g_list_next(cur)) {
+		new_boundary = (LocationBoundary*) cur->data;
+		if (new_boundary == NULL) break;
 
-		check_list = g_list_find_custom(*prev_boundary_list, new_boundary, (GCompareFunc)boundary_compare);
-		if (check_list == NULL) {
+		if (boundary_index_lookup(boundary_index, new_boundary) == NULL) {
 			LOCATION_LOGD("Set Prop >> boundary type: [%d]", new_boundary->type);
 			copy_boundary = location_boundary_copy(new_boundary);
-			*prev_boundary_list = g_list_append(*prev_boundary_list, copy_boundary);
+			if (copy_boundary == NULL) continue;
+			added_list = g_list_prepend(added_list, copy_boundary);
+			boundary_index_add(boundary_index, added_list);
 		}
-		index++;
 	}
-	*prev_boundary_list = g_list_first(*prev_boundary_list);
+
+	/* The links registered in the index are kept as they are by reverse and concat */
+	*prev_boundary_list = g_list_concat(*prev_boundary_list, g_list_reverse(added_list));
 
 	return LOCATION_ERROR_NONE;
 }
 
-
-
-int set_prop_removal_boundary(GList **prev_boundary_list, LocationBoundary* boundary)
+int set_prop_removal_boundary(GList **prev_boundary_list, LocationBoundaryIndex *boundary_index, LocationBoundary* boundary)
 {
 	g_return_val_if_fail(*prev_boundary_list, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(boundary_index, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(boundary, LOCATION_ERROR_PARAMETER);
 
 	GList *check_list = NULL;
 
-	check_list = g_list_find_custom (*prev_boundary_list, boundary, (GCompareFunc) boundary_compare);
+	check_list = boundary_index_lookup(boundary_index, boundary);
 	if (check_list) {
 		LOCATION_LOGD("Found");
+		boundary_index_remove(boundary_index, (LocationBoundary *) check_list->data);
+		location_boundary_free((LocationBoundary *) check_list->data);
 		*prev_boundary_list = g_list_delete_link(*prev_boundary_list, check_list);
 	}
 
-	if (g_list_length(*prev_boundary_list) == 0 ) {
+	if (*prev_boundary_list == NULL) {
 		LOCATION_LOGD("Boundary List is empty");
-		g_list_free(*prev_boundary_list);
-		*prev_boundary_list = NULL;
+	}
+
+	return LOCATION_ERROR_NONE;
+}
+
+int set_prop_removal_boundary_list(GList **prev_boundary_list, LocationBoundaryIndex *boundary_index, GList *removal_boundary_list)
+{
+	g_return_val_if_fail(*prev_boundary_list, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(boundary_index, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(removal_boundary_list, LOCATION_ERROR_PARAMETER);
+
+	GList *cur = NULL;
+
+	for (cur = removal_boundary_list; cur && *prev_boundary_list; cur = g_list_next(cur)) {
+		if (cur->data == NULL) break;
+		set_prop_removal_boundary(prev_boundary_list, boundary_index, (LocationBoundary *) cur->data);
 	}
 
 	return LOCATION_ERROR_NONE;
@@ -231,3 +155,62 @@ void free_boundary_list (gpointer data)
 	location_boundary_free(boundary);
 }
 
+/* Interval in milliseconds kept by the objects, 0 for the default */
+guint get_update_interval_ms(guint interval_ms)
+{
+	if (!interval_ms) return LOCATION_UPDATE_INTERVAL_MS_DEFAULT;
+	return CLAMP(interval_ms, LOCATION_UPDATE_INTERVAL_MS_MIN, LOCATION_UPDATE_INTERVAL_MS_MAX);
+}
+
+/* Seconds the provider can be paused before any fence can be reached, 0 to keep it running */
+guint get_zone_sleep_interval(LocationBoundaryIndex *boundary_index, const LocationPosition *pos, const LocationAccuracy *acc, const LocationVelocity *vel)
+{
+	g_return_val_if_fail(boundary_index, 0);
+	g_return_val_if_fail(pos, 0);
+
+	gdouble clearance = 0.0;
+	gdouble speed = LOCATION_ZONE_MIN_SPEED;
+	gdouble interval = 0.0;
+
+	if (pos->status == LOCATION_STATUS_NO_FIX) return 0;
+
+	clearance = boundary_index_get_clearance(boundary_index, pos);
+	if (clearance < 0) return 0;
+
+	if (acc && acc->level != LOCATION_ACCURACY_LEVEL_NONE) clearance -= acc->horizontal_accuracy;
+	if (vel && vel->timestamp) speed = MAX(vel->speed / 3.6, LOCATION_ZONE_MIN_SPEED);
+
+	interval = clearance / speed - LOCATION_ZONE_WAKEUP_TIME;
+	LOCATION_LOGD("Zone clearance [%f] m, speed [%f] m/s, sleep [%f] s", clearance, speed, interval);
+	if (interval < LOCATION_ZONE_SLEEP_MIN) return 0;
+
+	return (guint) MIN(interval, LOCATION_ZONE_SLEEP_MAX);
+}
+
+void set_prop_provider_thread(LocationObject *obj, ProviderThread **thread, gboolean enabled)
+{
+	g_return_if_fail(obj);
+	g_return_if_fail(thread);
+
+	if (enabled && !*thread) {
+		*thread = provider_thread_new(obj);
+	} else if (!enabled && *thread) {
+		provider_thread_free(*thread);
+		*thread = NULL;
+	}
+}
+
+/* Fill the storage of the caller from the snapshots of an object, nothing is allocated */
+int copy_satellite_into(const LocationSatellite *sat, LocationSatellite *satellite, LocationSatelliteDetail *details, guint max_details)
+{
+	g_return_val_if_fail(satellite, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(details || !max_details, LOCATION_ERROR_PARAMETER);
+	if (!sat) return LOCATION_ERROR_NOT_AVAILABLE;
+
+	*satellite = *sat;
+	satellite->sat_inview = details;
+	/* The count needed is given back to retry with a larger array */
+	if (sat->num_of_sat_inview > max_details) return LOCATION_ERROR_PARAMETER;
+	if (sat->num_of_sat_inview) memcpy(details, sat->sat_inview, sat->num_of_sat_inview * sizeof(LocationSatelliteDetail));
+	return LOCATION_ERROR_NONE;
+}
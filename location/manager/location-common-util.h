@@ -24,6 +24,8 @@
 
 #include <location.h>
 #include <location-ielement.h>
+#include <location-boundary-index.h>
+#include <location-provider-thread.h>
 
 /**
  * @file location-common-util.h
@@ -35,10 +37,25 @@ G_BEGIN_DECLS
 int location_application_manager (void);
 int location_application_enabled (void);
 
-int set_prop_boundary(GList **prev_boundary_list, GList *new_boundary_list);
-int set_prop_removal_boundary(GList **prev_boundary_list, LocationBoundary *boundary);
+int set_prop_boundary(GList **prev_boundary_list, LocationBoundaryIndex *boundary_index, GList *new_boundary_list);
+int set_prop_removal_boundary(GList **prev_boundary_list, LocationBoundaryIndex *boundary_index, LocationBoundary *boundary);
+int set_prop_removal_boundary_list(GList **prev_boundary_list, LocationBoundaryIndex *boundary_index, GList *removal_boundary_list);
 void free_boundary_list (gpointer data);
 
+#define LOCATION_ZONE_SLEEP_MIN		30	/* seconds, shorter pauses do not pay for the next time to fix */
+#define LOCATION_ZONE_SLEEP_MAX		600	/* seconds */
+#define LOCATION_ZONE_WAKEUP_TIME	15	/* seconds to get a fix again after resuming */
+#define LOCATION_ZONE_MIN_SPEED		2.0	/* m/s, assumed when the device seems still */
+
+guint get_update_interval_ms(guint interval_ms);
+
+guint get_zone_sleep_interval(LocationBoundaryIndex *boundary_index, const LocationPosition *pos, const LocationAccuracy *acc, const LocationVelocity *vel);
+
+/* Not to be called with the object locked, stopping the thread waits for its callback */
+void set_prop_provider_thread(LocationObject *obj, ProviderThread **thread, gboolean enabled);
+
+int copy_satellite_into(const LocationSatellite *sat, LocationSatellite *satellite, LocationSatelliteDetail *details, guint max_details);
+
 G_END_DECLS
 
 #endif
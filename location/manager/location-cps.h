@@ -55,6 +55,8 @@ struct _LocationCpsClass
 	void (* updated) (guint type, gpointer data);
 	void (* zone_in) (guint type, gpointer position, gpointer boundary);
 	void (* zone_out) (guint type, gpointer position, gpointer boundary);
+	void (* zone_changed) (gpointer entered, gpointer left, gpointer position, gpointer accuracy);
+	void (* fence_changed) (gpointer entered, gpointer left, gpointer position, gpointer accuracy);
 };
 
 GType location_cps_get_type (void);
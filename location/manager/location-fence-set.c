@@ -0,0 +1,371 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "location-fence-set.h"
+#include "location-common-util.h"
+#include "location-log.h"
+
+/**
+ * A fence set owns its boundaries and a LocationBoundaryIndex over them, like a LocationObject does
+ * for its own boundaries. The inside list of the last evaluated position is cached, so the LocationObjects
+ * subscribed to the set and receiving the same fix evaluate it once; each subscription only keeps
+ * the set of boundaries containing its own last position, to find its transitions.
+ * A boundary removed while a subscriber is inside it is reported as left on the next update of the
+ * subscriber, by a copy the subscription keeps until the update after.
+ * The application changes the fence sets while the provider threads of the subscribers evaluate
+ * them, so all of them share one recursive lock, taken by every function of this file.
+ */
+struct _LocationFenceSet {
+	guint handle;
+	gint ref_count;
+	GList *boundary_list;
+	LocationBoundaryIndex *index;
+	GList *subscription_list;
+	LocationPosition *position;	/* last evaluated position */
+	GList *inside_list;		/* boundaries containing position */
+};
+
+struct _LocationFenceSubscription {
+	LocationFenceSet *set;
+	GHashTable *inside;	/* set of LocationBoundary */
+	GHashTable *scratch;	/* empty set, the next inside one */
+	GList *removed_list;	/* copies of the removed boundaries it was inside, to report */
+	GList *reported_list;	/* copies reported by the last update */
+	gboolean initial;
+	LocationFenceRemovedFunc removed_func;
+	gpointer user_data;
+};
+
+static GHashTable *fence_sets = NULL;	/* handle -> LocationFenceSet */
+static guint last_handle = 0;
+static GStaticRecMutex fence_sets_lock = G_STATIC_REC_MUTEX_INIT;
+
+static void
+_invalidate (LocationFenceSet *set)
+{
+	if (set->position) location_position_free (set->position);
+	set->position = NULL;
+	g_list_free (set->inside_list);
+	set->inside_list = NULL;
+}
+
+static void
+_unref (LocationFenceSet *set)
+{
+	if (--set->ref_count > 0) return;
+
+	_invalidate (set);
+	boundary_index_free (set->index);
+	g_list_free_full (set->boundary_list, free_boundary_list);
+	g_slice_free (LocationFenceSet, set);
+}
+
+void
+fence_set_lock (void)
+{
+	g_static_rec_mutex_lock (&fence_sets_lock);
+}
+
+void
+fence_set_unlock (void)
+{
+	g_static_rec_mutex_unlock (&fence_sets_lock);
+}
+
+guint
+fence_set_new (void)
+{
+	LocationFenceSet *set = g_slice_new0 (LocationFenceSet);
+	guint handle = 0;
+
+	fence_set_lock ();
+	if (!fence_sets) fence_sets = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	do {
+		last_handle++;
+	} while (last_handle == 0 || g_hash_table_lookup (fence_sets, GUINT_TO_POINTER(last_handle)));
+
+	set->handle = last_handle;
+	set->ref_count = 1;
+	set->index = boundary_index_new ();
+	g_hash_table_insert (fence_sets, GUINT_TO_POINTER(set->handle), set);
+	handle = set->handle;
+	fence_set_unlock ();
+
+	return handle;
+}
+
+int
+fence_set_free (guint handle)
+{
+	fence_set_lock ();
+	LocationFenceSet *set = fence_set_lookup (handle);
+	if (!set) {
+		fence_set_unlock ();
+		return LOCATION_ERROR_PARAMETER;
+	}
+
+	/* The subscribers keep the set alive, without a handle */
+	g_hash_table_remove (fence_sets, GUINT_TO_POINTER(handle));
+	_unref (set);
+	fence_set_unlock ();
+
+	return LOCATION_ERROR_NONE;
+}
+
+LocationFenceSet *
+fence_set_lookup (guint handle)
+{
+	LocationFenceSet *set = NULL;
+
+	fence_set_lock ();
+	if (fence_sets) set = (LocationFenceSet *) g_hash_table_lookup (fence_sets, GUINT_TO_POINTER(handle));
+	fence_set_unlock ();
+
+	return set;
+}
+
+int
+fence_set_add (LocationFenceSet *set, GList *boundary_list)
+{
+	g_return_val_if_fail (set, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (boundary_list, LOCATION_ERROR_PARAMETER);
+
+	fence_set_lock ();
+	_invalidate (set);
+	int ret = set_prop_boundary (&set->boundary_list, set->index, boundary_list);
+	fence_set_unlock ();
+
+	return ret;
+}
+
+int
+fence_set_remove (LocationFenceSet *set, const LocationBoundary *boundary)
+{
+	g_return_val_if_fail (set, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (boundary, LOCATION_ERROR_PARAMETER);
+
+	GList *link = NULL;
+	GList *cur = NULL;
+
+	fence_set_lock ();
+	link = boundary_index_lookup (set->index, boundary);
+	if (!link) {
+		fence_set_unlock ();
+		return LOCATION_ERROR_NONE;
+	}
+
+	/* The zone states must not keep the boundary about to be freed */
+	for (cur = set->subscription_list; cur; cur = g_list_next (cur)) {
+		LocationFenceSubscription *subscription = (LocationFenceSubscription *) cur->data;
+		if (g_hash_table_remove (subscription->inside, link->data) && !subscription->initial) {
+			subscription->removed_list = g_list_prepend (subscription->removed_list, location_boundary_copy ((LocationBoundary *) link->data));
+		}
+		if (subscription->removed_func) subscription->removed_func ((LocationBoundary *) link->data, subscription->user_data);
+	}
+	_invalidate (set);
+
+	boundary_index_remove (set->index, (LocationBoundary *) link->data);
+	location_boundary_free ((LocationBoundary *) link->data);
+	set->boundary_list = g_list_delete_link (set->boundary_list, link);
+	fence_set_unlock ();
+
+	return LOCATION_ERROR_NONE;
+}
+
+guint
+fence_set_size (const LocationFenceSet *set)
+{
+	g_return_val_if_fail (set, 0);
+
+	fence_set_lock ();
+	guint size = boundary_index_size (set->index);
+	fence_set_unlock ();
+
+	return size;
+}
+
+const LocationBoundaryIndex *
+fence_set_get_index (const LocationFenceSet *set)
+{
+	g_return_val_if_fail (set, NULL);
+	return set->index;
+}
+
+LocationFenceSubscription *
+fence_set_subscribe (LocationFenceSet *set)
+{
+	g_return_val_if_fail (set, NULL);
+
+	LocationFenceSubscription *subscription = g_slice_new0 (LocationFenceSubscription);
+	subscription->set = set;
+	subscription->inside = g_hash_table_new (g_direct_hash, g_direct_equal);
+	subscription->scratch = g_hash_table_new (g_direct_hash, g_direct_equal);
+	subscription->initial = TRUE;
+
+	fence_set_lock ();
+	set->ref_count++;
+	set->subscription_list = g_list_prepend (set->subscription_list, subscription);
+	fence_set_unlock ();
+
+	return subscription;
+}
+
+void
+fence_set_unsubscribe (LocationFenceSubscription *subscription)
+{
+	g_return_if_fail (subscription);
+
+	LocationFenceSet *set = subscription->set;
+
+	fence_set_lock ();
+	set->subscription_list = g_list_remove (set->subscription_list, subscription);
+	g_hash_table_destroy (subscription->inside);
+	g_hash_table_destroy (subscription->scratch);
+	g_list_free_full (subscription->removed_list, (GDestroyNotify) location_boundary_free);
+	g_list_free_full (subscription->reported_list, (GDestroyNotify) location_boundary_free);
+	g_slice_free (LocationFenceSubscription, subscription);
+	_unref (set);
+	fence_set_unlock ();
+}
+
+void
+fence_subscription_set_removed_func (LocationFenceSubscription *subscription, LocationFenceRemovedFunc func, gpointer user_data)
+{
+	g_return_if_fail (subscription);
+
+	fence_set_lock ();
+	subscription->removed_func = func;
+	subscription->user_data = user_data;
+	fence_set_unlock ();
+}
+
+guint
+fence_subscription_get_handle (const LocationFenceSubscription *subscription)
+{
+	g_return_val_if_fail (subscription, 0);
+	return subscription->set->handle;
+}
+
+static gboolean
+_collect_inside (LocationBoundary *boundary, gpointer user_data)
+{
+	LocationFenceSet *set = (LocationFenceSet *) user_data;
+
+	if (location_boundary_if_inside (boundary, set->position)) {
+		set->inside_list = g_list_prepend (set->inside_list, boundary);
+	}
+	return FALSE;
+}
+
+static gboolean
+_is_evaluated (const LocationFenceSet *set, const LocationPosition *position)
+{
+	return set->position &&
+		set->position->timestamp == position->timestamp &&
+		set->position->latitude == position->latitude &&
+		set->position->longitude == position->longitude;
+}
+
+static const GList *
+_evaluate (LocationFenceSet *set, const LocationPosition *position)
+{
+	if (_is_evaluated (set, position)) return set->inside_list;
+
+	_invalidate (set);
+	set->position = location_position_copy (position);
+	boundary_index_foreach_candidate (set->index, position, _collect_inside, set);
+
+	return set->inside_list;
+}
+
+gboolean
+fence_subscription_update_zone (LocationFenceSubscription *subscription,
+	const LocationPosition *position,
+	GList **entered,
+	GList **left)
+{
+	g_return_val_if_fail (subscription, FALSE);
+	g_return_val_if_fail (position, FALSE);
+	g_return_val_if_fail (entered, FALSE);
+	g_return_val_if_fail (left, FALSE);
+
+	const GList *cur = NULL;
+	GHashTable *inside = NULL;
+	GHashTableIter iter;
+	gpointer key = NULL;
+	GList *removed = NULL;
+	gboolean is_inside = FALSE;
+
+	fence_set_lock ();
+	cur = _evaluate (subscription->set, position);
+	inside = subscription->scratch;
+
+	/* The copies reported last time have been emitted by now */
+	g_list_free_full (subscription->reported_list, (GDestroyNotify) location_boundary_free);
+	subscription->reported_list = subscription->removed_list;
+	subscription->removed_list = NULL;
+	for (removed = subscription->reported_list; removed; removed = g_list_next (removed)) {
+		*left = g_list_prepend (*left, removed->data);
+	}
+
+	for (; cur; cur = g_list_next (cur)) {
+		g_hash_table_insert (inside, cur->data, cur->data);
+		if (!g_hash_table_lookup (subscription->inside, cur->data)) *entered = g_list_prepend (*entered, cur->data);
+	}
+
+	g_hash_table_iter_init (&iter, subscription->inside);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		if (!g_hash_table_lookup (inside, key)) *left = g_list_prepend (*left, key);
+	}
+
+	/* The first update reports the initial state of every boundary of the set */
+	if (subscription->initial) {
+		for (cur = subscription->set->boundary_list; cur; cur = g_list_next (cur)) {
+			if (!g_hash_table_lookup (inside, cur->data)) *left = g_list_prepend (*left, cur->data);
+		}
+		subscription->initial = FALSE;
+	}
+
+	g_hash_table_remove_all (subscription->inside);
+	subscription->scratch = subscription->inside;
+	subscription->inside = inside;
+	is_inside = g_hash_table_size (inside) > 0;
+	fence_set_unlock ();
+
+	return is_inside;
+}
+
+gdouble
+fence_subscription_get_clearance (const LocationFenceSubscription *subscription, const LocationPosition *position)
+{
+	g_return_val_if_fail (subscription, G_MAXDOUBLE);
+
+	fence_set_lock ();
+	gdouble clearance = boundary_index_get_clearance (subscription->set->index, position);
+	fence_set_unlock ();
+
+	return clearance < 0 ? G_MAXDOUBLE : clearance;
+}
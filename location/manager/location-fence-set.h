@@ -0,0 +1,70 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_FENCE_SET_H__
+#define __LOCATION_FENCE_SET_H__
+
+#include <location-boundary.h>
+#include <location-boundary-index.h>
+
+/**
+ * @file location-fence-set.h
+ * @brief This file contains the process-wide fence sets shared by LocationObjects through subscriptions.
+ */
+
+G_BEGIN_DECLS
+
+typedef struct _LocationFenceSet LocationFenceSet;
+typedef struct _LocationFenceSubscription LocationFenceSubscription;
+
+/* Called before a boundary of the set is freed */
+typedef void (*LocationFenceRemovedFunc) (LocationBoundary *boundary, gpointer user_data);
+
+/* The functions below take this lock, which is recursive. The caller holds it to keep a looked up set,
+ * the index of a set or the boundaries reported by an update valid until it is done with them */
+void fence_set_lock (void);
+void fence_set_unlock (void);
+
+/* Fence sets are looked up by handle, 0 is never a valid one */
+guint fence_set_new (void);
+int fence_set_free (guint handle);
+LocationFenceSet *fence_set_lookup (guint handle);
+int fence_set_add (LocationFenceSet *set, GList *boundary_list);
+int fence_set_remove (LocationFenceSet *set, const LocationBoundary *boundary);
+guint fence_set_size (const LocationFenceSet *set);
+/* The index is only read by the evaluation, so it can be queried from several threads while the lock is held */
+const LocationBoundaryIndex *fence_set_get_index (const LocationFenceSet *set);
+
+/* A subscription keeps the zone state of one LocationObject on a fence set and holds a reference to the set */
+LocationFenceSubscription *fence_set_subscribe (LocationFenceSet *set);
+void fence_set_unsubscribe (LocationFenceSubscription *subscription);
+guint fence_subscription_get_handle (const LocationFenceSubscription *subscription);
+void fence_subscription_set_removed_func (LocationFenceSubscription *subscription, LocationFenceRemovedFunc func, gpointer user_data);
+
+/* The fence set is evaluated once per position for all of its subscribers.
+ * The boundaries whose state changed for this subscriber are prepended to entered and left. Returns TRUE if any contains the position. */
+gboolean fence_subscription_update_zone (LocationFenceSubscription *subscription, const LocationPosition *position, GList **entered, GList **left);
+/* Same as boundary_index_get_clearance() on the fence set, G_MAXDOUBLE if the set is empty */
+gdouble fence_subscription_get_clearance (const LocationFenceSubscription *subscription, const LocationPosition *position);
+
+G_END_DECLS
+
+#endif
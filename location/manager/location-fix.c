@@ -0,0 +1,250 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "location.h"
+#include "location-fix.h"
+#include "location-snapshot.h"
+#include "location-log.h"
+
+/* The satellite details follow the fix and its reference count in the same block */
+typedef struct {
+	LocationFix fix;
+	volatile gint ref_count;
+	guint sat_capacity;
+	LocationSatelliteDetail sat_inview[];
+} FixSnapshot;
+
+#define FIX_SNAPSHOT_SIZE(capacity)	(sizeof (FixSnapshot) + (capacity) * sizeof (LocationSatelliteDetail))
+
+GType
+location_fix_get_type (void)
+{
+	static volatile gsize type_volatile = 0;
+	if(g_once_init_enter(&type_volatile)) {
+		GType type = g_boxed_type_register_static (
+			g_intern_static_string ("LocationFix"),
+			(GBoxedCopyFunc) location_fix_ref,
+			(GBoxedFreeFunc) location_fix_free);
+		g_once_init_leave(&type_volatile, type);
+	}
+	return type_volatile;
+}
+
+static LocationFix *
+_fix_new (guint sat_capacity)
+{
+	FixSnapshot *snapshot = NULL;
+
+	if (sat_capacity < LOCATION_SATELLITE_MAX_INVIEW) sat_capacity = LOCATION_SATELLITE_MAX_INVIEW;
+	snapshot = g_slice_alloc0 (FIX_SNAPSHOT_SIZE(sat_capacity));
+	snapshot->ref_count = 1;
+	snapshot->sat_capacity = sat_capacity;
+	snapshot->fix.satellite.sat_inview = snapshot->sat_inview;
+	return &snapshot->fix;
+}
+
+static void
+_fix_set_satellite (LocationFix *fix, const LocationSatellite *satellite)
+{
+	LocationSatelliteDetail *sat_inview = fix->satellite.sat_inview;
+
+	fix->satellite = *satellite;
+	fix->satellite.sat_inview = sat_inview;
+	if (satellite->num_of_sat_inview && satellite->sat_inview)
+		memcpy (sat_inview, satellite->sat_inview, satellite->num_of_sat_inview * sizeof (LocationSatelliteDetail));
+	else
+		fix->satellite.num_of_sat_inview = 0;
+}
+
+static LocationFix *
+_fix_copy (const LocationFix *fix, guint sat_capacity)
+{
+	LocationFix *fix_dup = _fix_new (sat_capacity);
+	fix_dup->timestamp = fix->timestamp;
+	fix_dup->fields = fix->fields;
+	fix_dup->monotonic_time = fix->monotonic_time;
+	fix_dup->position = fix->position;
+	fix_dup->velocity = fix->velocity;
+	fix_dup->accuracy = fix->accuracy;
+	_fix_set_satellite (fix_dup, &fix->satellite);
+	return fix_dup;
+}
+
+EXPORT_API LocationFix *
+location_fix_new (void)
+{
+	return _fix_new (0);
+}
+
+EXPORT_API void
+location_fix_free (LocationFix *fix)
+{
+	g_return_if_fail(fix);
+
+	FixSnapshot *snapshot = (FixSnapshot *) fix;
+	if (g_atomic_int_dec_and_test(&snapshot->ref_count))
+		g_slice_free1 (FIX_SNAPSHOT_SIZE(snapshot->sat_capacity), snapshot);
+}
+
+EXPORT_API LocationFix *
+location_fix_ref (LocationFix *fix)
+{
+	g_return_val_if_fail(fix, NULL);
+
+	g_atomic_int_inc(&((FixSnapshot *) fix)->ref_count);
+	return fix;
+}
+
+EXPORT_API LocationFix *
+location_fix_copy (const LocationFix *fix)
+{
+	g_return_val_if_fail(fix, NULL);
+
+	return _fix_copy (fix, fix->satellite.num_of_sat_inview);
+}
+
+gboolean
+fix_snapshot_starts_epoch (const LocationFix *fix,
+	const LocationPosition *position,
+	const LocationVelocity *velocity)
+{
+	g_return_val_if_fail(fix, FALSE);
+
+	guint timestamp = position ? position->timestamp : (velocity ? velocity->timestamp : 0);
+
+	if (!timestamp) return FALSE;
+	/* Several epochs of a high rate receiver share the same second, a part received again starts the next one */
+	return timestamp != fix->timestamp ||
+		(position && (fix->fields & LOCATION_FIX_POSITION)) ||
+		(velocity && (fix->fields & LOCATION_FIX_VELOCITY));
+}
+
+void
+fix_snapshot_update (LocationFix **snapshot,
+	const LocationPosition *position,
+	const LocationVelocity *velocity,
+	const LocationAccuracy *accuracy,
+	const LocationSatellite *satellite,
+	gint64 received_time)
+{
+	g_return_if_fail(snapshot);
+
+	FixSnapshot *current = (FixSnapshot *) *snapshot;
+	LocationFix *fix = *snapshot;
+	guint num_of_sat_inview = satellite ? satellite->num_of_sat_inview : 0;
+
+	/* Written in place while nobody else holds it and the satellites fit, replaced otherwise */
+	if (!current || g_atomic_int_get(&current->ref_count) != 1 || num_of_sat_inview > current->sat_capacity) {
+		if (current) {
+			fix = _fix_copy (*snapshot, MAX(num_of_sat_inview, current->sat_capacity));
+			location_fix_free (*snapshot);
+		}
+		else {
+			fix = _fix_new (num_of_sat_inview);
+		}
+		*snapshot = fix;
+	}
+
+	/* The satellites are kept until the next report */
+	if (fix_snapshot_starts_epoch (fix, position, velocity)) {
+		fix->timestamp = position ? position->timestamp : velocity->timestamp;
+		fix->monotonic_time = received_time;
+		fix->fields &= LOCATION_FIX_SATELLITE;
+	}
+
+	if (position) {
+		fix->position = *position;
+		fix->fields |= LOCATION_FIX_POSITION;
+	}
+	if (velocity) {
+		fix->velocity = *velocity;
+		fix->fields |= LOCATION_FIX_VELOCITY;
+	}
+	if (accuracy) {
+		fix->accuracy = *accuracy;
+		fix->fields |= LOCATION_FIX_ACCURACY;
+	}
+	if (satellite) {
+		_fix_set_satellite (fix, satellite);
+		fix->fields |= LOCATION_FIX_SATELLITE;
+	}
+}
+
+void
+latest_fix_update (LatestFix *latest,
+	const LocationPosition *position,
+	const LocationVelocity *velocity,
+	const LocationAccuracy *accuracy)
+{
+	g_return_if_fail(latest);
+
+	/* Both increments are full barriers, the parts are written while the sequence is odd */
+	g_atomic_int_inc (&latest->sequence);
+	if (position) {
+		latest->position = *position;
+		latest->fields |= LOCATION_FIX_POSITION;
+	}
+	if (velocity) {
+		latest->velocity = *velocity;
+		latest->fields |= LOCATION_FIX_VELOCITY;
+	}
+	if (accuracy) {
+		latest->accuracy = *accuracy;
+		latest->fields |= LOCATION_FIX_ACCURACY;
+	}
+	g_atomic_int_inc (&latest->sequence);
+}
+
+int
+latest_fix_get (const LatestFix *latest,
+	guint fields,
+	LocationPosition *position,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail(latest, LOCATION_ERROR_PARAMETER);
+
+	gint sequence = 0;
+	guint latest_fields = 0;
+
+	/* Copied again if a write went on meanwhile, a torn copy is never returned */
+	do {
+		while ((sequence = g_atomic_int_get (&latest->sequence)) & 1)
+			g_thread_yield ();
+
+		latest_fields = latest->fields;
+		if (position) *position = latest->position;
+		if (velocity) *velocity = latest->velocity;
+		if (accuracy) *accuracy = latest->accuracy;
+
+		/* The copies must be done before the sequence is read again */
+		__sync_synchronize ();
+	} while (g_atomic_int_get (&latest->sequence) != sequence);
+
+	if (!(latest_fields & fields)) return LOCATION_ERROR_NOT_AVAILABLE;
+	return LOCATION_ERROR_NONE;
+}
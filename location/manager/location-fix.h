@@ -0,0 +1,123 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_FIX_H_
+#define __LOCATION_FIX_H_
+
+#include <location-types.h>
+#include <location-position.h>
+#include <location-velocity.h>
+#include <location-accuracy.h>
+#include <location-satellite.h>
+
+G_BEGIN_DECLS
+
+GType location_fix_get_type (void);
+#define LOCATION_TYPE_FIX (location_fix_get_type ())
+
+/**
+ * @file location-fix.h
+ * @brief This file contains the definitions and structures related to the fix of one epoch.
+ */
+/**
+ * @addtogroup LocationAPI
+ * @{
+ * @defgroup LocationAPIFix Location Fix
+ * @breif This provides APIs related to Location Fix
+ * @addtogroup LocationAPIFix
+ * @{
+ */
+
+/**
+ * @brief This represents the parts of a #LocationFix which were received.
+ */
+typedef enum
+{
+	LOCATION_FIX_POSITION = 1 << 0,		///< The position of the epoch is set.
+	LOCATION_FIX_VELOCITY = 1 << 1,		///< The velocity of the epoch is set.
+	LOCATION_FIX_ACCURACY = 1 << 2,		///< The accuracy of the epoch is set.
+	LOCATION_FIX_SATELLITE = 1 << 3		///< The satellites last reported are set, they may be older than the epoch.
+} LocationFixField;
+
+/**
+ * @brief This represents the position, velocity, accuracy and satellites of one epoch in a single record.
+ */
+struct _LocationFix
+{
+	guint timestamp;		///< Time stamp of the epoch.
+	guint fields;			///< The #LocationFixField which are set.
+	gint64 monotonic_time;		///< Monotonic time in milliseconds when the first part of the epoch was received.
+	LocationPosition position;	///< Position of the epoch.
+	LocationVelocity velocity;	///< Velocity of the epoch.
+	LocationAccuracy accuracy;	///< Accuracy of the epoch.
+	LocationSatellite satellite;	///< Satellites in view, their details are stored in the same allocation.
+};
+
+/**
+ * @brief   Create a new #LocationFix with no part set.
+ * @remarks None.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @return a new #LocationFix
+ * @retval NULL if error occured
+ */
+LocationFix *location_fix_new (void);
+
+/**
+ * @brief   Takes a reference to a #LocationFix.
+ * @remarks A fix given by #location_get_fix or by a FIX_UPDATED signal is shared with the object and must not be modified.
+ *          Its members are part of the fix, they must not be freed nor referenced on their own.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  fix - a #LocationFix
+ * @return the same #LocationFix
+ * @retval NULL if error occured
+ */
+LocationFix *location_fix_ref (LocationFix *fix);
+
+/**
+ * @brief   Release a #LocationFix.
+ * @remarks It is freed when the last reference to it is released.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in] fix - a #LocationFix.
+ * @return None.
+ */
+void location_fix_free (LocationFix *fix);
+
+/**
+ * @brief   Makes a copy of #LocationFix
+ * @remarks The copy is a single allocation as well, with its own satellite details.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  fix - a #LocationFix
+ * @return a new #LocationFix
+ * @retval NULL if error occured
+ */
+LocationFix *location_fix_copy (const LocationFix *fix);
+
+/**
+ * @} @}
+ */
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,426 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include "location-geodesic.h"
+#include "location-log.h"
+
+#if defined(__AVX__)
+#define GEODESIC_LANES	4
+#elif defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+#define GEODESIC_LANES	2
+#else
+#define GEODESIC_LANES	1
+#endif
+
+#define GEODESIC_ITER_LIMIT	100
+#define GEODESIC_EPSILON	1e-12
+#define DEG2RAD(x)	((x) * M_PI / 180)
+
+int
+geodesic_vincenty (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2, gdouble *distance)
+{
+	const double a = GEODESIC_WGS84_A, b = GEODESIC_WGS84_B, f = GEODESIC_WGS84_F;
+	double delta_lon = DEG2RAD(longitude2 - longitude1);
+	double u_1 = atan((1-f) * tan(DEG2RAD(latitude1)));
+	double u_2 = atan((1-f) * tan(DEG2RAD(latitude2)));
+
+	double lambdaP, iter_limit = GEODESIC_ITER_LIMIT;
+	double lambda = delta_lon;
+
+	double sin_sigma, sin_alpha, cos_sigma, sigma,  sq_cos_alpha, cos_2sigma, C;
+	double sq_u, cal1, cal2, delta_sigma;
+	double sin_lambda, cos_lambda;
+
+	double sin_u1 = sin(u_1);
+	double cos_u1 = cos(u_1);
+	double sin_u2 = sin(u_2);
+	double cos_u2 = cos(u_2);
+
+	*distance = 0;
+
+	do {
+		sin_lambda = sin(lambda);
+		cos_lambda = cos(lambda);
+
+		sin_sigma = sqrt((cos_u2*sin_lambda)*(cos_u2*sin_lambda) + \
+			(cos_u1*sin_u2-sin_u1*cos_u2*cos_lambda) * \
+			(cos_u1*sin_u2-sin_u1*cos_u2*cos_lambda));
+
+		if (sin_sigma ==0)
+			return LOCATION_ERROR_NONE;  // co-incident points
+
+		cos_sigma = sin_u1*sin_u2 + cos_u1*cos_u2*cos_lambda;
+		sigma = atan2(sin_sigma, cos_sigma);
+
+		sin_alpha = cos_u1 * cos_u2 * sin_lambda / sin_sigma;
+		sq_cos_alpha = 1.0 - sin_alpha*sin_alpha;
+		cos_2sigma = cos_sigma - 2.0*sin_u1*sin_u2/sq_cos_alpha;
+
+		if (isnan(cos_2sigma))
+			cos_2sigma = 0;
+
+		C = f/16.0*sq_cos_alpha*(4.0+f*(4.0-3.0*sq_cos_alpha));
+
+		lambdaP = lambda;
+		lambda = delta_lon + (1.0-C) * f * sin_alpha * \
+			 (sigma + C*sin_sigma*(cos_2sigma+C*cos_sigma*(-1.0+2.0*cos_2sigma*cos_2sigma)));
+
+	} while (fabs(lambda-lambdaP) > GEODESIC_EPSILON && --iter_limit>0);
+
+	if (iter_limit==0) return LOCATION_ERROR_UNKNOWN;
+
+	sq_u = sq_cos_alpha * (a*a - b*b) / (b*b);
+
+	cal1 = 1.0 + sq_u/16384.0*(4096.0+sq_u*(-768.0+sq_u*(320.0-175.0*sq_u)));
+	cal2 = sq_u/1024.0 * (256.0+sq_u*(-128.0+sq_u*(74.0-47.0*sq_u)));
+
+	delta_sigma = cal2*sin_sigma*(cos_2sigma+cal2/4.0*(cos_sigma*(-1.0+2.0*cos_2sigma*cos_2sigma)- \
+				cal2/6.0*cos_2sigma*(-3.0+4.0*sin_sigma*sin_sigma)*(-3.0+4.0*cos_2sigma*cos_2sigma)));
+	*distance = b*cal1*(sigma-delta_sigma);
+
+	return LOCATION_ERROR_NONE;
+}
+
+void
+geodesic_to_ecef (gdouble latitude, gdouble longitude, gdouble altitude, gdouble *ecef)
+{
+	const gdouble a = GEODESIC_WGS84_A, f = GEODESIC_WGS84_F;
+	const gdouble e2 = f * (2 - f);
+	gdouble sin_lat = sin(DEG2RAD(latitude)), cos_lat = cos(DEG2RAD(latitude));
+	gdouble n = a / sqrt(1 - e2 * sin_lat * sin_lat);
+
+	ecef[0] = (n + altitude) * cos_lat * cos(DEG2RAD(longitude));
+	ecef[1] = (n + altitude) * cos_lat * sin(DEG2RAD(longitude));
+	ecef[2] = (n * (1 - e2) + altitude) * sin_lat;
+}
+
+void
+geodesic_plane_init (GeodesicPlane *plane, gdouble latitude, gdouble longitude, gdouble altitude)
+{
+	plane->latitude = latitude;
+	plane->longitude = longitude;
+	plane->altitude = altitude;
+	plane->sin_lat = sin(DEG2RAD(latitude));
+	plane->cos_lat = cos(DEG2RAD(latitude));
+	plane->sin_lon = sin(DEG2RAD(longitude));
+	plane->cos_lon = cos(DEG2RAD(longitude));
+	geodesic_to_ecef(latitude, longitude, altitude, plane->ecef);
+}
+
+void
+geodesic_plane_forward (const GeodesicPlane *plane, gdouble latitude, gdouble longitude, gdouble altitude, gdouble *enu)
+{
+	gdouble ecef[3];
+	gdouble dx, dy, dz, t;
+
+	geodesic_to_ecef(latitude, longitude, altitude, ecef);
+	dx = ecef[0] - plane->ecef[0];
+	dy = ecef[1] - plane->ecef[1];
+	dz = ecef[2] - plane->ecef[2];
+
+	t = plane->cos_lon * dx + plane->sin_lon * dy;
+	enu[0] = plane->cos_lon * dy - plane->sin_lon * dx;
+	enu[1] = plane->cos_lat * dz - plane->sin_lat * t;
+	enu[2] = plane->cos_lat * t + plane->sin_lat * dz;
+}
+
+void
+geodesic_plane_inverse (const GeodesicPlane *plane, const gdouble *enu, gdouble *latitude, gdouble *longitude, gdouble *altitude)
+{
+	const gdouble a = GEODESIC_WGS84_A, f = GEODESIC_WGS84_F;
+	const gdouble e2 = f * (2 - f);
+	gdouble t = plane->cos_lat * enu[2] - plane->sin_lat * enu[1];
+	gdouble x = plane->ecef[0] + plane->cos_lon * t - plane->sin_lon * enu[0];
+	gdouble y = plane->ecef[1] + plane->sin_lon * t + plane->cos_lon * enu[0];
+	gdouble z = plane->ecef[2] + plane->sin_lat * enu[2] + plane->cos_lat * enu[1];
+	gdouble p = hypot(x, y);
+	gdouble lat = atan2(z, p * (1 - e2));
+	gdouble sin_lat, n;
+	int i;
+
+	/* Fixed point on the latitude, below a micrometer after three steps near the surface */
+	for (i = 0; i < 4; i++) {
+		sin_lat = sin(lat);
+		n = a / sqrt(1 - e2 * sin_lat * sin_lat);
+		lat = atan2(z + e2 * n * sin_lat, p);
+	}
+	sin_lat = sin(lat);
+	n = a / sqrt(1 - e2 * sin_lat * sin_lat);
+
+	*latitude = lat * 180 / M_PI;
+	*longitude = atan2(y, x) * 180 / M_PI;
+	/* Stable at the poles, unlike p / cos(lat) - n */
+	*altitude = p * cos(lat) + z * sin_lat - a * a / n;
+}
+
+gdouble
+geodesic_equirectangular (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2)
+{
+	const gdouble a = GEODESIC_WGS84_A, f = GEODESIC_WGS84_F;
+	const gdouble e2 = f * (2 - f);
+	gdouble mid = DEG2RAD((latitude1 + latitude2) / 2);
+	gdouble w = sqrt(1 - e2 * sin(mid) * sin(mid));
+	gdouble delta_lon = remainder(longitude2 - longitude1, 360.0);
+
+	/* Meridian and prime vertical radii of curvature at the middle latitude */
+	return hypot(DEG2RAD(latitude2 - latitude1) * a * (1 - e2) / (w * w * w), DEG2RAD(delta_lon) * a / w * cos(mid));
+}
+
+gdouble
+geodesic_haversine (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2)
+{
+	gdouble sin_lat = sin(DEG2RAD(latitude2 - latitude1) / 2);
+	gdouble sin_lon = sin(DEG2RAD(longitude2 - longitude1) / 2);
+	gdouble h = sin_lat * sin_lat + cos(DEG2RAD(latitude1)) * cos(DEG2RAD(latitude2)) * sin_lon * sin_lon;
+
+	return 2 * GEODESIC_MEAN_RADIUS * asin(MIN(sqrt(h), 1.0));
+}
+
+gboolean
+geodesic_within_radius (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2, gdouble radius)
+{
+	gdouble distance = 0.0;
+	gdouble exact = 0.0;
+
+	/* No path between two parallels is shorter than the meridian arc, and a degree of it is at least METERS_PER_DEGREE_MIN */
+	if (fabs(latitude2 - latitude1) * GEODESIC_METERS_PER_DEGREE_MIN >= radius) return FALSE;
+
+	if (fabs(latitude1) <= GEODESIC_EQUIRECTANGULAR_MAX_LATITUDE && fabs(latitude2) <= GEODESIC_EQUIRECTANGULAR_MAX_LATITUDE) {
+		distance = geodesic_equirectangular(latitude1, longitude1, latitude2, longitude2);
+		if (distance <= GEODESIC_EQUIRECTANGULAR_MAX_DISTANCE) {
+			if (distance * (1 + GEODESIC_EQUIRECTANGULAR_ERROR) < radius) return TRUE;
+			if (distance * (1 - GEODESIC_EQUIRECTANGULAR_ERROR) >= radius) return FALSE;
+		}
+	}
+
+	distance = geodesic_haversine(latitude1, longitude1, latitude2, longitude2);
+	if (distance * (1 + GEODESIC_HAVERSINE_ERROR) < radius) return TRUE;
+	if (distance * (1 - GEODESIC_HAVERSINE_ERROR) >= radius) return FALSE;
+
+	/* Within the haversine error of the radius, nearly antipodal points keep the haversine answer */
+	if (geodesic_vincenty(latitude1, longitude1, latitude2, longitude2, &exact) != LOCATION_ERROR_NONE) return distance < radius;
+	return exact < radius;
+}
+
+/*
+ * The batch kernel runs the same iteration on GEODESIC_LANES positions at a time with the compiler vector
+ * extensions, so one body is lowered to AVX, SSE2, NEON or plain scalar code. libm has no vector sin, cos
+ * and atan2, so they are the Cephes polynomials below, accurate to about 1 ulp in the ranges Vincenty uses.
+ * A lane which has converged keeps its terms while the others iterate on.
+ */
+typedef gdouble GeoVec __attribute__ ((vector_size (GEODESIC_LANES * sizeof (gdouble))));
+typedef __typeof__ ((GeoVec) {0} < (GeoVec) {0}) GeoMask;
+
+/* pi/2 in three parts for the exact reduction k*pi/2 */
+#define PIO2_1		1.57079625129699707031E0
+#define PIO2_2		7.54978941586159635336E-8
+#define PIO2_3		5.39030285815811905290E-15
+/* Adding and subtracting 1.5 * 2^52 rounds to the nearest integer */
+#define ROUND_MAGIC	6755399441055744.0
+/* tan(3*pi/8) and the low bits of pi/2 for atan */
+#define T3P8		2.41421356237309504880
+#define MOREBITS	6.123233995736765886130E-17
+
+static inline GeoVec
+_splat (gdouble value)
+{
+	return (GeoVec) {0} + value;
+}
+
+static inline GeoVec
+_select (GeoMask mask, GeoVec if_true, GeoVec if_false)
+{
+	return (GeoVec) (((GeoMask) if_true & mask) | ((GeoMask) if_false & ~mask));
+}
+
+static inline GeoVec
+_sqrt (GeoVec x)
+{
+	guint l;
+	GeoVec r;
+
+	for (l = 0; l < GEODESIC_LANES; l++) r[l] = sqrt(x[l]);
+	return r;
+}
+
+static inline gboolean
+_any (GeoMask mask)
+{
+	guint l;
+
+	for (l = 0; l < GEODESIC_LANES; l++) {
+		if (mask[l]) return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+_sincos (GeoVec x, GeoVec *sin_x, GeoVec *cos_x)
+{
+	GeoVec k = (x * M_2_PI + ROUND_MAGIC) - ROUND_MAGIC;
+	GeoVec r = ((x - k * PIO2_1) - k * PIO2_2) - k * PIO2_3;
+	GeoVec z = r * r;
+	GeoMask q = __builtin_convertvector (k, GeoMask) & 3;
+	GeoVec s, c;
+
+	s = r + r * z * (((((1.58962301576546568060E-10 * z - 2.50507477628578072866E-8) * z
+		+ 2.75573136213857245213E-6) * z - 1.98412698295895385996E-4) * z
+		+ 8.33333333332211858878E-3) * z - 1.66666666666666307295E-1);
+	c = 1.0 - 0.5 * z + z * z * (((((-1.13585365213876817300E-11 * z + 2.08757008419747316778E-9) * z
+		- 2.75573141792967388112E-7) * z + 2.48015872888517045348E-5) * z
+		- 1.38888888888730564116E-3) * z + 4.16666666666665929218E-2);
+
+	/* Quadrant k mod 4: odd ones swap sin and cos, 2 and 3 negate sin, 1 and 2 negate cos */
+	*sin_x = _select((q & 1) != 0, c, s);
+	*cos_x = _select((q & 1) != 0, s, c);
+	*sin_x = _select((q & 2) != 0, -*sin_x, *sin_x);
+	*cos_x = _select(((q + 1) & 2) != 0, -*cos_x, *cos_x);
+}
+
+/* atan2 for y >= 0, which holds for sin(sigma) */
+static GeoVec
+_atan2 (GeoVec y, GeoVec x)
+{
+	GeoMask negative = x < 0;
+	GeoVec t = y / _select(negative, -x, x);
+	GeoMask big = t > T3P8;
+	GeoMask mid = (t > 0.66) & ~big;
+	GeoVec base = _select(big, _splat(M_PI_2), _select(mid, _splat(M_PI_4), _splat(0)));
+	GeoVec more = _select(big, _splat(MOREBITS), _select(mid, _splat(0.5 * MOREBITS), _splat(0)));
+	GeoVec z, p, d, a;
+
+	t = _select(big, -1.0 / t, _select(mid, (t - 1.0) / (t + 1.0), t));
+	z = t * t;
+	p = (((-8.750608600031904122785E-1 * z - 1.615753718733365076637E1) * z
+		- 7.500855792314704667340E1) * z - 1.228866684490136173410E2) * z - 6.485021904942025371773E1;
+	d = ((((z + 2.485846490142306297962E1) * z + 1.650270098316988542046E2) * z
+		+ 4.328810604912902668951E2) * z + 4.853903996359136964868E2) * z + 1.945506571482613964425E2;
+	a = base + ((t * z * p / d + t) + more);
+
+	return _select(negative, M_PI - a, a);
+}
+
+int
+geodesic_vincenty_batch (gdouble latitude, gdouble longitude, const LocationPosition *positions, guint count, gdouble *distances)
+{
+	g_return_val_if_fail(positions, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(distances, LOCATION_ERROR_PARAMETER);
+
+	const gdouble a = GEODESIC_WGS84_A, b = GEODESIC_WGS84_B, f = GEODESIC_WGS84_F;
+	int ret = LOCATION_ERROR_NONE;
+	guint i, l, n;
+
+	/* Terms of the reference shared by every lane */
+	gdouble tan_u1 = (1-f) * tan(DEG2RAD(latitude));
+	gdouble cos_u1 = 1.0 / sqrt(1.0 + tan_u1 * tan_u1);
+	gdouble sin_u1 = tan_u1 * cos_u1;
+
+	for (i = 0; i < count; i += GEODESIC_LANES) {
+		GeoVec lat2, delta_lon;
+		GeoVec sin_phi2, cos_phi2, sin_u2, cos_u2, norm;
+		GeoVec lambda, sin_lambda, cos_lambda, t1, t2, next;
+		GeoVec sin_sigma, cos_sigma, sigma, sin_alpha, sq_cos_alpha, cos_2sigma, C;
+		GeoVec r_sin_sigma, r_cos_sigma, r_sigma, r_sq_cos_alpha, r_cos_2sigma;
+		GeoVec sq_u, cal1, cal2, delta_sigma, dist;
+		GeoMask active, coincident, done;
+		guint iter = 0;
+
+		/* The tail is padded with the reference itself, which converges at once */
+		n = MIN(GEODESIC_LANES, count - i);
+		lat2 = _splat(latitude);
+		delta_lon = _splat(0);
+		for (l = 0; l < n; l++) {
+			lat2[l] = positions[i + l].latitude;
+			delta_lon[l] = positions[i + l].longitude - longitude;
+		}
+		lat2 = lat2 * (M_PI / 180);
+		delta_lon = delta_lon * (M_PI / 180);
+
+		/* sin and cos of atan((1-f) * tan(phi2)) without the atan */
+		_sincos(lat2, &sin_phi2, &cos_phi2);
+		sin_phi2 = (1-f) * sin_phi2;
+		norm = 1.0 / _sqrt(sin_phi2 * sin_phi2 + cos_phi2 * cos_phi2);
+		sin_u2 = sin_phi2 * norm;
+		cos_u2 = cos_phi2 * norm;
+
+		lambda = delta_lon;
+		active = _splat(0) == _splat(0);
+		r_sin_sigma = r_cos_sigma = r_sigma = r_sq_cos_alpha = r_cos_2sigma = _splat(0);
+
+		while (_any(active) && iter++ < GEODESIC_ITER_LIMIT) {
+			_sincos(lambda, &sin_lambda, &cos_lambda);
+
+			t1 = cos_u2 * sin_lambda;
+			t2 = cos_u1 * sin_u2 - sin_u1 * cos_u2 * cos_lambda;
+			sin_sigma = _sqrt(t1 * t1 + t2 * t2);
+			coincident = sin_sigma == 0;
+
+			cos_sigma = sin_u1 * sin_u2 + cos_u1 * cos_u2 * cos_lambda;
+			sigma = _atan2(sin_sigma, cos_sigma);
+
+			sin_alpha = cos_u1 * cos_u2 * sin_lambda / _select(coincident, _splat(1), sin_sigma);
+			sq_cos_alpha = 1.0 - sin_alpha * sin_alpha;
+			/* Both points on the equator */
+			cos_2sigma = _select(sq_cos_alpha == 0, _splat(0),
+				cos_sigma - 2.0 * sin_u1 * sin_u2 / _select(sq_cos_alpha == 0, _splat(1), sq_cos_alpha));
+
+			C = f / 16.0 * sq_cos_alpha * (4.0 + f * (4.0 - 3.0 * sq_cos_alpha));
+			next = delta_lon + (1.0 - C) * f * sin_alpha *
+				(sigma + C * sin_sigma * (cos_2sigma + C * cos_sigma * (-1.0 + 2.0 * cos_2sigma * cos_2sigma)));
+
+			r_sin_sigma = _select(active, sin_sigma, r_sin_sigma);
+			r_cos_sigma = _select(active, cos_sigma, r_cos_sigma);
+			r_sigma = _select(active, sigma, r_sigma);
+			r_sq_cos_alpha = _select(active, sq_cos_alpha, r_sq_cos_alpha);
+			r_cos_2sigma = _select(active, cos_2sigma, r_cos_2sigma);
+
+			done = coincident | (_select(next < lambda, lambda - next, next - lambda) <= GEODESIC_EPSILON);
+			lambda = _select(active, next, lambda);
+			active &= ~done;
+		}
+
+		sq_u = r_sq_cos_alpha * ((a*a - b*b) / (b*b));
+		cal1 = 1.0 + sq_u / 16384.0 * (4096.0 + sq_u * (-768.0 + sq_u * (320.0 - 175.0 * sq_u)));
+		cal2 = sq_u / 1024.0 * (256.0 + sq_u * (-128.0 + sq_u * (74.0 - 47.0 * sq_u)));
+		delta_sigma = cal2 * r_sin_sigma * (r_cos_2sigma + cal2 / 4.0 * (r_cos_sigma * (-1.0 + 2.0 * r_cos_2sigma * r_cos_2sigma) -
+				cal2 / 6.0 * r_cos_2sigma * (-3.0 + 4.0 * r_sin_sigma * r_sin_sigma) * (-3.0 + 4.0 * r_cos_2sigma * r_cos_2sigma)));
+		dist = b * cal1 * (r_sigma - delta_sigma);
+		dist = _select(r_sin_sigma == 0, _splat(0), dist);
+
+		for (l = 0; l < n; l++) {
+			if (active[l]) {
+				distances[i + l] = NAN;
+				ret = LOCATION_ERROR_UNKNOWN;
+			} else {
+				distances[i + l] = dist[l];
+			}
+		}
+	}
+
+	if (ret != LOCATION_ERROR_NONE) LOCATION_LOGD("Distance did not converge for some positions");
+
+	return ret;
+}
@@ -0,0 +1,87 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_GEODESIC_H__
+#define __LOCATION_GEODESIC_H__
+
+#include <glib.h>
+#include <location-position.h>
+
+/**
+ * @file location-geodesic.h
+ * @brief This file contains the distance kernels on the WGS84 ellipsoid shared by the position and boundary code.
+ */
+
+G_BEGIN_DECLS
+
+#define GEODESIC_WGS84_A	6378137.0
+#define GEODESIC_WGS84_B	6356752.314245
+#define GEODESIC_WGS84_F	(1/298.257223563)
+/* (2a + b) / 3, the sphere of the haversine */
+#define GEODESIC_MEAN_RADIUS	6371008.771415
+/* Length of a degree of the meridian at the equator, the shortest one */
+#define GEODESIC_METERS_PER_DEGREE_MIN	110574.0
+
+/* Worst relative errors against Vincenty. The equirectangular one only holds up to the distance and latitude below. */
+#define GEODESIC_EQUIRECTANGULAR_ERROR	5e-4
+#define GEODESIC_EQUIRECTANGULAR_MAX_DISTANCE	100000.0
+#define GEODESIC_EQUIRECTANGULAR_MAX_LATITUDE	80.0
+#define GEODESIC_HAVERSINE_ERROR	6e-3
+
+/* Earth-centered, earth-fixed x, y and z in meters */
+void geodesic_to_ecef (gdouble latitude, gdouble longitude, gdouble altitude, gdouble *ecef);
+
+/* East, north, up frame tangent to the ellipsoid at an anchor */
+typedef struct {
+	gdouble latitude;
+	gdouble longitude;
+	gdouble altitude;
+	gdouble ecef[3];
+	gdouble sin_lat, cos_lat;
+	gdouble sin_lon, cos_lon;
+} GeodesicPlane;
+
+/* Relative error of a distance on east and north between positions within range of the anchor, measured against Vincenty */
+#define GEODESIC_PLANE_ERROR(range)	(0.6 * ((range) / GEODESIC_MEAN_RADIUS) * ((range) / GEODESIC_MEAN_RADIUS))
+
+void geodesic_plane_init (GeodesicPlane *plane, gdouble latitude, gdouble longitude, gdouble altitude);
+void geodesic_plane_forward (const GeodesicPlane *plane, gdouble latitude, gdouble longitude, gdouble altitude, gdouble *enu);
+void geodesic_plane_inverse (const GeodesicPlane *plane, const gdouble *enu, gdouble *latitude, gdouble *longitude, gdouble *altitude);
+
+/* Flat approximation with the radii of curvature of the ellipsoid at the middle latitude */
+gdouble geodesic_equirectangular (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2);
+
+/* Great circle distance on the sphere of mean radius */
+gdouble geodesic_haversine (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2);
+
+/* Whether the distance is below the radius, with the cheapest of the three which decides it beyond its error */
+gboolean geodesic_within_radius (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2, gdouble radius);
+
+/* Vincenty inverse distance in meters, LOCATION_ERROR_UNKNOWN when the iteration does not converge (nearly antipodal points) */
+int geodesic_vincenty (gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2, gdouble *distance);
+
+/* Same distance from one reference to count positions, a lane per position.
+ * Distances of positions which do not converge are NAN and LOCATION_ERROR_UNKNOWN is returned, the others are still set. */
+int geodesic_vincenty_batch (gdouble latitude, gdouble longitude, const LocationPosition *positions, guint count, gdouble *distances);
+
+G_END_DECLS
+
+#endif
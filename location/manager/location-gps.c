@@ -33,6 +33,9 @@
 #include "location-ielement.h"
 #include "location-signaling-util.h"
 #include "location-common-util.h"
+#include "location-history.h"
+#include "location-timer-wheel.h"
+#include "location-provider-thread.h"
 
 #include <vconf-internal-location-keys.h>
 
@@ -41,22 +44,38 @@ typedef struct _LocationGpsPrivate {
 	gboolean 		is_started;
 	gboolean		set_noti;
 	gboolean 		enabled;
-	guint			pos_updated_timestamp;
-	guint 			pos_interval;
-	guint			vel_updated_timestamp;
-	guint			vel_interval;
+	gint64			pos_updated_time;
+	guint 			pos_interval_ms;
+	gint64			vel_updated_time;
+	guint			vel_interval_ms;
 	guint			sat_updated_timestamp;
+	gboolean		sat_changed;	/* since the last satellite signal */
 	guint			sat_interval;
 	LocationPosition* 	pos;
 	LocationVelocity* 	vel;
 	LocationAccuracy* 	acc;
+	LatestFix		latest;
 	GList*			boundary_list;
+	LocationBoundaryIndex*	boundary_index;
 	ZoneStatus 		zone_status;
 	LocationSatellite* 	sat;
+	LocationFix*		fix;
+	gint64			fix_updated_time;
+	gboolean		fix_updates;
+	LocationHistory* 	history;
+	LocationBatch*		batch;
+	guint			batch_size;
+	guint			batch_latency;
 
 	guint			pos_timer;
 	guint			vel_timer;
 
+	gboolean		zone_duty_cycle;
+	gboolean		zone_sleeping;	/* module stopped until no fence can be reached */
+	guint			zone_sleep_interval;
+	guint			zone_timer;
+
+	ProviderThread*		provider_thread;
 } LocationGpsPrivate;
 
 enum {
@@ -69,6 +88,19 @@ enum {
 	PROP_SAT_INTERVAL,
 	PROP_BOUNDARY,
 	PROP_REMOVAL_BOUNDARY,
+	PROP_REMOVAL_BOUNDARY_LIST,
+	PROP_BOUNDARY_STORE,
+	PROP_ZONE_CROSSING,
+	PROP_SUBSCRIBE_FENCE_SET,
+	PROP_UNSUBSCRIBE_FENCE_SET,
+	PROP_ZONE_DUTY_CYCLE,
+	PROP_FIX_UPDATES,
+	PROP_POS_INTERVAL_MS,
+	PROP_VEL_INTERVAL_MS,
+	PROP_HISTORY_SIZE,
+	PROP_BATCH_SIZE,
+	PROP_BATCH_LATENCY,
+	PROP_PROVIDER_THREAD,
 	PROP_NMEA,
 	PROP_SATELLITE,
 	PROP_MAX
@@ -80,6 +112,8 @@ static GParamSpec *properties[PROP_MAX] = {NULL, };
 #define GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), LOCATION_TYPE_GPS, LocationGpsPrivate))
 
 static void location_ielement_interface_init (LocationIElementInterface *iface);
+static gboolean _zone_sleep_cb (gpointer data);
+static gboolean _zone_wakeup_cb (gpointer data);
 
 G_DEFINE_TYPE_WITH_CODE (LocationGps, location_gps, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (LOCATION_TYPE_IELEMENT,
@@ -92,28 +126,39 @@ _position_timeout_cb (gpointer data)
 	LocationGpsPrivate *priv = GET_PRIVATE(object);
 	if (!priv) return FALSE;
 
+	/* Emitted from the provider thread, in order with the updates */
+	if (provider_thread_defer_source (object, _position_timeout_cb)) return TRUE;
+
+	/* Delivered with the batch */
+	if (priv->batch) return TRUE;
+
+	if (priv->fix_updates) {
+		fix_timeout_signaling(object, signals, priv->fix);
+		return TRUE;
+	}
+
 	LocationPosition *pos = NULL;
 	LocationAccuracy *acc = NULL;
 
 	if (priv->pos) {
-		pos = location_position_copy(priv->pos);
+		pos = position_snapshot_ref (priv->pos);
 	}
 	else {
-		pos = location_position_new (0, 0.0, 0.0, 0.0, LOCATION_STATUS_NO_FIX);
+		pos = position_snapshot_new (NULL);
 	}
 
 	if (priv->acc) {
-		acc = location_accuracy_copy (priv->acc);
+		acc = accuracy_snapshot_ref (priv->acc);
 	}
 	else {
-		acc = location_accuracy_new (LOCATION_ACCURACY_LEVEL_NONE, 0.0, 0.0);
+		acc = accuracy_snapshot_new (NULL);
 	}
 
 	LOCATION_LOGD("POSITION SERVICE_UPDATED");
-	g_signal_emit(object, signals[SERVICE_UPDATED], 0, POSITION_UPDATED, pos, acc);
+	update_signaling(object, signals, POSITION_UPDATED, pos, acc);
 
-	location_position_free (pos);
-	location_accuracy_free (acc);
+	position_snapshot_unref (pos);
+	accuracy_snapshot_unref (acc);
 
 	return TRUE;
 }
@@ -125,28 +170,37 @@ _velocity_timeout_cb (gpointer data)
 	LocationGpsPrivate *priv = GET_PRIVATE(object);
 	if (!priv) return FALSE;
 
+	/* Emitted from the provider thread, in order with the updates */
+	if (provider_thread_defer_source (object, _velocity_timeout_cb)) return TRUE;
+
+	/* Delivered with the batch */
+	if (priv->batch) return TRUE;
+
+	/* Carried by the fix of the position timer */
+	if (priv->fix_updates) return TRUE;
+
 	LocationVelocity *vel = NULL;
 	LocationAccuracy *acc = NULL;
 
 	if (priv->vel) {
-		vel = location_velocity_copy(priv->vel);
+		vel = velocity_snapshot_ref (priv->vel);
 	}
 	else {
-		vel = location_velocity_new (0, 0.0, 0.0, 0.0);
+		vel = velocity_snapshot_new (NULL);
 	}
 
 	if (priv->acc) {
-		acc = location_accuracy_copy (priv->acc);
+		acc = accuracy_snapshot_ref (priv->acc);
 	}
 	else {
-		acc = location_accuracy_new (LOCATION_ACCURACY_LEVEL_NONE, 0.0, 0.0);
+		acc = accuracy_snapshot_new (NULL);
 	}
 
 	LOCATION_LOGD("VELOCITY SERVICE_UPDATED");
-	g_signal_emit(object, signals[SERVICE_UPDATED], 0, VELOCITY_UPDATED, vel, acc);
+	update_signaling(object, signals, VELOCITY_UPDATED, vel, acc);
 
-	location_velocity_free (vel);
-	location_accuracy_free (acc);
+	velocity_snapshot_unref (vel);
+	accuracy_snapshot_unref (acc);
 
 	return TRUE;
 }
@@ -158,12 +212,15 @@ gps_status_cb (gboolean enabled,
 {
 	LOCATION_LOGD("gps_status_cb");
 	g_return_if_fail(self);
+	if (provider_thread_defer_status (self, gps_status_cb, enabled, status)) return;
 	LocationGpsPrivate* priv = GET_PRIVATE(self);
+	/* Stopped by the duty cycle, not by the device */
+	if (priv->zone_sleeping) return;
 	enable_signaling(self, signals, &(priv->enabled), enabled, status);
 
 	if (!priv->enabled) {
-		if (priv->pos_timer) g_source_remove (priv->pos_timer);
-		if (priv->vel_timer) g_source_remove (priv->vel_timer);
+		if (priv->pos_timer) timer_wheel_remove (priv->pos_timer);
+		if (priv->vel_timer) timer_wheel_remove (priv->vel_timer);
 		priv->pos_timer = 0;
 		priv->vel_timer = 0;
 	}
@@ -181,9 +238,21 @@ gps_position_cb (gboolean enabled,
 	g_return_if_fail(acc);
 	LocationGpsPrivate* priv = GET_PRIVATE(self);
 
-	enable_signaling(self, signals, &(priv->enabled), enabled, pos->status);
-	position_signaling(self, signals, &(priv->enabled), priv->pos_interval, TRUE, &(priv->pos_updated_timestamp), &(priv->pos), priv->boundary_list, &(priv->zone_status), pos, acc);
+	if (provider_thread_defer_position (self, gps_position_cb, enabled, pos, acc)) return;
+	/* Stamped on reception, the timestamp of the provider is in whole seconds */
+	gint64 received_time = provider_thread_get_received_time (self);
 
+	enable_signaling(self, signals, &(priv->enabled), enabled, pos->status);
+	position_signaling(self, signals, &(priv->enabled), priv->pos_interval_ms, !priv->fix_updates && !priv->batch, &(priv->pos_updated_time), &(priv->pos), &(priv->latest), priv->boundary_index, &(priv->zone_status), pos, acc, received_time);
+	fix_signaling(self, signals, priv->pos_interval_ms, priv->fix_updates && !priv->batch, LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, &(priv->fix_updated_time), &(priv->fix), pos, NULL, acc, NULL, received_time);
+	if (priv->history) history_append(priv->history, pos, acc, received_time);
+	if (priv->batch) batch_signaling(priv->batch, pos, acc);
+
+	if (priv->zone_duty_cycle && !priv->zone_timer) {
+		priv->zone_sleep_interval = get_zone_sleep_interval(priv->boundary_index, pos, acc, priv->vel);
+		/* The module is not stopped from its own callback */
+		if (priv->zone_sleep_interval) priv->zone_timer = g_idle_add (_zone_sleep_cb, self);
+	}
 }
 
 static void
@@ -194,8 +263,13 @@ gps_velocity_cb (gboolean enabled,
 {
 	LOCATION_LOGD("gps_velocity_cb");
 	g_return_if_fail(self);
+	g_return_if_fail(vel);
 	LocationGpsPrivate* priv = GET_PRIVATE(self);
-	velocity_signaling(self, signals, &(priv->enabled), priv->vel_interval, TRUE, &(priv->vel_updated_timestamp), &(priv->vel), &(priv->acc), vel, acc);
+
+	if (provider_thread_defer_velocity (self, gps_velocity_cb, enabled, vel, acc)) return;
+	gint64 received_time = provider_thread_get_received_time (self);
+	velocity_signaling(self, signals, &(priv->enabled), priv->vel_interval_ms, !priv->fix_updates && !priv->batch, &(priv->vel_updated_time), &(priv->vel), &(priv->acc), &(priv->latest), vel, acc, received_time);
+	fix_signaling(self, signals, priv->pos_interval_ms, priv->fix_updates && !priv->batch, LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, &(priv->fix_updated_time), &(priv->fix), NULL, vel, acc, NULL, received_time);
 }
 
 static void
@@ -205,8 +279,82 @@ gps_satellite_cb (gboolean enabled,
 {
 	LOCATION_LOGD("gps_satellite_cb");
 	g_return_if_fail(self);
+	if (provider_thread_defer_satellite (self, gps_satellite_cb, enabled, sat)) return;
 	LocationGpsPrivate* priv = GET_PRIVATE(self);
-	satellite_signaling(self, signals, &(priv->enabled), priv->sat_interval, TRUE, &(priv->sat_updated_timestamp), &(priv->sat), sat);
+	satellite_signaling(self, signals, &(priv->enabled), priv->sat_interval, !priv->fix_updates && !priv->batch, &(priv->sat_updated_timestamp), &(priv->sat_changed), &(priv->sat), sat);
+	fix_signaling(self, signals, priv->pos_interval_ms, priv->fix_updates && !priv->batch, LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, &(priv->fix_updated_time), &(priv->fix), NULL, NULL, NULL, sat, 0);
+}
+
+static gboolean
+_zone_wakeup (gpointer data)
+{
+	LocationGpsPrivate *priv = GET_PRIVATE(data);
+	g_return_val_if_fail (priv, FALSE);
+	g_return_val_if_fail (priv->mod, FALSE);
+
+	priv->zone_timer = 0;
+	priv->zone_sleeping = FALSE;
+
+	LOCATION_LOGD("gps resumed by zone duty cycle");
+	if (priv->mod->ops.start (priv->mod->handler, gps_status_cb, gps_position_cb, gps_velocity_cb, gps_satellite_cb, data) != LOCATION_ERROR_NONE) {
+		LOCATION_LOGW("Fail to resume gps");
+		priv->is_started = FALSE;
+	}
+	return FALSE;
+}
+
+static gboolean
+_zone_sleep (gpointer data)
+{
+	LocationGpsPrivate *priv = GET_PRIVATE(data);
+	g_return_val_if_fail (priv, FALSE);
+	g_return_val_if_fail (priv->mod, FALSE);
+
+	priv->zone_timer = 0;
+	if (!priv->is_started || !priv->zone_duty_cycle) return FALSE;
+
+	LOCATION_LOGD("gps paused by zone duty cycle for [%u] s", priv->zone_sleep_interval);
+	if (priv->mod->ops.stop (priv->mod->handler) != LOCATION_ERROR_NONE) return FALSE;
+
+	priv->zone_sleeping = TRUE;
+	priv->zone_timer = g_timeout_add_seconds (priv->zone_sleep_interval, _zone_wakeup_cb, data);
+	return FALSE;
+}
+
+/* The zone timers are set by the provider thread as well, and may be cancelled while waiting for the lock */
+static gboolean
+_zone_timer_call (gpointer data, GSourceFunc func)
+{
+	ProviderThread *thread = provider_thread_lock (data);
+	LocationGpsPrivate *priv = GET_PRIVATE(data);
+
+	if (priv && priv->zone_timer == g_source_get_id (g_main_current_source ())) func (data);
+	provider_thread_unlock (thread);
+	return FALSE;
+}
+
+static gboolean
+_zone_wakeup_cb (gpointer data)
+{
+	return _zone_timer_call (data, _zone_wakeup);
+}
+
+static gboolean
+_zone_sleep_cb (gpointer data)
+{
+	return _zone_timer_call (data, _zone_sleep);
+}
+
+/* Returns TRUE if the module was stopped by the duty cycle */
+static gboolean
+_zone_cancel_sleep (LocationGpsPrivate *priv)
+{
+	gboolean sleeping = priv->zone_sleeping;
+
+	if (priv->zone_timer) g_source_remove (priv->zone_timer);
+	priv->zone_timer = 0;
+	priv->zone_sleeping = FALSE;
+	return sleeping;
 }
 
 static void
@@ -219,16 +367,18 @@ location_setting_search_cb (keynode_t *key, gpointer self)
 	g_return_if_fail (priv->mod);
 	g_return_if_fail (priv->mod->handler);
 
+	ProviderThread *thread = provider_thread_lock (self);
 	if (location_setting_get_key_val(key) == VCONFKEY_LOCATION_GPS_SEARCHING) {
-		if (!priv->pos_timer) priv->pos_timer = g_timeout_add (priv->pos_interval * 1000, _position_timeout_cb, self);
-		if (!priv->vel_timer) priv->vel_timer = g_timeout_add (priv->vel_interval * 1000, _velocity_timeout_cb, self);
+		if (!priv->pos_timer) priv->pos_timer = timer_wheel_add (priv->pos_interval_ms, _position_timeout_cb, self);
+		if (!priv->vel_timer) priv->vel_timer = timer_wheel_add (priv->vel_interval_ms, _velocity_timeout_cb, self);
 	}
 	else {
-		if (priv->pos_timer) g_source_remove (priv->pos_timer);
-		if (priv->vel_timer) g_source_remove (priv->vel_timer);
+		if (priv->pos_timer) timer_wheel_remove (priv->pos_timer);
+		if (priv->vel_timer) timer_wheel_remove (priv->vel_timer);
 		priv->pos_timer = 0;
 		priv->vel_timer = 0;
 	}
+	provider_thread_unlock (thread);
 }
 
 static void
@@ -243,10 +393,12 @@ location_setting_gps_cb (keynode_t *key,
 	g_return_if_fail (priv->mod->handler);
 
 	int ret = LOCATION_ERROR_NONE;
+	ProviderThread *thread = provider_thread_lock (self);
 
 	if (0 == location_setting_get_key_val(key) && priv->mod->ops.stop && priv->is_started) {
 		LOCATION_LOGD("location stopped by setting");
-		ret = priv->mod->ops.stop(priv->mod->handler);
+		if (_zone_cancel_sleep(priv)) ret = LOCATION_ERROR_NONE;
+		else ret = priv->mod->ops.stop(priv->mod->handler);
 		if (ret == LOCATION_ERROR_NONE) {
 			priv->is_started = FALSE;
 		}
@@ -258,6 +410,7 @@ location_setting_gps_cb (keynode_t *key,
 			priv->is_started = TRUE;
 		}
 	}
+	provider_thread_unlock (thread);
 }
 
 static int
@@ -307,7 +460,8 @@ location_gps_stop (LocationGps *self)
 	int ret = LOCATION_ERROR_NONE;
 
 	if ( priv->is_started == TRUE) {
-		ret = priv->mod->ops.stop (priv->mod->handler);
+		if (_zone_cancel_sleep (priv)) ret = LOCATION_ERROR_NONE;
+		else ret = priv->mod->ops.stop (priv->mod->handler);
 		if (ret == LOCATION_ERROR_NONE) {
 			priv->is_started = FALSE;
 		}
@@ -316,8 +470,8 @@ location_gps_stop (LocationGps *self)
 		}
 	}
 
-	if (priv->pos_timer ) g_source_remove (priv->pos_timer);
-	if (priv->vel_timer ) g_source_remove (priv->vel_timer);
+	if (priv->pos_timer ) timer_wheel_remove (priv->pos_timer);
+	if (priv->vel_timer ) timer_wheel_remove (priv->vel_timer);
 	priv->pos_timer = 0;
 	priv->vel_timer = 0;
 
@@ -337,8 +491,11 @@ location_gps_dispose (GObject *gobject)
 
 	LocationGpsPrivate* priv = GET_PRIVATE(gobject);
 
-	if (priv->pos_timer) g_source_remove (priv->pos_timer);
-	if (priv->vel_timer) g_source_remove (priv->vel_timer);
+	/* First, its callbacks may set the timers */
+	set_prop_provider_thread (gobject, &(priv->provider_thread), FALSE);
+	_zone_cancel_sleep (priv);
+	if (priv->pos_timer) timer_wheel_remove (priv->pos_timer);
+	if (priv->vel_timer) timer_wheel_remove (priv->vel_timer);
 	priv->pos_timer = 0;
 	priv->vel_timer = 0;
 
@@ -359,23 +516,28 @@ location_gps_finalize (GObject *gobject)
 	module_free(priv->mod, "gps");
 	priv->mod = NULL;
 
+	if (priv->boundary_index) {
+		boundary_index_free (priv->boundary_index);
+		priv->boundary_index = NULL;
+	}
+
 	if (priv->boundary_list) {
 		g_list_free_full (priv->boundary_list, free_boundary_list);
 		priv->boundary_list = NULL;
 	}
 
 	if (priv->pos) {
-		location_position_free(priv->pos);
+		position_snapshot_unref(priv->pos);
 		priv->pos = NULL;
 	}
 
 	if (priv->vel) {
-		location_velocity_free(priv->vel);
+		velocity_snapshot_unref(priv->vel);
 		priv->vel = NULL;
 	}
 
 	if (priv->acc) {
-		location_accuracy_free(priv->acc);
+		accuracy_snapshot_unref(priv->acc);
 		priv->acc = NULL;
 	}
 
@@ -383,6 +545,21 @@ location_gps_finalize (GObject *gobject)
 		location_satellite_free(priv->sat);
 		priv->sat = NULL;
 	}
+
+	if (priv->fix) {
+		location_fix_free(priv->fix);
+		priv->fix = NULL;
+	}
+
+	if (priv->history) {
+		history_free(priv->history);
+		priv->history = NULL;
+	}
+
+	if (priv->batch) {
+		batch_signaling_free(priv->batch);
+		priv->batch = NULL;
+	}
 	G_OBJECT_CLASS (location_gps_parent_class)->finalize (gobject);
 }
 
@@ -398,7 +575,14 @@ location_gps_set_property (GObject *object,
 	g_return_if_fail (priv->mod->handler);
 	LocModGpsOps ops = priv->mod->ops;
 
+	if (property_id == PROP_PROVIDER_THREAD) {
+		LOCATION_LOGD("Set prop>> provider-thread: %d", g_value_get_boolean(value));
+		set_prop_provider_thread(object, &(priv->provider_thread), g_value_get_boolean(value));
+		return;
+	}
+
 	int ret = 0;
+	ProviderThread *thread = provider_thread_lock (object);
 	switch (property_id){
 		case PROP_DEV_NAME: {
 			char* devname = g_value_dup_string(value);
@@ -409,52 +593,94 @@ location_gps_set_property (GObject *object,
 			break;
 		}
 		case PROP_BOUNDARY: {
-			GList *boundary_list = g_list_copy(g_value_get_pointer(value));
-			ret = set_prop_boundary(&priv->boundary_list, boundary_list);
+			GList *boundary_list = (GList *) g_value_get_pointer(value);
+			ret = set_prop_boundary(&priv->boundary_list, priv->boundary_index, boundary_list);
 			if(ret != 0) LOCATION_LOGD("Set boundary. Error[%d]", ret);
 			break;
 		}
 		case PROP_REMOVAL_BOUNDARY: {
 			LocationBoundary *req_boundary = (LocationBoundary*) g_value_dup_boxed(value);
-			ret = set_prop_removal_boundary(&priv->boundary_list, req_boundary);
+			ret = set_prop_removal_boundary(&priv->boundary_list, priv->boundary_index, req_boundary);
 			if(ret != 0) LOCATION_LOGD("Removal boundary. Error[%d]", ret);
+			if (req_boundary) location_boundary_free(req_boundary);
+			break;
+		}
+		case PROP_REMOVAL_BOUNDARY_LIST: {
+			GList *boundary_list = (GList *) g_value_get_pointer(value);
+			ret = set_prop_removal_boundary_list(&priv->boundary_list, priv->boundary_index, boundary_list);
+			if(ret != 0) LOCATION_LOGD("Removal boundary list. Error[%d]", ret);
 			break;
 		}
-		case PROP_POS_INTERVAL: {
+		case PROP_BOUNDARY_STORE: {
+			LocationBoundaryStore *store = (LocationBoundaryStore *) g_value_get_pointer(value);
+			boundary_index_set_store(priv->boundary_index, store);
+			break;
+		}
+		case PROP_ZONE_CROSSING: {
+			gboolean crossing = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> zone-crossing: %d", crossing);
+			boundary_index_set_crossing(priv->boundary_index, crossing);
+			break;
+		}
+		case PROP_SUBSCRIBE_FENCE_SET: {
+			guint handle = g_value_get_uint(value);
+			ret = boundary_index_subscribe(priv->boundary_index, handle);
+			if(ret != 0) LOCATION_LOGD("Subscribe fence set [%u]. Error[%d]", handle, ret);
+			break;
+		}
+		case PROP_UNSUBSCRIBE_FENCE_SET: {
+			guint handle = g_value_get_uint(value);
+			ret = boundary_index_unsubscribe(priv->boundary_index, handle);
+			if(ret != 0) LOCATION_LOGD("Unsubscribe fence set [%u]. Error[%d]", handle, ret);
+			break;
+		}
+		case PROP_ZONE_DUTY_CYCLE: {
+			priv->zone_duty_cycle = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> zone-duty-cycle: %d", priv->zone_duty_cycle);
+			if (!priv->zone_duty_cycle && priv->zone_timer) {
+				if (_zone_cancel_sleep(priv)) _zone_wakeup(object);
+			}
+			break;
+		}
+		case PROP_FIX_UPDATES: {
+			priv->fix_updates = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> fix-updates: %d", priv->fix_updates);
+			break;
+		}
+		case PROP_BATCH_SIZE: {
+			priv->batch_size = g_value_get_uint(value);
+			LOCATION_LOGD("Set prop>> batch-size: %u", priv->batch_size);
+			batch_signaling_set(&(priv->batch), object, signals, priv->batch_size, priv->batch_latency);
+			break;
+		}
+		case PROP_BATCH_LATENCY: {
+			priv->batch_latency = g_value_get_uint(value);
+			batch_signaling_set(&(priv->batch), object, signals, priv->batch_size, priv->batch_latency);
+			break;
+		}
+		case PROP_HISTORY_SIZE: {
+			history_set_size(&(priv->history), g_value_get_uint(value));
+			break;
+		}
+		case PROP_POS_INTERVAL:
+		case PROP_POS_INTERVAL_MS: {
 			guint interval = g_value_get_uint(value);
 			LOCATION_LOGD("Set prop>> update-interval: %u", interval);
-			if(interval > 0) {
-				if(interval < LOCATION_UPDATE_INTERVAL_MAX)
-					priv->pos_interval = interval;
-				else
-					priv->pos_interval = (guint)LOCATION_UPDATE_INTERVAL_MAX;
-			}
-			else
-				priv->pos_interval = (guint)LOCATION_UPDATE_INTERVAL_DEFAULT;
+			if (property_id == PROP_POS_INTERVAL) interval = MIN(interval, LOCATION_UPDATE_INTERVAL_MAX) * 1000;
+			priv->pos_interval_ms = get_update_interval_ms(interval);
 
-			if (priv->pos_timer) {
-				g_source_remove (priv->pos_timer);
-				priv->pos_timer = g_timeout_add (priv->pos_interval * 1000, _position_timeout_cb, object);
-			}
+			if (priv->pos_timer) timer_wheel_set_interval (priv->pos_timer, priv->pos_interval_ms);
 
 			break;
 		}
-		case PROP_VEL_INTERVAL: {
+		case PROP_VEL_INTERVAL:
+		case PROP_VEL_INTERVAL_MS: {
 			guint interval = g_value_get_uint(value);
 			LOCATION_LOGD("Set prop>> update-interval: %u", interval);
-			if(interval > 0) {
-				if(interval < LOCATION_UPDATE_INTERVAL_MAX)
-					priv->vel_interval = interval;
-				else
-					priv->vel_interval = (guint)LOCATION_UPDATE_INTERVAL_MAX;
-			}
-			else
-				priv->vel_interval = (guint)LOCATION_UPDATE_INTERVAL_DEFAULT;
+			if (property_id == PROP_VEL_INTERVAL) interval = MIN(interval, LOCATION_UPDATE_INTERVAL_MAX) * 1000;
+			priv->vel_interval_ms = get_update_interval_ms(interval);
 
-			if (priv->vel_timer) {
-				g_source_remove (priv->vel_timer);
-				priv->vel_timer = g_timeout_add (priv->vel_interval * 1000, _velocity_timeout_cb, object);
-			}
+			if (priv->vel_timer) timer_wheel_set_interval (priv->vel_timer, priv->vel_interval_ms);
 
 			break;
 		}
@@ -476,6 +702,7 @@ location_gps_set_property (GObject *object,
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
 			break;
 	}
+	provider_thread_unlock (thread);
 }
 
 static void
@@ -489,6 +716,7 @@ location_gps_get_property (GObject *object,
 	g_return_if_fail (priv->mod);
 	g_return_if_fail (priv->mod->handler);
 	LocModGpsOps ops = priv->mod->ops;
+	ProviderThread *thread = provider_thread_lock (object);
 	switch (property_id) {
 		case PROP_DEV_NAME: {
 			char* devname = NULL;
@@ -506,10 +734,16 @@ location_gps_get_property (GObject *object,
 			g_value_set_boxed (value, priv->pos);
 			break;
 		case PROP_POS_INTERVAL:
-			g_value_set_uint(value, priv->pos_interval);
+			g_value_set_uint(value, MAX(priv->pos_interval_ms / 1000, LOCATION_UPDATE_INTERVAL_MIN));
 			break;
 		case PROP_VEL_INTERVAL:
-			g_value_set_uint(value, priv->vel_interval);
+			g_value_set_uint(value, MAX(priv->vel_interval_ms / 1000, LOCATION_UPDATE_INTERVAL_MIN));
+			break;
+		case PROP_POS_INTERVAL_MS:
+			g_value_set_uint(value, priv->pos_interval_ms);
+			break;
+		case PROP_VEL_INTERVAL_MS:
+			g_value_set_uint(value, priv->vel_interval_ms);
 			break;
 		case PROP_SAT_INTERVAL:
 			g_value_set_uint(value, priv->sat_interval);
@@ -517,6 +751,27 @@ location_gps_get_property (GObject *object,
 		case PROP_BOUNDARY:
 			g_value_set_pointer(value, g_list_first(priv->boundary_list));
 			break;
+		case PROP_ZONE_CROSSING:
+			g_value_set_boolean(value, boundary_index_get_crossing(priv->boundary_index));
+			break;
+		case PROP_ZONE_DUTY_CYCLE:
+			g_value_set_boolean(value, priv->zone_duty_cycle);
+			break;
+		case PROP_FIX_UPDATES:
+			g_value_set_boolean(value, priv->fix_updates);
+			break;
+		case PROP_BATCH_SIZE:
+			g_value_set_uint(value, priv->batch_size);
+			break;
+		case PROP_BATCH_LATENCY:
+			g_value_set_uint(value, priv->batch_latency);
+			break;
+		case PROP_PROVIDER_THREAD:
+			g_value_set_boolean(value, priv->provider_thread != NULL);
+			break;
+		case PROP_HISTORY_SIZE:
+			g_value_set_uint(value, history_get_size(priv->history));
+			break;
 		case PROP_NMEA: {
 			char *nmea_data = NULL;
 			if (ops.get_nmea &&  LOCATION_ERROR_NONE == ops.get_nmea(priv->mod->handler, &nmea_data) && nmea_data) {
@@ -545,6 +800,7 @@ location_gps_get_property (GObject *object,
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
 			break;
 	}
+	provider_thread_unlock (thread);
 }
 
 static int
@@ -563,6 +819,7 @@ location_gps_get_position (LocationGps *self,
 	g_return_val_if_fail (priv->mod->handler, LOCATION_ERROR_NOT_AVAILABLE);
 	g_return_val_if_fail (ops.get_position, LOCATION_ERROR_NOT_AVAILABLE);
 
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
 	if (priv->pos) {
 		*position = location_position_copy (priv->pos);
 		ret = LOCATION_ERROR_NONE;
@@ -571,6 +828,7 @@ location_gps_get_position (LocationGps *self,
 	if (priv->acc) {
 		*accuracy = location_accuracy_copy (priv->acc);
 	}
+	provider_thread_unlock (thread);
 
 	return ret;
 }
@@ -610,6 +868,7 @@ location_gps_get_velocity (LocationGps *self,
 	g_return_val_if_fail (priv->mod->handler, LOCATION_ERROR_NOT_AVAILABLE);
 	g_return_val_if_fail (ops.get_velocity, LOCATION_ERROR_NOT_AVAILABLE);
 	
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
 	if (priv->vel) {
 		*velocity = location_velocity_copy (priv->vel);
 		ret = LOCATION_ERROR_NONE;
@@ -618,6 +877,7 @@ location_gps_get_velocity (LocationGps *self,
 	if (priv->acc) {
 		*accuracy = location_accuracy_copy (priv->acc);
 	}
+	provider_thread_unlock (thread);
 
 	return ret;
 }
@@ -651,11 +911,13 @@ location_gps_get_satellite (LocationGps *self,
 	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
 	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
 
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
 	if (priv->sat) {
 		*satellite = location_satellite_copy (priv->sat);
 		ret = LOCATION_ERROR_NONE;
 	}
-	
+	provider_thread_unlock (thread);
+
 	return ret;
 }
 
@@ -675,6 +937,150 @@ location_gps_get_last_satellite (LocationGps *self,
 	return ops.get_last_satellite(priv->mod->handler, satellite);
 }
 
+static int
+location_gps_get_fix (LocationGps *self,
+	LocationFix **fix)
+{
+	int ret = LOCATION_ERROR_NOT_AVAILABLE;
+	LOCATION_LOGD("location_gps_get_fix");
+
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	if (priv->fix) {
+		*fix = location_fix_ref (priv->fix);
+		ret = LOCATION_ERROR_NONE;
+	}
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
+static int
+location_gps_get_position_into (LocationGps *self,
+	LocationPosition *position,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_gps_get_position_into");
+
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_POSITION, position, NULL, accuracy);
+}
+
+static int
+location_gps_get_velocity_into (LocationGps *self,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_gps_get_velocity_into");
+
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_VELOCITY, NULL, velocity, accuracy);
+}
+
+static int
+location_gps_get_latest_fix (LocationGps *self,
+	LocationPosition *position,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_gps_get_latest_fix");
+
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, position, velocity, accuracy);
+}
+
+static int
+location_gps_get_satellite_into (LocationGps *self,
+	LocationSatellite *satellite,
+	LocationSatelliteDetail *details,
+	guint max_details)
+{
+	LOCATION_LOGD("location_gps_get_satellite_into");
+
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	int ret = copy_satellite_into (priv->sat, satellite, details, max_details);
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
+static int
+location_gps_get_history (LocationGps *self,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	guint max,
+	guint *count)
+{
+	LOCATION_LOGD("location_gps_get_history");
+
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	int ret = history_get_last (priv->history, positions, accuracies, max, count);
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
+static int
+location_gps_get_history_range (LocationGps *self,
+	gint64 from,
+	gint64 to,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	gint64 *times,
+	guint max,
+	guint *count)
+{
+	LOCATION_LOGD("location_gps_get_history_range");
+
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_ENABLED);
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	int ret = history_get_range (priv->history, from, to, positions, accuracies, times, max, count);
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
+static int
+location_gps_flush_batch (LocationGps *self)
+{
+	LOCATION_LOGD("location_gps_flush_batch");
+	LocationGpsPrivate *priv = GET_PRIVATE (self);
+
+	int ret = LOCATION_ERROR_NOT_AVAILABLE;
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	if (priv->batch) {
+		batch_flush_signaling (priv->batch);
+		ret = LOCATION_ERROR_NONE;
+	}
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
 static void
 location_ielement_interface_init (LocationIElementInterface *iface)
 {
@@ -686,6 +1092,14 @@ location_ielement_interface_init (LocationIElementInterface *iface)
 	iface->get_last_velocity = (TYPE_GET_VELOCITY)location_gps_get_last_velocity;
 	iface->get_satellite = (TYPE_GET_SATELLITE)location_gps_get_satellite;
 	iface->get_last_satellite = (TYPE_GET_SATELLITE)location_gps_get_last_satellite;
+	iface->get_fix = (TYPE_GET_FIX)location_gps_get_fix;
+	iface->get_position_into = (TYPE_GET_POSITION_INTO)location_gps_get_position_into;
+	iface->get_velocity_into = (TYPE_GET_VELOCITY_INTO)location_gps_get_velocity_into;
+	iface->get_satellite_into = (TYPE_GET_SATELLITE_INTO)location_gps_get_satellite_into;
+	iface->get_history = (TYPE_GET_HISTORY)location_gps_get_history;
+	iface->get_history_range = (TYPE_GET_HISTORY_RANGE)location_gps_get_history_range;
+	iface->flush_batch = (TYPE_FLUSH_BATCH)location_gps_flush_batch;
+	iface->get_latest_fix = (TYPE_GET_LATEST_FIX)location_gps_get_latest_fix;
 }
 
 static void
@@ -701,24 +1115,36 @@ location_gps_init (LocationGps *self)
 	priv->set_noti = FALSE;
 	priv->enabled= FALSE;
 
-	priv->pos_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
-	priv->vel_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
+	priv->pos_interval_ms = LOCATION_UPDATE_INTERVAL_MS_DEFAULT;
+	priv->vel_interval_ms = LOCATION_UPDATE_INTERVAL_MS_DEFAULT;
 	priv->sat_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
 
-	priv->pos_updated_timestamp = 0;
-	priv->vel_updated_timestamp = 0;
+	priv->pos_updated_time = 0;
+	priv->vel_updated_time = 0;
 	priv->sat_updated_timestamp = 0;
+	priv->sat_changed = FALSE;
 
 	priv->pos = NULL;
 	priv->vel = NULL;
 	priv->acc = NULL;
 	priv->sat = NULL;
+	priv->fix = NULL;
+	priv->fix_updated_time = 0;
+	priv->fix_updates = FALSE;
+	priv->history = NULL;
+	priv->batch = NULL;
+	priv->batch_size = 0;
+	priv->batch_latency = LOCATION_BATCH_LATENCY_DEFAULT;
 	priv->zone_status = ZONE_STATUS_NONE;
 	priv->boundary_list = NULL;
+	priv->boundary_index = boundary_index_new();
 
 	priv->pos_timer = 0;
 	priv->vel_timer = 0;
 
+	priv->zone_duty_cycle = FALSE;
+	priv->zone_sleeping = FALSE;
+	priv->zone_timer = 0;
 }
 
 static void
@@ -791,6 +1217,32 @@ location_gps_class_init (LocationGpsClass *klass)
 			G_TYPE_POINTER,
 			G_TYPE_POINTER);
 
+	signals[ZONE_CHANGED] = g_signal_new ("zone-changed",
+			G_TYPE_FROM_CLASS (klass),
+			G_SIGNAL_RUN_FIRST |
+			G_SIGNAL_NO_RECURSE,
+			G_STRUCT_OFFSET (LocationGpsClass, zone_changed),
+			NULL, NULL,
+			location_VOID__POINTER_POINTER_POINTER_POINTER,
+			G_TYPE_NONE, 4,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER);
+
+	signals[FENCE_CHANGED] = g_signal_new ("fence-changed",
+			G_TYPE_FROM_CLASS (klass),
+			G_SIGNAL_RUN_FIRST |
+			G_SIGNAL_NO_RECURSE,
+			G_STRUCT_OFFSET (LocationGpsClass, fence_changed),
+			NULL, NULL,
+			location_VOID__POINTER_POINTER_POINTER_POINTER,
+			G_TYPE_NONE, 4,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER);
+
 	properties[PROP_DEV_NAME] = g_param_spec_string ("dev-name",
 			"gps device name prop",
 			"gps device name",
@@ -827,6 +1279,22 @@ location_gps_class_init (LocationGpsClass *klass)
 			LOCATION_UPDATE_INTERVAL_DEFAULT,
 			G_PARAM_READWRITE);
 
+	properties[PROP_POS_INTERVAL_MS] = g_param_spec_uint ("pos-interval-ms",
+			"gps position interval in milliseconds prop",
+			"gps position interval in milliseconds data",
+			LOCATION_UPDATE_INTERVAL_MS_MIN,
+			LOCATION_UPDATE_INTERVAL_MS_MAX,
+			LOCATION_UPDATE_INTERVAL_MS_DEFAULT,
+			G_PARAM_READWRITE);
+
+	properties[PROP_VEL_INTERVAL_MS] = g_param_spec_uint ("vel-interval-ms",
+			"gps velocity interval in milliseconds prop",
+			"gps velocity interval in milliseconds data",
+			LOCATION_UPDATE_INTERVAL_MS_MIN,
+			LOCATION_UPDATE_INTERVAL_MS_MAX,
+			LOCATION_UPDATE_INTERVAL_MS_DEFAULT,
+			G_PARAM_READWRITE);
+
 	properties[PROP_SAT_INTERVAL] = g_param_spec_uint ("sat-interval",
 			"gps satellite interval prop",
 			"gps satellite interval data",
@@ -846,6 +1314,76 @@ location_gps_class_init (LocationGpsClass *klass)
 			LOCATION_TYPE_BOUNDARY,
 			G_PARAM_READWRITE);
 
+	properties[PROP_REMOVAL_BOUNDARY_LIST] = g_param_spec_pointer ("removal-boundary-list",
+			"gps removal boundary list prop",
+			"gps removal boundary list data",
+			G_PARAM_WRITABLE);
+
+	properties[PROP_BOUNDARY_STORE] = g_param_spec_pointer ("boundary-store",
+			"gps boundary store prop",
+			"gps memory-mapped boundary store",
+			G_PARAM_WRITABLE);
+
+	properties[PROP_ZONE_CROSSING] = g_param_spec_boolean ("zone-crossing",
+			"gps zone crossing prop",
+			"gps zone check on the path between positions",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_SUBSCRIBE_FENCE_SET] = g_param_spec_uint ("subscribe-fence-set",
+			"gps subscribe fence set prop",
+			"gps handle of the shared fence set to watch",
+			0, G_MAXUINT, 0,
+			G_PARAM_WRITABLE);
+
+	properties[PROP_UNSUBSCRIBE_FENCE_SET] = g_param_spec_uint ("unsubscribe-fence-set",
+			"gps unsubscribe fence set prop",
+			"gps handle of the shared fence set to stop watching",
+			0, G_MAXUINT, 0,
+			G_PARAM_WRITABLE);
+
+	properties[PROP_ZONE_DUTY_CYCLE] = g_param_spec_boolean ("zone-duty-cycle",
+			"gps zone duty cycle prop",
+			"gps paused while no boundary can be reached",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_FIX_UPDATES] = g_param_spec_boolean ("fix-updates",
+			"gps fix updates prop",
+			"gps one fix update per epoch instead of position, velocity and satellite updates",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_HISTORY_SIZE] = g_param_spec_uint ("history-size",
+			"gps history size prop",
+			"gps number of the last positions kept, 0 for none",
+			0,
+			LOCATION_HISTORY_SIZE_MAX,
+			0,
+			G_PARAM_READWRITE);
+
+	properties[PROP_BATCH_SIZE] = g_param_spec_uint ("batch-size",
+			"gps batch size prop",
+			"gps number of positions delivered at once by a BATCH_UPDATED update, 0 for none",
+			0,
+			LOCATION_BATCH_SIZE_MAX,
+			0,
+			G_PARAM_READWRITE);
+
+	properties[PROP_BATCH_LATENCY] = g_param_spec_uint ("batch-latency",
+			"gps batch latency prop",
+			"gps maximum seconds a position waits in a batch",
+			1,
+			LOCATION_BATCH_LATENCY_MAX,
+			LOCATION_BATCH_LATENCY_DEFAULT,
+			G_PARAM_READWRITE);
+
+	properties[PROP_PROVIDER_THREAD] = g_param_spec_boolean ("provider-thread",
+			"gps provider thread prop",
+			"gps updates processed on a thread of their own, then delivered to the main context of the caller",
+			FALSE,
+			G_PARAM_READWRITE);
+
 
 	properties[PROP_NMEA] = g_param_spec_string ("nmea",
 			"gps NMEA name prop",
@@ -0,0 +1,208 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "location.h"
+#include "location-history.h"
+#include "location-log.h"
+
+/**
+ * The positions, their accuracies and their reception times are kept in three arrays in the order
+ * of reception, so any run of them is at most two blocks of each array to copy for the caller.
+ * The oldest one is overwritten when the buffer is full.
+ */
+struct _LocationHistory {
+	guint size;
+	guint first;		/* index of the oldest position */
+	guint count;
+	LocationPosition *positions;
+	LocationAccuracy *accuracies;
+	gint64 *times;		/* monotonic milliseconds of reception */
+};
+
+#define HISTORY_INDEX(history, i)	(((history)->first + (i)) % (history)->size)
+
+static void
+_history_copy (const LocationHistory *history,
+	guint start,
+	guint count,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	gint64 *times)
+{
+	guint index = HISTORY_INDEX(history, start);
+	guint head = MIN(count, history->size - index);
+
+	memcpy (positions, history->positions + index, head * sizeof (LocationPosition));
+	memcpy (positions + head, history->positions, (count - head) * sizeof (LocationPosition));
+	if (accuracies) {
+		memcpy (accuracies, history->accuracies + index, head * sizeof (LocationAccuracy));
+		memcpy (accuracies + head, history->accuracies, (count - head) * sizeof (LocationAccuracy));
+	}
+	if (times) {
+		memcpy (times, history->times + index, head * sizeof (gint64));
+		memcpy (times + head, history->times, (count - head) * sizeof (gint64));
+	}
+}
+
+/* First position at or after time, history->count if none */
+static guint
+_history_search (const LocationHistory *history, gint64 time)
+{
+	guint low = 0;
+	guint high = history->count;
+
+	while (low < high) {
+		guint middle = low + (high - low) / 2;
+		if (history->times[HISTORY_INDEX(history, middle)] < time) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+void
+history_free (LocationHistory *history)
+{
+	g_return_if_fail(history);
+
+	g_free (history->positions);
+	g_free (history->accuracies);
+	g_free (history->times);
+	g_slice_free (LocationHistory, history);
+}
+
+void
+history_set_size (LocationHistory **history,
+	guint size)
+{
+	g_return_if_fail(history);
+
+	LocationHistory *resized = NULL;
+
+	size = MIN(size, LOCATION_HISTORY_SIZE_MAX);
+	if (*history && (*history)->size == size) return;
+
+	if (size) {
+		resized = g_slice_new0 (LocationHistory);
+		resized->size = size;
+		resized->positions = g_new (LocationPosition, size);
+		resized->accuracies = g_new (LocationAccuracy, size);
+		resized->times = g_new (gint64, size);
+		if (*history) {
+			resized->count = MIN((*history)->count, size);
+			_history_copy (*history, (*history)->count - resized->count, resized->count, resized->positions, resized->accuracies, resized->times);
+		}
+	}
+	LOCATION_LOGD("history size %u", size);
+
+	if (*history) history_free (*history);
+	*history = resized;
+}
+
+guint
+history_get_size (const LocationHistory *history)
+{
+	return history ? history->size : 0;
+}
+
+void
+history_append (LocationHistory *history,
+	const LocationPosition *position,
+	const LocationAccuracy *accuracy,
+	gint64 received_time)
+{
+	g_return_if_fail(history);
+	g_return_if_fail(position);
+
+	guint index = 0;
+
+	if (!position->timestamp) return;
+	/* The range queries search the buffer by time */
+	if (history->count && received_time < history->times[HISTORY_INDEX(history, history->count - 1)]) return;
+
+	if (history->count < history->size) {
+		index = HISTORY_INDEX(history, history->count);
+		history->count++;
+	} else {
+		index = history->first;
+		history->first = (history->first + 1) % history->size;
+	}
+
+	history->positions[index] = *position;
+	history->times[index] = received_time;
+	if (accuracy) {
+		history->accuracies[index] = *accuracy;
+	} else {
+		history->accuracies[index].level = LOCATION_ACCURACY_LEVEL_NONE;
+		history->accuracies[index].horizontal_accuracy = 0.0;
+		history->accuracies[index].vertical_accuracy = 0.0;
+	}
+}
+
+int
+history_get_last (const LocationHistory *history,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	guint max,
+	guint *count)
+{
+	g_return_val_if_fail(positions || !max, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(count, LOCATION_ERROR_PARAMETER);
+
+	*count = 0;
+	if (!history) return LOCATION_ERROR_NOT_AVAILABLE;
+
+	*count = MIN(max, history->count);
+	_history_copy (history, history->count - *count, *count, positions, accuracies, NULL);
+	return LOCATION_ERROR_NONE;
+}
+
+int
+history_get_range (const LocationHistory *history,
+	gint64 from,
+	gint64 to,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	gint64 *times,
+	guint max,
+	guint *count)
+{
+	g_return_val_if_fail(positions || !max, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(count, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(from <= to, LOCATION_ERROR_PARAMETER);
+
+	guint start = 0;
+	guint end = 0;
+
+	*count = 0;
+	if (!history) return LOCATION_ERROR_NOT_AVAILABLE;
+
+	start = _history_search (history, from);
+	end = to == G_MAXINT64 ? history->count : _history_search (history, to + 1);
+	*count = MIN(max, end - start);
+	_history_copy (history, start, *count, positions, accuracies, times);
+	return LOCATION_ERROR_NONE;
+}
@@ -0,0 +1,55 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_HISTORY_H__
+#define __LOCATION_HISTORY_H__
+
+#include <location-position.h>
+#include <location-accuracy.h>
+
+/**
+ * @file location-history.h
+ * @brief This file contains the ring buffer of the recent positions kept by a LocationObject.
+ */
+
+G_BEGIN_DECLS
+
+#define LOCATION_HISTORY_SIZE_MAX	36000	/* one hour at 10 Hz */
+
+typedef struct _LocationHistory LocationHistory;
+
+/* Resizes *history to size positions, keeping the latest ones. 0 frees it and sets *history to NULL. */
+void history_set_size (LocationHistory **history, guint size);
+guint history_get_size (const LocationHistory *history);
+void history_free (LocationHistory *history);
+
+/* Positions received, in monotonic milliseconds, before the latest one are dropped */
+void history_append (LocationHistory *history, const LocationPosition *position, const LocationAccuracy *accuracy, gint64 received_time);
+
+/* Copy into the caller arrays, oldest first, the last max positions or the first max ones received in [from, to] milliseconds.
+ * accuracies and times may be NULL. LOCATION_ERROR_NOT_AVAILABLE without history. */
+int history_get_last (const LocationHistory *history, LocationPosition *positions, LocationAccuracy *accuracies, guint max, guint *count);
+int history_get_range (const LocationHistory *history, gint64 from, gint64 to,
+		LocationPosition *positions, LocationAccuracy *accuracies, gint64 *times, guint max, guint *count);
+
+G_END_DECLS
+
+#endif
@@ -33,6 +33,8 @@
 #include "location-ielement.h"
 #include "location-signaling-util.h"
 #include "location-common-util.h"
+#include "location-history.h"
+#include "location-timer-wheel.h"
 
 #include "location-gps.h"
 #include "location-wps.h"
@@ -42,11 +44,12 @@ typedef struct _LocationHybridPrivate {
 	gboolean is_started;
 	gboolean gps_enabled;
 	gboolean wps_enabled;
-	guint pos_updated_timestamp;
-	guint pos_interval;
-	guint vel_updated_timestamp;
-	guint vel_interval;
+	gint64 pos_updated_time;
+	guint pos_interval_ms;
+	gint64 vel_updated_time;
+	guint vel_interval_ms;
 	guint sat_updated_timestamp;
+	gboolean sat_changed;	/* since the last satellite signal */
 	guint sat_interval;
 	LocationObject *gps;
 	LocationObject *wps;
@@ -55,14 +58,28 @@ typedef struct _LocationHybridPrivate {
 	LocationPosition *pos;
 	LocationVelocity *vel;
 	LocationAccuracy *acc;
+	LatestFix latest;
 	LocationSatellite *sat;
+	LocationFix *fix;
+	gint64 fix_updated_time;
+	gboolean fix_updates;
+	LocationHistory *history;
+	LocationBatch *batch;
+	guint batch_size;
+	guint batch_latency;
 	GList* boundary_list;
+	LocationBoundaryIndex *boundary_index;
 	ZoneStatus zone_status;
 
 	gboolean set_noti;
 	guint pos_timer;
 	guint vel_timer;
 
+	gboolean zone_duty_cycle;
+	gboolean zone_sleeping;	/* gps and wps stopped until no boundary can be reached */
+	guint zone_sleep_interval;
+	guint zone_timer;
+
 } LocationHybridPrivate;
 
 enum {
@@ -74,6 +91,18 @@ enum {
 	PROP_SAT_INTERVAL,
 	PROP_BOUNDARY,
 	PROP_REMOVAL_BOUNDARY,
+	PROP_REMOVAL_BOUNDARY_LIST,
+	PROP_BOUNDARY_STORE,
+	PROP_ZONE_CROSSING,
+	PROP_SUBSCRIBE_FENCE_SET,
+	PROP_UNSUBSCRIBE_FENCE_SET,
+	PROP_ZONE_DUTY_CYCLE,
+	PROP_FIX_UPDATES,
+	PROP_POS_INTERVAL_MS,
+	PROP_VEL_INTERVAL_MS,
+	PROP_HISTORY_SIZE,
+	PROP_BATCH_SIZE,
+	PROP_BATCH_LATENCY,
 	PROP_MAX
 };
 
@@ -83,6 +112,7 @@ static GParamSpec *properties[PROP_MAX] = {NULL, };
 #define GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), LOCATION_TYPE_HYBRID, LocationHybridPrivate))
 
 static void location_ielement_interface_init (LocationIElementInterface *iface);
+static gboolean _zone_sleep_cb (gpointer data);
 
 G_DEFINE_TYPE_WITH_CODE (LocationHybrid, location_hybrid, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (LOCATION_TYPE_IELEMENT,
@@ -176,28 +206,36 @@ _position_timeout_cb (gpointer data)
 	LocationHybridPrivate *priv = GET_PRIVATE(object);
 	if (!priv) return FALSE;
 
+	/* Delivered with the batch */
+	if (priv->batch) return TRUE;
+
+	if (priv->fix_updates) {
+		fix_timeout_signaling(object, signals, priv->fix);
+		return TRUE;
+	}
+
 	LocationPosition *pos = NULL;
 	LocationAccuracy *acc = NULL;
 
 	if (priv->pos) {
-		pos = location_position_copy (priv->pos);
+		pos = position_snapshot_ref (priv->pos);
 	}
 	else {
-		pos = location_position_new (0, 0.0, 0.0, 0.0, LOCATION_STATUS_NO_FIX);
+		pos = position_snapshot_new (NULL);
 	}
 
 	if (priv->acc) {
-		acc = location_accuracy_copy (priv->acc);
+		acc = accuracy_snapshot_ref (priv->acc);
 	}
 	else {
-		acc = location_accuracy_new (LOCATION_ACCURACY_LEVEL_NONE, 0.0, 0.0);
+		acc = accuracy_snapshot_new (NULL);
 	}
 
 	LOCATION_LOGD("POSITION SERVICE_UPDATED");
-	g_signal_emit(object, signals[SERVICE_UPDATED], 0, POSITION_UPDATED, pos, acc);
+	update_signaling(object, signals, POSITION_UPDATED, pos, acc);
 
-	location_position_free (pos);
-	location_accuracy_free (acc);
+	position_snapshot_unref (pos);
+	accuracy_snapshot_unref (acc);
 
 	return TRUE;
 }
@@ -210,28 +248,34 @@ _velocity_timeout_cb (gpointer data)
 	LocationHybridPrivate *priv = GET_PRIVATE(object);
 	if (!priv) return FALSE;
 
+	/* Delivered with the batch */
+	if (priv->batch) return TRUE;
+
+	/* Carried by the fix of the position timer */
+	if (priv->fix_updates) return TRUE;
+
 	LocationVelocity *vel = NULL;
 	LocationAccuracy *acc = NULL;
 
 	if (priv->vel) {
-		vel = location_velocity_copy(priv->vel);
+		vel = velocity_snapshot_ref (priv->vel);
 	}
 	else {
-		vel = location_velocity_new (0, 0.0, 0.0, 0.0);
+		vel = velocity_snapshot_new (NULL);
 	}
 
 	if (priv->acc) {
-		acc = location_accuracy_copy (priv->acc);
+		acc = accuracy_snapshot_ref (priv->acc);
 	}
 	else {
-		acc = location_accuracy_new (LOCATION_ACCURACY_LEVEL_NONE, 0.0, 0.0);
+		acc = accuracy_snapshot_new (NULL);
 	}
 
 	LOCATION_LOGD("VELOCITY SERVICE_UPDATED");
-	g_signal_emit(object, signals[SERVICE_UPDATED], 0, VELOCITY_UPDATED, vel, acc);
+	update_signaling(object, signals, VELOCITY_UPDATED, vel, acc);
 
-	location_velocity_free (vel);
-	location_accuracy_free (acc);
+	velocity_snapshot_unref (vel);
+	accuracy_snapshot_unref (acc);
 
 	return TRUE;
 }
@@ -246,13 +290,13 @@ location_hybrid_state_cb (keynode_t *key, gpointer self)
 	LocationHybridPrivate *priv = GET_PRIVATE(self);
 	
 	if (location_setting_get_key_val (key) == VCONFKEY_LOCATION_POSITION_SEARCHING) {
-		if (!priv->pos_timer) priv->pos_timer = g_timeout_add (priv->pos_interval * 1000, _position_timeout_cb, self);
-		if (!priv->vel_timer) priv->vel_timer = g_timeout_add (priv->vel_interval * 1000, _velocity_timeout_cb, self);
+		if (!priv->pos_timer) priv->pos_timer = timer_wheel_add (priv->pos_interval_ms, _position_timeout_cb, self);
+		if (!priv->vel_timer) priv->vel_timer = timer_wheel_add (priv->vel_interval_ms, _velocity_timeout_cb, self);
 
 	}
 	else {
-		if (priv->pos_timer) g_source_remove (priv->pos_timer);
-		if (priv->vel_timer) g_source_remove (priv->vel_timer);
+		if (priv->pos_timer) timer_wheel_remove (priv->pos_timer);
+		if (priv->vel_timer) timer_wheel_remove (priv->vel_timer);
 		
 		priv->pos_timer = 0;
 		priv->vel_timer = 0;
@@ -284,14 +328,19 @@ hybrid_service_updated (GObject *obj,
 		case SATELLITE_UPDATED: {
 			sat = (LocationSatellite *)data;
 			if (!sat->timestamp) return;
+			break;
 		}
+		default:
+			/* The fix is built here from the updates of each kind */
+			return;
 	}
 
 	LocationHybridPrivate* priv = GET_PRIVATE((LocationHybrid*)self);
 	GType g_type = G_TYPE_FROM_INSTANCE(obj);
 	if (g_type == LOCATION_TYPE_GPS) {
 		if (type == SATELLITE_UPDATED) {
-			satellite_signaling(self, signals, &(priv->enabled), priv->sat_interval, TRUE, &(priv->sat_updated_timestamp), &(priv->sat), sat);
+			satellite_signaling(self, signals, &(priv->enabled), priv->sat_interval, !priv->fix_updates && !priv->batch, &(priv->sat_updated_timestamp), &(priv->sat_changed), &(priv->sat), sat);
+			fix_signaling(self, signals, priv->pos_interval_ms, priv->fix_updates && !priv->batch, LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, &(priv->fix_updated_time), &(priv->fix), NULL, NULL, NULL, sat, 0);
 			return ;
 		}
 		else if (location_setting_get_int (VCONFKEY_LOCATION_GPS_STATE) == VCONFKEY_LOCATION_GPS_SEARCHING) {
@@ -307,11 +356,22 @@ hybrid_service_updated (GObject *obj,
 
 	if (hybrid_compare_g_type_method(priv, g_type)) {
 		LocationAccuracy *acc = (LocationAccuracy*)accuracy;
+		/* Stamped on reception from the provider object */
+		gint64 received_time = g_get_monotonic_time () / 1000;
 		if (type == POSITION_UPDATED) {
-			position_signaling(self, signals, &(priv->enabled), priv->pos_interval, TRUE, &(priv->pos_updated_timestamp), &(priv->pos), priv->boundary_list, &(priv->zone_status), pos, acc);
+			position_signaling(self, signals, &(priv->enabled), priv->pos_interval_ms, !priv->fix_updates && !priv->batch, &(priv->pos_updated_time), &(priv->pos), &(priv->latest), priv->boundary_index, &(priv->zone_status), pos, acc, received_time);
+			fix_signaling(self, signals, priv->pos_interval_ms, priv->fix_updates && !priv->batch, LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, &(priv->fix_updated_time), &(priv->fix), pos, NULL, acc, NULL, received_time);
+			if (priv->history) history_append(priv->history, pos, acc, received_time);
+			if (priv->batch) batch_signaling(priv->batch, pos, acc);
 			LOCATION_LOGW("Position updated. timestamp [%d]", priv->pos->timestamp);
+			if (priv->zone_duty_cycle && !priv->zone_timer) {
+				priv->zone_sleep_interval = get_zone_sleep_interval(priv->boundary_index, pos, acc, priv->vel);
+				/* The providers are not stopped from their own signal */
+				if (priv->zone_sleep_interval) priv->zone_timer = g_idle_add (_zone_sleep_cb, self);
+			}
 		} else if (type == VELOCITY_UPDATED) {
-			velocity_signaling(self, signals, &(priv->enabled), priv->vel_interval, TRUE, &(priv->vel_updated_timestamp), &(priv->vel), &(priv->acc), vel, acc);
+			velocity_signaling(self, signals, &(priv->enabled), priv->vel_interval_ms, !priv->fix_updates && !priv->batch, &(priv->vel_updated_time), &(priv->vel), &(priv->acc), &(priv->latest), vel, acc, received_time);
+			fix_signaling(self, signals, priv->pos_interval_ms, priv->fix_updates && !priv->batch, LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, &(priv->fix_updated_time), &(priv->fix), NULL, vel, acc, NULL, received_time);
 			LOCATION_LOGW("Velocity updated. timestamp [%d]", priv->vel->timestamp);
 		}
 
@@ -338,6 +398,7 @@ hybrid_service_enabled (GObject *obj,
 		return;
 	}
 	hybrid_get_update_method(priv);
+	if(priv->zone_sleeping) return;
 	if(priv->gps_enabled || priv->wps_enabled)
 		enable_signaling(self, signals, &(priv->enabled), TRUE, status);
 
@@ -358,11 +419,56 @@ hybrid_service_disabled (GObject *obj,
 		return;
 	}
 	hybrid_get_update_method(priv);
+	/* Stopped by the duty cycle, not by the devices */
+	if(priv->zone_sleeping) return;
 	if(!priv->gps_enabled && !priv->wps_enabled)
 		enable_signaling(self, signals, &(priv->enabled), FALSE, status);
 
 }
 
+static gboolean
+_zone_wakeup_cb (gpointer data)
+{
+	LocationHybridPrivate *priv = GET_PRIVATE(data);
+	g_return_val_if_fail (priv, FALSE);
+
+	priv->zone_timer = 0;
+	LOCATION_LOGD("hybrid resumed by zone duty cycle");
+	if (priv->gps) location_start (priv->gps);
+	if (priv->wps) location_start (priv->wps);
+	priv->zone_sleeping = FALSE;
+	return FALSE;
+}
+
+static gboolean
+_zone_sleep_cb (gpointer data)
+{
+	LocationHybridPrivate *priv = GET_PRIVATE(data);
+	g_return_val_if_fail (priv, FALSE);
+
+	priv->zone_timer = 0;
+	if (!priv->is_started || !priv->zone_duty_cycle) return FALSE;
+
+	LOCATION_LOGD("hybrid paused by zone duty cycle for [%u] s", priv->zone_sleep_interval);
+	priv->zone_sleeping = TRUE;
+	if (priv->gps) location_stop (priv->gps);
+	if (priv->wps) location_stop (priv->wps);
+	priv->zone_timer = g_timeout_add_seconds (priv->zone_sleep_interval, _zone_wakeup_cb, data);
+	return FALSE;
+}
+
+/* Returns TRUE if the providers were stopped by the duty cycle */
+static gboolean
+_zone_cancel_sleep (LocationHybridPrivate *priv)
+{
+	gboolean sleeping = priv->zone_sleeping;
+
+	if (priv->zone_timer) g_source_remove (priv->zone_timer);
+	priv->zone_timer = 0;
+	priv->zone_sleeping = FALSE;
+	return sleeping;
+}
+
 static int
 location_hybrid_start (LocationHybrid *self)
 {
@@ -413,6 +519,8 @@ location_hybrid_stop (LocationHybrid *self)
 	int ret_gps = LOCATION_ERROR_NONE;
 	int ret_wps = LOCATION_ERROR_NONE;
 
+	/* Paused providers are already stopped */
+	_zone_cancel_sleep(priv);
 	if(priv->gps) ret_gps = location_stop(priv->gps);
 	if(priv->wps) ret_wps = location_stop(priv->wps);
 
@@ -422,8 +530,8 @@ location_hybrid_stop (LocationHybrid *self)
 		ret_wps != LOCATION_ERROR_NONE)
 		return LOCATION_ERROR_NOT_AVAILABLE;
 
-	if (priv->pos_timer) g_source_remove (priv->pos_timer);
-	if (priv->vel_timer) g_source_remove (priv->vel_timer);
+	if (priv->pos_timer) timer_wheel_remove (priv->pos_timer);
+	if (priv->vel_timer) timer_wheel_remove (priv->vel_timer);
 	priv->pos_timer = 0;
 	priv->vel_timer = 0;
 
@@ -441,8 +549,9 @@ location_hybrid_dispose (GObject *gobject)
 	LOCATION_LOGD("location_hybrid_dispose");
 	LocationHybridPrivate *priv = GET_PRIVATE(gobject);
 
-	if (priv->pos_timer) g_source_remove (priv->pos_timer);
-	if (priv->vel_timer) g_source_remove (priv->vel_timer);
+	_zone_cancel_sleep (priv);
+	if (priv->pos_timer) timer_wheel_remove (priv->pos_timer);
+	if (priv->vel_timer) timer_wheel_remove (priv->vel_timer);
 	priv->pos_timer = 0;
 	priv->vel_timer = 0;
 
@@ -473,23 +582,28 @@ location_hybrid_finalize (GObject *gobject)
 		location_free(priv->wps);
 	}
 
+	if (priv->boundary_index) {
+		boundary_index_free(priv->boundary_index);
+		priv->boundary_index = NULL;
+	}
+
 	if (priv->boundary_list) {
 		g_list_free_full(priv->boundary_list, free_boundary_list);
 		priv->boundary_list = NULL;
 	}
 
 	if (priv->pos) {
-		location_position_free(priv->pos);
+		position_snapshot_unref(priv->pos);
 		priv->pos = NULL;
 	}
 
 	if (priv->vel) {
-		location_velocity_free(priv->vel);
+		velocity_snapshot_unref(priv->vel);
 		priv->vel = NULL;
 	}
 
 	if (priv->acc) {
-		location_accuracy_free(priv->acc);
+		accuracy_snapshot_unref(priv->acc);
 		priv->acc = NULL;
 	}
 
@@ -498,6 +612,21 @@ location_hybrid_finalize (GObject *gobject)
 		priv->sat = NULL;
 	}
 
+	if (priv->fix) {
+		location_fix_free(priv->fix);
+		priv->fix = NULL;
+	}
+
+	if (priv->history) {
+		history_free(priv->history);
+		priv->history = NULL;
+	}
+
+	if (priv->batch) {
+		batch_signaling_free(priv->batch);
+		priv->batch = NULL;
+	}
+
 	G_OBJECT_CLASS (location_hybrid_parent_class)->finalize (gobject);
 }
 
@@ -516,52 +645,92 @@ location_hybrid_set_property (GObject *object,
 	int ret = 0;
 	switch (property_id){
 		case PROP_BOUNDARY:{
-			GList *boundary_list = (GList *)g_list_copy(g_value_get_pointer(value));
-			ret = set_prop_boundary(&priv->boundary_list, boundary_list);
+			GList *boundary_list = (GList *) g_value_get_pointer(value);
+			ret = set_prop_boundary(&priv->boundary_list, priv->boundary_index, boundary_list);
 			if(ret != 0) LOCATION_LOGD("Set boundary. Error[%d]", ret);
 		   break;
 		}
 		case PROP_REMOVAL_BOUNDARY: {
 			LocationBoundary *req_boundary = (LocationBoundary*) g_value_dup_boxed(value);
-			ret = set_prop_removal_boundary(&priv->boundary_list, req_boundary);
+			ret = set_prop_removal_boundary(&priv->boundary_list, priv->boundary_index, req_boundary);
 			if(ret != 0) LOCATION_LOGD("Removal boundary. Error[%d]", ret);
+			if (req_boundary) location_boundary_free(req_boundary);
 			break;
 		}
-		case PROP_POS_INTERVAL: {
-			guint interval = g_value_get_uint(value);
-			if(interval > 0) {
-				if(interval < LOCATION_UPDATE_INTERVAL_MAX)
-					priv->pos_interval = interval;
-				else
-					priv->pos_interval = (guint) LOCATION_UPDATE_INTERVAL_MAX;
-
+		case PROP_REMOVAL_BOUNDARY_LIST: {
+			GList *boundary_list = (GList *) g_value_get_pointer(value);
+			ret = set_prop_removal_boundary_list(&priv->boundary_list, priv->boundary_index, boundary_list);
+			if(ret != 0) LOCATION_LOGD("Removal boundary list. Error[%d]", ret);
+			break;
+		}
+		case PROP_BOUNDARY_STORE: {
+			LocationBoundaryStore *store = (LocationBoundaryStore *) g_value_get_pointer(value);
+			boundary_index_set_store(priv->boundary_index, store);
+			break;
+		}
+		case PROP_ZONE_CROSSING: {
+			gboolean crossing = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> zone-crossing: %d", crossing);
+			boundary_index_set_crossing(priv->boundary_index, crossing);
+			break;
+		}
+		case PROP_SUBSCRIBE_FENCE_SET: {
+			guint handle = g_value_get_uint(value);
+			ret = boundary_index_subscribe(priv->boundary_index, handle);
+			if(ret != 0) LOCATION_LOGD("Subscribe fence set [%u]. Error[%d]", handle, ret);
+			break;
+		}
+		case PROP_UNSUBSCRIBE_FENCE_SET: {
+			guint handle = g_value_get_uint(value);
+			ret = boundary_index_unsubscribe(priv->boundary_index, handle);
+			if(ret != 0) LOCATION_LOGD("Unsubscribe fence set [%u]. Error[%d]", handle, ret);
+			break;
+		}
+		case PROP_ZONE_DUTY_CYCLE: {
+			priv->zone_duty_cycle = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> zone-duty-cycle: %d", priv->zone_duty_cycle);
+			if (!priv->zone_duty_cycle && priv->zone_timer) {
+				if (_zone_cancel_sleep(priv)) _zone_wakeup_cb(object);
 			}
-			else
-				priv->pos_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
+			break;
+		}
+		case PROP_FIX_UPDATES: {
+			priv->fix_updates = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> fix-updates: %d", priv->fix_updates);
+			break;
+		}
+		case PROP_BATCH_SIZE: {
+			priv->batch_size = g_value_get_uint(value);
+			LOCATION_LOGD("Set prop>> batch-size: %u", priv->batch_size);
+			batch_signaling_set(&(priv->batch), object, signals, priv->batch_size, priv->batch_latency);
+			break;
+		}
+		case PROP_BATCH_LATENCY: {
+			priv->batch_latency = g_value_get_uint(value);
+			batch_signaling_set(&(priv->batch), object, signals, priv->batch_size, priv->batch_latency);
+			break;
+		}
+		case PROP_HISTORY_SIZE: {
+			history_set_size(&(priv->history), g_value_get_uint(value));
+			break;
+		}
+		case PROP_POS_INTERVAL:
+		case PROP_POS_INTERVAL_MS: {
+			guint interval = g_value_get_uint(value);
+			if (property_id == PROP_POS_INTERVAL) interval = MIN(interval, LOCATION_UPDATE_INTERVAL_MAX) * 1000;
+			priv->pos_interval_ms = get_update_interval_ms(interval);
 
-			if (priv->pos_timer) {
-				g_source_remove (priv->pos_timer);
-				priv->pos_timer = g_timeout_add (priv->pos_interval * 1000, _position_timeout_cb, object);
-			}
+			if (priv->pos_timer) timer_wheel_set_interval (priv->pos_timer, priv->pos_interval_ms);
 
 			break;
 		}
-		case PROP_VEL_INTERVAL: {
+		case PROP_VEL_INTERVAL:
+		case PROP_VEL_INTERVAL_MS: {
 			guint interval = g_value_get_uint(value);
-			if(interval > 0) {
-				if(interval < LOCATION_UPDATE_INTERVAL_MAX)
-					priv->vel_interval = interval;
-				else
-					priv->vel_interval = (guint) LOCATION_UPDATE_INTERVAL_MAX;
-
-			}
-			else
-				priv->vel_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
+			if (property_id == PROP_VEL_INTERVAL) interval = MIN(interval, LOCATION_UPDATE_INTERVAL_MAX) * 1000;
+			priv->vel_interval_ms = get_update_interval_ms(interval);
 
-			if (priv->vel_timer) {
-				g_source_remove (priv->vel_timer);
-				priv->vel_timer = g_timeout_add (priv->vel_interval * 1000, _velocity_timeout_cb, object);
-			}
+			if (priv->vel_timer) timer_wheel_set_interval (priv->vel_timer, priv->vel_interval_ms);
 
 			break;
 		}
@@ -609,11 +778,35 @@ location_hybrid_get_property (GObject *object,
 	case PROP_BOUNDARY:
 		g_value_set_pointer(value, g_list_first(priv->boundary_list));
 		break;
+	case PROP_ZONE_CROSSING:
+		g_value_set_boolean(value, boundary_index_get_crossing(priv->boundary_index));
+		break;
+	case PROP_ZONE_DUTY_CYCLE:
+		g_value_set_boolean(value, priv->zone_duty_cycle);
+		break;
+	case PROP_FIX_UPDATES:
+		g_value_set_boolean(value, priv->fix_updates);
+		break;
+	case PROP_BATCH_SIZE:
+		g_value_set_uint(value, priv->batch_size);
+		break;
+	case PROP_BATCH_LATENCY:
+		g_value_set_uint(value, priv->batch_latency);
+		break;
+	case PROP_HISTORY_SIZE:
+		g_value_set_uint(value, history_get_size(priv->history));
+		break;
 	case PROP_POS_INTERVAL:
-		g_value_set_uint(value, priv->pos_interval);
+		g_value_set_uint(value, MAX(priv->pos_interval_ms / 1000, LOCATION_UPDATE_INTERVAL_MIN));
 		break;
 	case PROP_VEL_INTERVAL:
-		g_value_set_uint(value, priv->vel_interval);
+		g_value_set_uint(value, MAX(priv->vel_interval_ms / 1000, LOCATION_UPDATE_INTERVAL_MIN));
+		break;
+	case PROP_POS_INTERVAL_MS:
+		g_value_set_uint(value, priv->pos_interval_ms);
+		break;
+	case PROP_VEL_INTERVAL_MS:
+		g_value_set_uint(value, priv->vel_interval_ms);
 		break;
 	case PROP_SAT_INTERVAL:
 		g_value_set_uint(value, priv->sat_interval);
@@ -795,6 +988,135 @@ location_hybrid_get_last_satellite (LocationHybrid *self,
 	return ret;
 }
 
+static int
+location_hybrid_get_fix (LocationHybrid *self,
+	LocationFix **fix)
+{
+	int ret = LOCATION_ERROR_NOT_AVAILABLE;
+	LOCATION_LOGD("location_hybrid_get_fix");
+	if (!location_setting_get_int(VCONFKEY_LOCATION_ENABLED) && !location_setting_get_int(VCONFKEY_LOCATION_NETWORK_ENABLED)) {
+		return LOCATION_ERROR_NOT_ALLOWED;
+	}
+
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+	if (priv->fix) {
+		*fix = location_fix_ref (priv->fix);
+		ret = LOCATION_ERROR_NONE;
+	}
+
+	return ret;
+}
+
+static int
+location_hybrid_get_position_into (LocationHybrid *self,
+	LocationPosition *position,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_hybrid_get_position_into");
+	if (!location_setting_get_int(VCONFKEY_LOCATION_ENABLED) && !location_setting_get_int(VCONFKEY_LOCATION_NETWORK_ENABLED)) {
+		return LOCATION_ERROR_NOT_ALLOWED;
+	}
+
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_POSITION, position, NULL, accuracy);
+}
+
+static int
+location_hybrid_get_velocity_into (LocationHybrid *self,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_hybrid_get_velocity_into");
+	if (!location_setting_get_int(VCONFKEY_LOCATION_ENABLED) && !location_setting_get_int(VCONFKEY_LOCATION_NETWORK_ENABLED)) {
+		return LOCATION_ERROR_NOT_ALLOWED;
+	}
+
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_VELOCITY, NULL, velocity, accuracy);
+}
+
+static int
+location_hybrid_get_latest_fix (LocationHybrid *self,
+	LocationPosition *position,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_hybrid_get_latest_fix");
+	if (!location_setting_get_int(VCONFKEY_LOCATION_ENABLED) && !location_setting_get_int(VCONFKEY_LOCATION_NETWORK_ENABLED)) {
+		return LOCATION_ERROR_NOT_ALLOWED;
+	}
+
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, position, velocity, accuracy);
+}
+
+static int
+location_hybrid_get_satellite_into (LocationHybrid *self,
+	LocationSatellite *satellite,
+	LocationSatelliteDetail *details,
+	guint max_details)
+{
+	LOCATION_LOGD("location_hybrid_get_satellite_into");
+	if (!location_setting_get_int(VCONFKEY_LOCATION_ENABLED) && !location_setting_get_int(VCONFKEY_LOCATION_NETWORK_ENABLED)) {
+		return LOCATION_ERROR_NOT_ALLOWED;
+	}
+
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+
+	return copy_satellite_into (priv->sat, satellite, details, max_details);
+}
+
+static int
+location_hybrid_get_history (LocationHybrid *self,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	guint max,
+	guint *count)
+{
+	LOCATION_LOGD("location_hybrid_get_history");
+	if (!location_setting_get_int(VCONFKEY_LOCATION_ENABLED) && !location_setting_get_int(VCONFKEY_LOCATION_NETWORK_ENABLED)) {
+		return LOCATION_ERROR_NOT_ALLOWED;
+	}
+
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+
+	return history_get_last (priv->history, positions, accuracies, max, count);
+}
+
+static int
+location_hybrid_get_history_range (LocationHybrid *self,
+	gint64 from,
+	gint64 to,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	gint64 *times,
+	guint max,
+	guint *count)
+{
+	LOCATION_LOGD("location_hybrid_get_history_range");
+	if (!location_setting_get_int(VCONFKEY_LOCATION_ENABLED) && !location_setting_get_int(VCONFKEY_LOCATION_NETWORK_ENABLED)) {
+		return LOCATION_ERROR_NOT_ALLOWED;
+	}
+
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+
+	return history_get_range (priv->history, from, to, positions, accuracies, times, max, count);
+}
+
+static int
+location_hybrid_flush_batch (LocationHybrid *self)
+{
+	LOCATION_LOGD("location_hybrid_flush_batch");
+	LocationHybridPrivate *priv = GET_PRIVATE (self);
+
+	if (!priv->batch) return LOCATION_ERROR_NOT_AVAILABLE;
+	batch_flush_signaling (priv->batch);
+	return LOCATION_ERROR_NONE;
+}
+
 static void
 location_ielement_interface_init (LocationIElementInterface *iface)
 {
@@ -806,6 +1128,14 @@ location_ielement_interface_init (LocationIElementInterface *iface)
 	iface->get_last_velocity = (TYPE_GET_VELOCITY)location_hybrid_get_last_velocity;
 	iface->get_satellite = (TYPE_GET_SATELLITE)location_hybrid_get_satellite;
 	iface->get_last_satellite = (TYPE_GET_SATELLITE)location_hybrid_get_last_satellite;
+	iface->get_fix = (TYPE_GET_FIX)location_hybrid_get_fix;
+	iface->get_position_into = (TYPE_GET_POSITION_INTO)location_hybrid_get_position_into;
+	iface->get_velocity_into = (TYPE_GET_VELOCITY_INTO)location_hybrid_get_velocity_into;
+	iface->get_satellite_into = (TYPE_GET_SATELLITE_INTO)location_hybrid_get_satellite_into;
+	iface->get_history = (TYPE_GET_HISTORY)location_hybrid_get_history;
+	iface->get_history_range = (TYPE_GET_HISTORY_RANGE)location_hybrid_get_history_range;
+	iface->flush_batch = (TYPE_FLUSH_BATCH)location_hybrid_flush_batch;
+	iface->get_latest_fix = (TYPE_GET_LATEST_FIX)location_hybrid_get_latest_fix;
 }
 
 static void
@@ -815,13 +1145,14 @@ location_hybrid_init (LocationHybrid *self)
 	LocationHybridPrivate* priv = GET_PRIVATE(self);
 
 	priv->is_started = FALSE;
-	priv->pos_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
-	priv->vel_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
+	priv->pos_interval_ms = LOCATION_UPDATE_INTERVAL_MS_DEFAULT;
+	priv->vel_interval_ms = LOCATION_UPDATE_INTERVAL_MS_DEFAULT;
 	priv->sat_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
 
-	priv->pos_updated_timestamp = 0;
-	priv->vel_updated_timestamp = 0;
+	priv->pos_updated_time = 0;
+	priv->vel_updated_time = 0;
 	priv->sat_updated_timestamp = 0;
+	priv->sat_changed = FALSE;
 
 	priv->gps_enabled = FALSE;
 	priv->wps_enabled = FALSE;
@@ -834,6 +1165,10 @@ location_hybrid_init (LocationHybrid *self)
 	priv->pos_timer = 0;
 	priv->vel_timer = 0;
 
+	priv->zone_duty_cycle = FALSE;
+	priv->zone_sleeping = FALSE;
+	priv->zone_timer = 0;
+
 	if(location_is_supported_method(LOCATION_METHOD_GPS)) priv->gps = location_new (LOCATION_METHOD_GPS);
 	if(location_is_supported_method(LOCATION_METHOD_WPS)) priv->wps = location_new (LOCATION_METHOD_WPS);
 
@@ -855,9 +1190,17 @@ location_hybrid_init (LocationHybrid *self)
 	priv->vel = NULL;
 	priv->acc = NULL;
 	priv->sat = NULL;
+	priv->fix = NULL;
+	priv->fix_updated_time = 0;
+	priv->fix_updates = FALSE;
+	priv->history = NULL;
+	priv->batch = NULL;
+	priv->batch_size = 0;
+	priv->batch_latency = LOCATION_BATCH_LATENCY_DEFAULT;
 
 	priv->zone_status = ZONE_STATUS_NONE;
 	priv->boundary_list = NULL;
+	priv->boundary_index = boundary_index_new();
 
 }
 
@@ -931,6 +1274,32 @@ location_hybrid_class_init (LocationHybridClass *klass)
 			G_TYPE_POINTER,
 			G_TYPE_POINTER);
 
+	signals[ZONE_CHANGED] = g_signal_new ("zone-changed",
+			G_TYPE_FROM_CLASS (klass),
+			G_SIGNAL_RUN_FIRST |
+			G_SIGNAL_NO_RECURSE,
+			G_STRUCT_OFFSET (LocationHybridClass, zone_changed),
+			NULL, NULL,
+			location_VOID__POINTER_POINTER_POINTER_POINTER,
+			G_TYPE_NONE, 4,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER);
+
+	signals[FENCE_CHANGED] = g_signal_new ("fence-changed",
+			G_TYPE_FROM_CLASS (klass),
+			G_SIGNAL_RUN_FIRST |
+			G_SIGNAL_NO_RECURSE,
+			G_STRUCT_OFFSET (LocationHybridClass, fence_changed),
+			NULL, NULL,
+			location_VOID__POINTER_POINTER_POINTER_POINTER,
+			G_TYPE_NONE, 4,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER);
+
 	properties[PROP_METHOD_TYPE] = g_param_spec_int ("method",
 			"method type",
 			"location method type name",
@@ -959,6 +1328,20 @@ location_hybrid_class_init (LocationHybridClass *klass)
 			LOCATION_UPDATE_INTERVAL_MAX,
 			LOCATION_UPDATE_INTERVAL_DEFAULT,
 			G_PARAM_READWRITE);
+	properties[PROP_POS_INTERVAL_MS] = g_param_spec_uint ("pos-interval-ms",
+			"position interval in milliseconds prop",
+			"position interval in milliseconds data",
+			LOCATION_UPDATE_INTERVAL_MS_MIN,
+			LOCATION_UPDATE_INTERVAL_MS_MAX,
+			LOCATION_UPDATE_INTERVAL_MS_DEFAULT,
+			G_PARAM_READWRITE);
+	properties[PROP_VEL_INTERVAL_MS] = g_param_spec_uint ("vel-interval-ms",
+			"velocity interval in milliseconds prop",
+			"velocity interval in milliseconds data",
+			LOCATION_UPDATE_INTERVAL_MS_MIN,
+			LOCATION_UPDATE_INTERVAL_MS_MAX,
+			LOCATION_UPDATE_INTERVAL_MS_DEFAULT,
+			G_PARAM_READWRITE);
 	properties[PROP_SAT_INTERVAL] = g_param_spec_uint ("sat-interval",
 			"satellite interval prop",
 			"satellite interval data",
@@ -978,6 +1361,70 @@ location_hybrid_class_init (LocationHybridClass *klass)
 			LOCATION_TYPE_BOUNDARY,
 			G_PARAM_READWRITE);
 
+	properties[PROP_REMOVAL_BOUNDARY_LIST] = g_param_spec_pointer ("removal-boundary-list",
+			"hybrid removal boundary list prop",
+			"hybrid removal boundary list data",
+			G_PARAM_WRITABLE);
+
+	properties[PROP_BOUNDARY_STORE] = g_param_spec_pointer ("boundary-store",
+			"hybrid boundary store prop",
+			"hybrid memory-mapped boundary store",
+			G_PARAM_WRITABLE);
+
+	properties[PROP_ZONE_CROSSING] = g_param_spec_boolean ("zone-crossing",
+			"hybrid zone crossing prop",
+			"hybrid zone check on the path between positions",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_SUBSCRIBE_FENCE_SET] = g_param_spec_uint ("subscribe-fence-set",
+			"hybrid subscribe fence set prop",
+			"hybrid handle of the shared fence set to watch",
+			0, G_MAXUINT, 0,
+			G_PARAM_WRITABLE);
+
+	properties[PROP_UNSUBSCRIBE_FENCE_SET] = g_param_spec_uint ("unsubscribe-fence-set",
+			"hybrid unsubscribe fence set prop",
+			"hybrid handle of the shared fence set to stop watching",
+			0, G_MAXUINT, 0,
+			G_PARAM_WRITABLE);
+
+	properties[PROP_ZONE_DUTY_CYCLE] = g_param_spec_boolean ("zone-duty-cycle",
+			"hybrid zone duty cycle prop",
+			"hybrid paused while no boundary can be reached",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_FIX_UPDATES] = g_param_spec_boolean ("fix-updates",
+			"hybrid fix updates prop",
+			"hybrid one fix update per epoch instead of position, velocity and satellite updates",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_HISTORY_SIZE] = g_param_spec_uint ("history-size",
+			"history size prop",
+			"number of the last positions kept, 0 for none",
+			0,
+			LOCATION_HISTORY_SIZE_MAX,
+			0,
+			G_PARAM_READWRITE);
+
+	properties[PROP_BATCH_SIZE] = g_param_spec_uint ("batch-size",
+			"batch size prop",
+			"number of positions delivered at once by a BATCH_UPDATED update, 0 for none",
+			0,
+			LOCATION_BATCH_SIZE_MAX,
+			0,
+			G_PARAM_READWRITE);
+
+	properties[PROP_BATCH_LATENCY] = g_param_spec_uint ("batch-latency",
+			"batch latency prop",
+			"maximum seconds a position waits in a batch",
+			1,
+			LOCATION_BATCH_LATENCY_MAX,
+			LOCATION_BATCH_LATENCY_DEFAULT,
+			G_PARAM_READWRITE);
+
 	g_object_class_install_properties (gobject_class,
 			PROP_MAX,
 			properties);
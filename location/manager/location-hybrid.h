@@ -55,6 +55,8 @@ struct _LocationHybridClass
 	void (* updated) (guint type, gpointer data, gpointer accuracy);
 	void (* zone_in) (guint type, gpointer position, gpointer boundary);
 	void (* zone_out) (guint type, gpointer position, gpointer boundary);
+	void (* zone_changed) (gpointer entered, gpointer left, gpointer position, gpointer accuracy);
+	void (* fence_changed) (gpointer entered, gpointer left, gpointer position, gpointer accuracy);
 };
 
 GType location_hybrid_get_type (void);
@@ -25,6 +25,7 @@
 
 #include "location-log.h"
 #include "location-ielement.h"
+#include "location-provider-thread.h"
 
 static void
 location_ielement_base_init (gpointer g_class)
@@ -62,7 +63,10 @@ location_ielement_start (LocationIElement *self)
 {
 	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
 	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->start, LOCATION_ERROR_NOT_AVAILABLE);
-	return LOCATION_IELEMENT_GET_INTERFACE (self)->start (self);
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	int ret = LOCATION_IELEMENT_GET_INTERFACE (self)->start (self);
+	provider_thread_unlock (thread);
+	return ret;
 }
 
 int
@@ -70,7 +74,10 @@ location_ielement_stop (LocationIElement *self)
 {
 	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
 	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->stop, LOCATION_ERROR_NOT_AVAILABLE);
-	return LOCATION_IELEMENT_GET_INTERFACE (self)->stop (self);
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	int ret = LOCATION_IELEMENT_GET_INTERFACE (self)->stop (self);
+	provider_thread_unlock (thread);
+	return ret;
 }
 
 int
@@ -143,3 +150,96 @@ location_ielement_get_last_velocity (LocationIElement *self,
 	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_last_velocity, LOCATION_ERROR_NOT_AVAILABLE);
 	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_last_velocity (self, velocity, accuracy);
 }
+
+int
+location_ielement_get_fix (LocationIElement *self,
+	LocationFix **fix)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (fix, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_fix, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_fix (self, fix);
+}
+
+/* Lock-free, for any thread */
+int
+location_ielement_get_position_into (LocationIElement *self,
+	LocationPosition *position,
+	LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (position, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_position_into, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_position_into (self, position, accuracy);
+}
+
+int
+location_ielement_get_velocity_into (LocationIElement *self,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (velocity, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_velocity_into, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_velocity_into (self, velocity, accuracy);
+}
+
+int
+location_ielement_get_satellite_into (LocationIElement *self,
+	LocationSatellite *satellite,
+	LocationSatelliteDetail *details,
+	guint max_details)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (satellite, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_satellite_into, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_satellite_into (self, satellite, details, max_details);
+}
+
+int
+location_ielement_get_history (LocationIElement *self,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	guint max,
+	guint *count)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (count, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_history, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_history (self, positions, accuracies, max, count);
+}
+
+int
+location_ielement_get_history_range (LocationIElement *self,
+	gint64 from,
+	gint64 to,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	gint64 *times,
+	guint max,
+	guint *count)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (count, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_history_range, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_history_range (self, from, to, positions, accuracies, times, max, count);
+}
+
+int
+location_ielement_flush_batch (LocationIElement *self)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->flush_batch, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->flush_batch (self);
+}
+
+int
+location_ielement_get_latest_fix (LocationIElement *self,
+	LocationPosition *position,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail (LOCATION_IS_IELEMENT (self), LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (LOCATION_IELEMENT_GET_INTERFACE (self)->get_latest_fix, LOCATION_ERROR_NOT_AVAILABLE);
+	return LOCATION_IELEMENT_GET_INTERFACE (self)->get_latest_fix (self, position, velocity, accuracy);
+}
@@ -30,6 +30,7 @@
 #include <location-address.h>
 #include <location-boundary.h>
 #include <location-satellite.h>
+#include <location-fix.h>
 
 /**
  * @file location-ielement.h
@@ -44,6 +45,8 @@ enum {
 	SERVICE_UPDATED,
 	ZONE_IN,
 	ZONE_OUT,
+	ZONE_CHANGED,
+	FENCE_CHANGED,
 	LAST_SIGNAL
 };
 
@@ -60,6 +63,14 @@ typedef int (*TYPE_STOP_FUNC) (LocationIElement *self);
 typedef int (*TYPE_GET_POSITION)(LocationIElement *self, LocationPosition **position, LocationAccuracy **accuracy);
 typedef int (*TYPE_GET_VELOCITY)(LocationIElement *self, LocationVelocity **velocity, LocationAccuracy **accuracy);
 typedef int (*TYPE_GET_SATELLITE)(LocationIElement *self, LocationSatellite **satellite);
+typedef int (*TYPE_GET_FIX)(LocationIElement *self, LocationFix **fix);
+typedef int (*TYPE_GET_POSITION_INTO)(LocationIElement *self, LocationPosition *position, LocationAccuracy *accuracy);
+typedef int (*TYPE_GET_VELOCITY_INTO)(LocationIElement *self, LocationVelocity *velocity, LocationAccuracy *accuracy);
+typedef int (*TYPE_GET_SATELLITE_INTO)(LocationIElement *self, LocationSatellite *satellite, LocationSatelliteDetail *details, guint max_details);
+typedef int (*TYPE_GET_HISTORY)(LocationIElement *self, LocationPosition *positions, LocationAccuracy *accuracies, guint max, guint *count);
+typedef int (*TYPE_GET_HISTORY_RANGE)(LocationIElement *self, gint64 from, gint64 to, LocationPosition *positions, LocationAccuracy *accuracies, gint64 *times, guint max, guint *count);
+typedef int (*TYPE_FLUSH_BATCH)(LocationIElement *self);
+typedef int (*TYPE_GET_LATEST_FIX)(LocationIElement *self, LocationPosition *position, LocationVelocity *velocity, LocationAccuracy *accuracy);
 
 struct _LocationIElementInterface
 {
@@ -73,6 +84,14 @@ struct _LocationIElementInterface
 	TYPE_GET_VELOCITY get_last_velocity;
 	TYPE_GET_SATELLITE get_satellite;
 	TYPE_GET_SATELLITE get_last_satellite;
+	TYPE_GET_FIX get_fix;
+	TYPE_GET_POSITION_INTO get_position_into;
+	TYPE_GET_VELOCITY_INTO get_velocity_into;
+	TYPE_GET_SATELLITE_INTO get_satellite_into;
+	TYPE_GET_HISTORY get_history;
+	TYPE_GET_HISTORY_RANGE get_history_range;
+	TYPE_FLUSH_BATCH flush_batch;
+	TYPE_GET_LATEST_FIX get_latest_fix;
 };
 
 GType location_ielement_get_type (void);
@@ -85,6 +104,14 @@ int location_ielement_get_velocity (LocationIElement *self, LocationVelocity **v
 int location_ielement_get_last_velocity (LocationIElement *self, LocationVelocity **velocity, LocationAccuracy **accuracy);
 int location_ielement_get_satellite (LocationIElement *self, LocationSatellite **satellite);
 int location_ielement_get_last_satellite (LocationIElement *self, LocationSatellite **satellite);
+int location_ielement_get_fix (LocationIElement *self, LocationFix **fix);
+int location_ielement_get_position_into (LocationIElement *self, LocationPosition *position, LocationAccuracy *accuracy);
+int location_ielement_get_velocity_into (LocationIElement *self, LocationVelocity *velocity, LocationAccuracy *accuracy);
+int location_ielement_get_satellite_into (LocationIElement *self, LocationSatellite *satellite, LocationSatelliteDetail *details, guint max_details);
+int location_ielement_get_history (LocationIElement *self, LocationPosition *positions, LocationAccuracy *accuracies, guint max, guint *count);
+int location_ielement_get_history_range (LocationIElement *self, gint64 from, gint64 to, LocationPosition *positions, LocationAccuracy *accuracies, gint64 *times, guint max, guint *count);
+int location_ielement_flush_batch (LocationIElement *self);
+int location_ielement_get_latest_fix (LocationIElement *self, LocationPosition *position, LocationVelocity *velocity, LocationAccuracy *accuracy);
 
 G_END_DECLS
 
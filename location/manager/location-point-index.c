@@ -0,0 +1,488 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include "location-point-index.h"
+#include "location-geodesic.h"
+#include "location-log.h"
+
+/* A subtree is rebuilt when one of its children holds more than this share of its nodes */
+#define POINT_INDEX_ALPHA	0.7
+
+/**
+ * Each point is a node of the KD-tree, stored in one array by slot, and the id of a point is its slot + 1.
+ * The tree is built balanced with the median on the axis of largest spread. Insertions go down to a leaf,
+ * and when one lands deeper than a balanced tree of 1 / ALPHA would be, the lowest unbalanced subtree on its
+ * path is rebuilt (scapegoat tree). A removed point stays in the tree as a split plane until the subtree is
+ * rebuilt, and the whole tree is rebuilt once removed points outnumber the others.
+ */
+typedef enum {
+	POINT_FREE = 0,
+	POINT_ALIVE,
+	POINT_REMOVED
+} PointState;
+
+typedef struct {
+	gdouble ecef[3];
+	gdouble latitude;
+	gdouble longitude;
+	gpointer data;
+	gint left;		/* slots of the children, -1 for none */
+	gint right;
+	guint size;		/* nodes of the subtree, removed ones included */
+	guint axis;
+	PointState state;
+} PointNode;
+
+typedef struct {
+	gdouble distance2;	/* squared straight distance */
+	gint slot;
+} PointCandidate;
+
+struct _LocationPointIndex {
+	GArray *nodes;		/* PointNode by slot */
+	GArray *free_slots;
+	gint root;
+	guint alive;
+	guint removed;
+	GArray *path;		/* slots from the root, reused by insertions */
+	GArray *build;		/* slots being rebuilt */
+	GArray *candidates;	/* PointCandidate, a max-heap during nearest queries */
+	GArray *targets;	/* LocationPosition of the candidates */
+	GArray *distances;
+	GArray *matches;
+};
+
+#define NODE(index, slot)	(&g_array_index ((index)->nodes, PointNode, (slot)))
+
+static guint
+_subtree_size (const LocationPointIndex *index, gint slot)
+{
+	return slot < 0 ? 0 : NODE(index, slot)->size;
+}
+
+static void
+_select_median (const LocationPointIndex *index, guint *slots, guint count, guint k, guint axis)
+{
+	guint lo = 0, hi = count;
+
+	/* Three way partitions, so that many points on the same coordinate stay linear */
+	while (hi - lo > 1) {
+		gdouble pivot = NODE(index, slots[lo + (hi - lo) / 2])->ecef[axis];
+		guint lt = lo, i = lo, gt = hi, tmp;
+
+		while (i < gt) {
+			gdouble value = NODE(index, slots[i])->ecef[axis];
+			if (value < pivot) {
+				tmp = slots[lt]; slots[lt++] = slots[i]; slots[i++] = tmp;
+			} else if (value > pivot) {
+				tmp = slots[--gt]; slots[gt] = slots[i]; slots[i] = tmp;
+			} else {
+				i++;
+			}
+		}
+		if (k < lt) hi = lt;
+		else if (k >= gt) lo = gt;
+		else return;
+	}
+}
+
+static gint
+_build (LocationPointIndex *index, guint *slots, guint count)
+{
+	gdouble lo[3] = { G_MAXDOUBLE, G_MAXDOUBLE, G_MAXDOUBLE };
+	gdouble hi[3] = { -G_MAXDOUBLE, -G_MAXDOUBLE, -G_MAXDOUBLE };
+	guint i, axis, mid;
+	PointNode *node = NULL;
+
+	if (!count) return -1;
+
+	for (i = 0; i < count; i++) {
+		const gdouble *ecef = NODE(index, slots[i])->ecef;
+		for (axis = 0; axis < 3; axis++) {
+			lo[axis] = MIN(lo[axis], ecef[axis]);
+			hi[axis] = MAX(hi[axis], ecef[axis]);
+		}
+	}
+	axis = (hi[0] - lo[0] >= hi[1] - lo[1]) ? 0 : 1;
+	if (hi[2] - lo[2] > hi[axis] - lo[axis]) axis = 2;
+
+	mid = count / 2;
+	_select_median (index, slots, count, mid, axis);
+
+	node = NODE(index, slots[mid]);
+	node->axis = axis;
+	node->size = count;
+	node->left = _build (index, slots, mid);
+	node->right = _build (index, slots + mid + 1, count - mid - 1);
+
+	return slots[mid];
+}
+
+/* Rebuild the subtree at slot without its removed points, returns its new root */
+static gint
+_rebuild (LocationPointIndex *index, gint slot)
+{
+	guint i = 0;
+	gint cur;
+
+	g_array_set_size (index->build, 0);
+	if (slot >= 0) g_array_append_val (index->build, slot);
+
+	/* The build array is the walk queue, then keeps only the points alive */
+	while (i < index->build->len) {
+		PointNode *node = NODE(index, g_array_index (index->build, guint, i));
+		if (node->left >= 0) g_array_append_val (index->build, node->left);
+		if (node->right >= 0) g_array_append_val (index->build, node->right);
+		i++;
+	}
+	for (i = 0, cur = 0; i < index->build->len; i++) {
+		guint s = g_array_index (index->build, guint, i);
+		if (NODE(index, s)->state == POINT_REMOVED) {
+			NODE(index, s)->state = POINT_FREE;
+			g_array_append_val (index->free_slots, s);
+			index->removed--;
+		} else {
+			g_array_index (index->build, guint, cur++) = s;
+		}
+	}
+	g_array_set_size (index->build, cur);
+
+	return _build (index, (guint *) index->build->data, index->build->len);
+}
+
+static void
+_rebuild_all (LocationPointIndex *index)
+{
+	index->root = _rebuild (index, index->root);
+}
+
+static gint
+_new_node (LocationPointIndex *index, const LocationPosition *position, gpointer data)
+{
+	PointNode *node = NULL;
+	gint slot;
+
+	if (index->free_slots->len) {
+		slot = g_array_index (index->free_slots, guint, index->free_slots->len - 1);
+		g_array_set_size (index->free_slots, index->free_slots->len - 1);
+	} else {
+		slot = index->nodes->len;
+		g_array_set_size (index->nodes, slot + 1);
+	}
+
+	node = NODE(index, slot);
+	geodesic_to_ecef (position->latitude, position->longitude, 0, node->ecef);
+	node->latitude = position->latitude;
+	node->longitude = position->longitude;
+	node->data = data;
+	node->left = node->right = -1;
+	node->size = 1;
+	node->axis = 0;
+	node->state = POINT_ALIVE;
+	index->alive++;
+
+	return slot;
+}
+
+EXPORT_API LocationPointIndex *
+location_point_index_new (GList *position_list)
+{
+	LocationPointIndex *index = g_slice_new0 (LocationPointIndex);
+	GList *cur = NULL;
+	gint slot;
+
+	index->nodes = g_array_new (FALSE, TRUE, sizeof (PointNode));
+	index->free_slots = g_array_new (FALSE, FALSE, sizeof (guint));
+	index->root = -1;
+	index->path = g_array_new (FALSE, FALSE, sizeof (gint));
+	index->build = g_array_new (FALSE, FALSE, sizeof (guint));
+	index->candidates = g_array_new (FALSE, FALSE, sizeof (PointCandidate));
+	index->targets = g_array_new (FALSE, TRUE, sizeof (LocationPosition));
+	index->distances = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	index->matches = g_array_new (FALSE, FALSE, sizeof (LocationPointMatch));
+
+	/* Built balanced at once rather than point by point */
+	for (cur = position_list; cur; cur = g_list_next (cur)) {
+		if (cur->data == NULL) continue;
+		_new_node (index, (LocationPosition *) cur->data, cur->data);
+	}
+	if (index->alive) {
+		g_array_set_size (index->build, 0);
+		for (slot = 0; slot < (gint) index->nodes->len; slot++) g_array_append_val (index->build, slot);
+		index->root = _build (index, (guint *) index->build->data, index->build->len);
+	}
+
+	return index;
+}
+
+EXPORT_API void
+location_point_index_free (LocationPointIndex *index)
+{
+	g_return_if_fail (index);
+
+	g_array_free (index->nodes, TRUE);
+	g_array_free (index->free_slots, TRUE);
+	g_array_free (index->path, TRUE);
+	g_array_free (index->build, TRUE);
+	g_array_free (index->candidates, TRUE);
+	g_array_free (index->targets, TRUE);
+	g_array_free (index->distances, TRUE);
+	g_array_free (index->matches, TRUE);
+	g_slice_free (LocationPointIndex, index);
+}
+
+EXPORT_API int
+location_point_index_insert (LocationPointIndex *index, const LocationPosition *position, gpointer data, guint *point_id)
+{
+	g_return_val_if_fail (index, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (position, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (point_id, LOCATION_ERROR_PARAMETER);
+
+	gint slot = _new_node (index, position, data);
+	gint cur = index->root;
+	gint *child = &index->root;
+	guint total = index->alive + index->removed;
+	gint i;
+
+	*point_id = slot + 1;
+
+	g_array_set_size (index->path, 0);
+	while (cur >= 0) {
+		PointNode *node = NODE(index, cur);
+		g_array_append_val (index->path, cur);
+		node->size++;
+		child = (NODE(index, slot)->ecef[node->axis] < node->ecef[node->axis]) ? &node->left : &node->right;
+		cur = *child;
+	}
+	*child = slot;
+	if (index->path->len) NODE(index, slot)->axis = (NODE(index, g_array_index (index->path, gint, index->path->len - 1))->axis + 1) % 3;
+
+	if (index->path->len <= log (total) / log (1 / POINT_INDEX_ALPHA) + 1) return LOCATION_ERROR_NONE;
+
+	/* Too deep: rebuild at the lowest ancestor with an unbalanced child */
+	for (i = index->path->len - 1; i >= 0; i--) {
+		PointNode *node = NODE(index, g_array_index (index->path, gint, i));
+		guint removed = index->removed;
+		gint rebuilt;
+
+		if (MAX(_subtree_size (index, node->left), _subtree_size (index, node->right)) <= POINT_INDEX_ALPHA * node->size) continue;
+
+		rebuilt = _rebuild (index, g_array_index (index->path, gint, i));
+		if (i == 0) {
+			index->root = rebuilt;
+		} else {
+			PointNode *parent = NODE(index, g_array_index (index->path, gint, i - 1));
+			if (parent->left == g_array_index (index->path, gint, i)) parent->left = rebuilt;
+			else parent->right = rebuilt;
+		}
+		/* Removed points dropped by the rebuild leave the ancestors too */
+		for (i--; i >= 0 && removed != index->removed; i--) NODE(index, g_array_index (index->path, gint, i))->size -= removed - index->removed;
+		break;
+	}
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_point_index_remove (LocationPointIndex *index, guint point_id)
+{
+	g_return_val_if_fail (index, LOCATION_ERROR_PARAMETER);
+
+	PointNode *node = NULL;
+
+	if (point_id == 0 || point_id > index->nodes->len) return LOCATION_ERROR_NOT_FOUND;
+	node = NODE(index, point_id - 1);
+	if (node->state != POINT_ALIVE) return LOCATION_ERROR_NOT_FOUND;
+
+	node->state = POINT_REMOVED;
+	node->data = NULL;
+	index->alive--;
+	index->removed++;
+
+	if (index->removed > index->alive) _rebuild_all (index);
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API guint
+location_point_index_size (const LocationPointIndex *index)
+{
+	g_return_val_if_fail (index, 0);
+
+	return index->alive;
+}
+
+static gdouble
+_distance2 (const gdouble *a, const gdouble *b)
+{
+	gdouble dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+	return dx * dx + dy * dy + dz * dz;
+}
+
+/* Max-heap on the squared distance, the root is the farthest of the k kept */
+static void
+_push_candidate (GArray *heap, guint k, gdouble distance2, gint slot)
+{
+	PointCandidate *c = NULL;
+	PointCandidate item = { distance2, slot };
+	guint i, child;
+
+	if (heap->len < k) {
+		g_array_append_val (heap, item);
+		c = (PointCandidate *) heap->data;
+		for (i = heap->len - 1; i > 0 && c[(i - 1) / 2].distance2 < item.distance2; i = (i - 1) / 2) c[i] = c[(i - 1) / 2];
+		c[i] = item;
+		return;
+	}
+
+	c = (PointCandidate *) heap->data;
+	if (distance2 >= c[0].distance2) return;
+	for (i = 0; (child = 2 * i + 1) < heap->len; i = child) {
+		if (child + 1 < heap->len && c[child + 1].distance2 > c[child].distance2) child++;
+		if (c[child].distance2 <= distance2) break;
+		c[i] = c[child];
+	}
+	c[i] = item;
+}
+
+static void
+_search_nearest (LocationPointIndex *index, gint slot, const gdouble *ecef, guint k)
+{
+	while (slot >= 0) {
+		PointNode *node = NODE(index, slot);
+		gdouble delta = ecef[node->axis] - node->ecef[node->axis];
+		GArray *heap = index->candidates;
+
+		if (node->state == POINT_ALIVE) _push_candidate (heap, k, _distance2 (ecef, node->ecef), slot);
+
+		/* Near side first, then the far one only when the split plane is closer than the k-th point */
+		_search_nearest (index, delta < 0 ? node->left : node->right, ecef, k);
+		if (heap->len == k && delta * delta >= g_array_index (heap, PointCandidate, 0).distance2) return;
+		slot = delta < 0 ? node->right : node->left;
+	}
+}
+
+static void
+_search_within (LocationPointIndex *index, gint slot, const gdouble *ecef, gdouble radius2)
+{
+	while (slot >= 0) {
+		PointNode *node = NODE(index, slot);
+		gdouble delta = ecef[node->axis] - node->ecef[node->axis];
+		gdouble distance2 = _distance2 (ecef, node->ecef);
+
+		if (node->state == POINT_ALIVE && distance2 <= radius2) {
+			PointCandidate item = { distance2, slot };
+			g_array_append_val (index->candidates, item);
+		}
+
+		if (delta * delta <= radius2) _search_within (index, delta < 0 ? node->right : node->left, ecef, radius2);
+		slot = delta < 0 ? node->left : node->right;
+	}
+}
+
+static gint
+_compare_match (gconstpointer a, gconstpointer b)
+{
+	gdouble da = ((const LocationPointMatch *) a)->distance;
+	gdouble db = ((const LocationPointMatch *) b)->distance;
+	return (da > db) - (da < db);
+}
+
+/* Surface distances of the candidates, sorted, and only those below the radius if one is given */
+static void
+_fill_matches (LocationPointIndex *index, const LocationPosition *position, gdouble radius)
+{
+	guint i, count = index->candidates->len;
+	LocationPosition *targets = NULL;
+	gdouble *distances = NULL;
+
+	g_array_set_size (index->targets, count);
+	g_array_set_size (index->distances, count);
+	targets = (LocationPosition *) index->targets->data;
+	distances = (gdouble *) index->distances->data;
+	for (i = 0; i < count; i++) {
+		PointNode *node = NODE(index, g_array_index (index->candidates, PointCandidate, i).slot);
+		targets[i].latitude = node->latitude;
+		targets[i].longitude = node->longitude;
+	}
+	if (count) geodesic_vincenty_batch (position->latitude, position->longitude, targets, count, distances);
+
+	g_array_set_size (index->matches, 0);
+	for (i = 0; i < count; i++) {
+		gint slot = g_array_index (index->candidates, PointCandidate, i).slot;
+		LocationPointMatch match;
+
+		/* Nearly antipodal points do not converge */
+		match.distance = isnan (distances[i]) ? geodesic_haversine (position->latitude, position->longitude,
+							targets[i].latitude, targets[i].longitude) : distances[i];
+		if (radius >= 0 && match.distance >= radius) continue;
+
+		match.point_id = slot + 1;
+		match.data = NODE(index, slot)->data;
+		g_array_append_val (index->matches, match);
+	}
+	g_array_sort (index->matches, _compare_match);
+}
+
+EXPORT_API int
+location_point_index_nearest (LocationPointIndex *index, const LocationPosition *position, guint k, GArray **matches)
+{
+	g_return_val_if_fail (index, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (position, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (matches, LOCATION_ERROR_PARAMETER);
+
+	gdouble ecef[3];
+
+	geodesic_to_ecef (position->latitude, position->longitude, 0, ecef);
+	g_array_set_size (index->candidates, 0);
+	if (k) _search_nearest (index, index->root, ecef, k);
+
+	_fill_matches (index, position, -1);
+	*matches = index->matches;
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_point_index_within (LocationPointIndex *index, const LocationPosition *position, gdouble radius, GArray **matches)
+{
+	g_return_val_if_fail (index, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (position, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (radius >= 0, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (matches, LOCATION_ERROR_PARAMETER);
+
+	gdouble ecef[3];
+
+	/* The straight distance is never longer than the surface one */
+	geodesic_to_ecef (position->latitude, position->longitude, 0, ecef);
+	g_array_set_size (index->candidates, 0);
+	_search_within (index, index->root, ecef, radius * radius);
+
+	_fill_matches (index, position, radius);
+	*matches = index->matches;
+
+	return LOCATION_ERROR_NONE;
+}
@@ -0,0 +1,163 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_POINT_INDEX_H_
+#define __LOCATION_POINT_INDEX_H_
+
+#include <location-types.h>
+#include <location-position.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @file location-point-index.h
+ * @brief This file contains the definitions, structures, and functions related to the nearest point index.
+ */
+/**
+ * @addtogroup LocationAPI
+ * @{
+ * @defgroup LocationAPIPointIndex Location Point Index
+ * @breif This provides APIs related to the nearest point search over a set of positions
+ * @addtogroup LocationAPIPointIndex
+ * @{
+ */
+
+/**
+ * @brief This represents a point found by #location_point_index_nearest or #location_point_index_within.
+ */
+typedef struct {
+	guint point_id;		///< The id given by #location_point_index_insert.
+	gpointer data;		///< The data given with the point.
+	gdouble distance;	///< The distance to the queried position on the WGS84 ellipsoid, in meters.
+} LocationPointMatch;
+
+typedef struct _LocationPointIndex LocationPointIndex;
+
+/**
+ * @brief
+ * Create an index for the nearest points to a position.
+ * @remarks Points are kept in a KD-tree over their earth-centered coordinates, so a query visits a few nodes instead of every point. \n
+    The altitude is ignored, points and queries are taken on the surface of the ellipsoid.
+    When position_list is given, its positions are inserted in order with ids from 1 and each position itself as data.
+    The index keeps no reference to the positions.
+ * @pre     None.
+ * @post    #location_point_index_free should be called when the index is no longer needed.
+ * @param [in]  position_list - a list of #LocationPosition, or NULL for an empty index
+ * @return a new #LocationPointIndex
+ * @retval NULL if error occured
+ */
+LocationPointIndex *location_point_index_new (GList *position_list);
+
+/**
+ * @brief
+ * Free a #LocationPointIndex.
+ * @remarks The data of the points is not freed.
+ * @pre     #location_point_index_new should be called before.\n
+ * @post None.
+ * @param [in]  index - a #LocationPointIndex
+ * @return None.
+ */
+void location_point_index_free (LocationPointIndex *index);
+
+/**
+ * @brief
+ * Insert a point.
+ * @remarks The tree is rebalanced locally when an insertion makes it too deep.
+ * @pre     #location_point_index_new should be called before.\n
+ * @post None.
+ * @param [in]  index - a #LocationPointIndex
+ * @param [in]  position - a #LocationPosition
+ * @param [in]  data - user data returned with the point
+ * @param [out] point_id - the id of the point, never 0
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_point_index_insert (LocationPointIndex *index, const LocationPosition *position, gpointer data, guint *point_id);
+
+/**
+ * @brief
+ * Remove a point.
+ * @remarks The id can be given again to a later point.
+ * @pre     #location_point_index_new should be called before.\n
+ * @post None.
+ * @param [in]  index - a #LocationPointIndex
+ * @param [in]  point_id - the id given by #location_point_index_insert
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_NOT_FOUND       No such point
+ * Please refer #LocationError for more information.
+ */
+int location_point_index_remove (LocationPointIndex *index, guint point_id);
+
+/**
+ * @brief
+ * Get the number of points.
+ * @remarks None.
+ * @pre     #location_point_index_new should be called before.\n
+ * @post None.
+ * @param [in]  index - a #LocationPointIndex
+ * @return guint
+ */
+guint location_point_index_size (const LocationPointIndex *index);
+
+/**
+ * @brief
+ * Find the k nearest points to a position.
+ * @remarks The points are ranked by the straight distance between them, which orders them as the surface distance does
+    up to near ties of a few millimeters. matches is sorted by distance and has fewer than k points only when the index does. \n
+    matches is a GArray of #LocationPointMatch owned by the index, valid until the next query or change of the index.
+ * @pre     #location_point_index_new should be called before.\n
+ * @post None.
+ * @param [in]  index - a #LocationPointIndex
+ * @param [in]  position - a #LocationPosition
+ * @param [in]  k - the number of points
+ * @param [out] matches - a GArray of #LocationPointMatch
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_point_index_nearest (LocationPointIndex *index, const LocationPosition *position, guint k, GArray **matches);
+
+/**
+ * @brief
+ * Find the points closer to a position than a radius.
+ * @remarks matches is sorted by distance. \n
+    matches is a GArray of #LocationPointMatch owned by the index, valid until the next query or change of the index.
+ * @pre     #location_point_index_new should be called before.\n
+ * @post None.
+ * @param [in]  index - a #LocationPointIndex
+ * @param [in]  position - a #LocationPosition
+ * @param [in]  radius - the radius in meters
+ * @param [out] matches - a GArray of #LocationPointMatch
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_point_index_within (LocationPointIndex *index, const LocationPosition *position, gdouble radius, GArray **matches);
+
+/**
+ * @} @}
+ */
+
+G_END_DECLS
+
+#endif
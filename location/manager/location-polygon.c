@@ -0,0 +1,400 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include "location-polygon.h"
+#include "location-position.h"
+#include "location-geodesic.h"
+#include "location-log.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define POLYGON_LANES	4
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define POLYGON_LANES	2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define POLYGON_LANES	2
+#else
+#define POLYGON_LANES	1
+#endif
+
+/* Edges are padded to this many entries so that every kernel runs without a tail loop. */
+#define POLYGON_EDGE_BLOCK	4
+
+/* An edge crossing the 180th meridian, tested as in the original list walk. */
+typedef struct {
+	gdouble lat1;
+	gdouble lon1;
+	gdouble lat2;
+	gdouble lon2;
+	gdouble slope;
+} PolygonWrapEdge;
+
+/**
+ * Crossing-number edge table of a polygon.
+ * Edge i runs from the previous vertex (lat0, lon0) to the current one. It is crossed by the ray of a
+ * position when lo_lon <= longitude < hi_lon and latitude < slope * (longitude - lon0) + lat0,
+ * which is the same test the list walk does, laid out as contiguous arrays for the vector kernels.
+ */
+struct _LocationPolygonEdges {
+	guint n_edges;
+	gdouble *lo_lon;
+	gdouble *hi_lon;
+	gdouble *lon0;
+	gdouble *lat0;
+	gdouble *slope;
+	guint n_wrap_edges;
+	PolygonWrapEdge *wrap_edges;
+};
+
+#if defined(__AVX__)
+static guint
+_count_crossing_edges (const LocationPolygonEdges *edges, gdouble latitude, gdouble longitude)
+{
+	guint i;
+	gdouble lanes[4];
+	__m256d lat = _mm256_set1_pd(latitude);
+	__m256d lon = _mm256_set1_pd(longitude);
+	__m256d one = _mm256_set1_pd(1.0);
+	__m256d crossing = _mm256_setzero_pd();
+
+	for (i = 0; i < edges->n_edges; i += 4) {
+		__m256d in = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(edges->lo_lon + i), lon, _CMP_LE_OQ),
+							_mm256_cmp_pd(lon, _mm256_loadu_pd(edges->hi_lon + i), _CMP_LT_OQ));
+		__m256d y = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(edges->slope + i),
+							_mm256_sub_pd(lon, _mm256_loadu_pd(edges->lon0 + i))),
+							_mm256_loadu_pd(edges->lat0 + i));
+		in = _mm256_and_pd(in, _mm256_cmp_pd(lat, y, _CMP_LT_OQ));
+		crossing = _mm256_add_pd(crossing, _mm256_and_pd(in, one));
+	}
+	_mm256_storeu_pd(lanes, crossing);
+	return (guint) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+#elif defined(__SSE2__)
+static guint
+_count_crossing_edges (const LocationPolygonEdges *edges, gdouble latitude, gdouble longitude)
+{
+	guint i;
+	gdouble lanes[2];
+	__m128d lat = _mm_set1_pd(latitude);
+	__m128d lon = _mm_set1_pd(longitude);
+	__m128d one = _mm_set1_pd(1.0);
+	__m128d crossing = _mm_setzero_pd();
+
+	for (i = 0; i < edges->n_edges; i += 2) {
+		__m128d in = _mm_and_pd(_mm_cmple_pd(_mm_loadu_pd(edges->lo_lon + i), lon),
+							_mm_cmplt_pd(lon, _mm_loadu_pd(edges->hi_lon + i)));
+		__m128d y = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(edges->slope + i),
+							_mm_sub_pd(lon, _mm_loadu_pd(edges->lon0 + i))),
+							_mm_loadu_pd(edges->lat0 + i));
+		in = _mm_and_pd(in, _mm_cmplt_pd(lat, y));
+		crossing = _mm_add_pd(crossing, _mm_and_pd(in, one));
+	}
+	_mm_storeu_pd(lanes, crossing);
+	return (guint) (lanes[0] + lanes[1]);
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+static guint
+_count_crossing_edges (const LocationPolygonEdges *edges, gdouble latitude, gdouble longitude)
+{
+	guint i;
+	float64x2_t lat = vdupq_n_f64(latitude);
+	float64x2_t lon = vdupq_n_f64(longitude);
+	int64x2_t crossing = vdupq_n_s64(0);
+
+	for (i = 0; i < edges->n_edges; i += 2) {
+		uint64x2_t in = vandq_u64(vcleq_f64(vld1q_f64(edges->lo_lon + i), lon),
+							vcltq_f64(lon, vld1q_f64(edges->hi_lon + i)));
+		float64x2_t y = vaddq_f64(vmulq_f64(vld1q_f64(edges->slope + i),
+							vsubq_f64(lon, vld1q_f64(edges->lon0 + i))),
+							vld1q_f64(edges->lat0 + i));
+		in = vandq_u64(in, vcltq_f64(lat, y));
+		crossing = vsubq_s64(crossing, vreinterpretq_s64_u64(in));	/* a set lane is -1 */
+	}
+	return (guint) (vgetq_lane_s64(crossing, 0) + vgetq_lane_s64(crossing, 1));
+}
+#else
+static guint
+_count_crossing_edges (const LocationPolygonEdges *edges, gdouble latitude, gdouble longitude)
+{
+	guint i, crossing = 0;
+
+	for (i = 0; i < edges->n_edges; i++) {
+		if (edges->lo_lon[i] <= longitude && longitude < edges->hi_lon[i] &&
+			latitude < edges->slope[i] * (longitude - edges->lon0[i]) + edges->lat0[i])
+			crossing++;
+	}
+	return crossing;
+}
+#endif
+
+static guint
+_count_crossing_wrap_edges (const LocationPolygonEdges *edges, gdouble latitude, gdouble longitude)
+{
+	guint i, crossing = 0;
+	gdouble x0, y0;
+
+	for (i = 0; i < edges->n_wrap_edges; i++) {
+		const PolygonWrapEdge *edge = &edges->wrap_edges[i];
+
+		if ((edge->lon1 > longitude) != (edge->lon2 > longitude))
+			continue;
+
+		if (edge->lon2 * longitude > 0) {
+			x0 = edge->lat2;
+			y0 = edge->lon2;
+		} else {
+			x0 = edge->lat1;
+			y0 = edge->lon1;
+		}
+
+		if (latitude < edge->slope * (longitude - y0) + x0)
+			crossing++;
+	}
+	return crossing;
+}
+
+LocationPolygonEdges *
+polygon_edges_new (GList *position_list)
+{
+	g_return_val_if_fail(position_list, NULL);
+
+	guint count = g_list_length(position_list);
+	guint padded = (count + POLYGON_EDGE_BLOCK - 1) / POLYGON_EDGE_BLOCK * POLYGON_EDGE_BLOCK;
+	LocationPolygonEdges *edges = g_slice_new0(LocationPolygonEdges);
+	LocationPosition *prev = g_list_last(position_list)->data;
+	GList *iter = NULL;
+	gdouble *buffer = g_new(gdouble, padded * 5);
+
+	edges->lo_lon = buffer;
+	edges->hi_lon = buffer + padded;
+	edges->lon0 = buffer + padded * 2;
+	edges->lat0 = buffer + padded * 3;
+	edges->slope = buffer + padded * 4;
+
+	for (iter = g_list_first(position_list); iter; iter = g_list_next(iter)) {
+		LocationPosition *pos = iter->data;
+		gdouble interval_y = pos->longitude - prev->longitude;
+		gdouble interval_x = pos->latitude - prev->latitude;
+
+		if (interval_y > 180 || interval_y < -180) {
+			PolygonWrapEdge *edge = NULL;
+
+			if (!edges->wrap_edges) edges->wrap_edges = g_new(PolygonWrapEdge, count);
+			edge = &edges->wrap_edges[edges->n_wrap_edges++];
+			edge->lat1 = pos->latitude;
+			edge->lon1 = pos->longitude;
+			edge->lat2 = prev->latitude;
+			edge->lon2 = prev->longitude;
+			edge->slope = interval_x / (interval_y > 180 ? interval_y - 360 : interval_y + 360);
+		} else {
+			guint i = edges->n_edges++;
+
+			edges->lo_lon[i] = MIN(pos->longitude, prev->longitude);
+			edges->hi_lon[i] = MAX(pos->longitude, prev->longitude);
+			edges->lon0[i] = prev->longitude;
+			edges->lat0[i] = prev->latitude;
+			edges->slope[i] = interval_y != 0 ? interval_x / interval_y : 0;
+		}
+		prev = pos;
+	}
+
+	/* Padding edges have an empty longitude range and are never crossed. */
+	while (edges->n_edges % POLYGON_EDGE_BLOCK) {
+		guint i = edges->n_edges++;
+
+		edges->lo_lon[i] = G_MAXDOUBLE;
+		edges->hi_lon[i] = -G_MAXDOUBLE;
+		edges->lon0[i] = 0;
+		edges->lat0[i] = 0;
+		edges->slope[i] = 0;
+	}
+
+	if (edges->wrap_edges) edges->wrap_edges = g_renew(PolygonWrapEdge, edges->wrap_edges, edges->n_wrap_edges);
+
+	LOCATION_LOGD("polygon edges [%d], wrapped [%d], lanes [%d]", count - edges->n_wrap_edges, edges->n_wrap_edges, POLYGON_LANES);
+	return edges;
+}
+
+void
+polygon_edges_free (LocationPolygonEdges *edges)
+{
+	g_return_if_fail(edges);
+
+	g_free(edges->lo_lon);
+	g_free(edges->wrap_edges);
+	g_slice_free(LocationPolygonEdges, edges);
+}
+
+guint
+polygon_edges_count_crossing (const LocationPolygonEdges *edges, gdouble latitude, gdouble longitude)
+{
+	g_return_val_if_fail(edges, 0);
+
+	return _count_crossing_edges(edges, latitude, longitude) + _count_crossing_wrap_edges(edges, latitude, longitude);
+}
+
+guint
+polygon_vertices_count_crossing (const gdouble *vertices, guint count, gdouble latitude, gdouble longitude)
+{
+	g_return_val_if_fail(vertices, 0);
+
+	guint i, crossing = 0;
+	const gdouble *pos = NULL;
+	const gdouble *prev = vertices + (count - 1) * 2;
+	gdouble interval_x, interval_y, x0, y0;
+	gboolean edge_area;
+
+	for (i = 0; i < count; i++, prev = pos) {
+		pos = vertices + i * 2;
+		interval_x = pos[0] - prev[0];
+		interval_y = pos[1] - prev[1];
+		edge_area = FALSE;
+
+		if (interval_y > 180) {
+			interval_y -= 360;
+			edge_area = TRUE;
+		} else if (interval_y < -180) {
+			interval_y += 360;
+			edge_area = TRUE;
+		}
+
+		if (edge_area) {
+			if ((pos[1] > longitude) != (prev[1] > longitude)) continue;
+			if (prev[1] * longitude > 0) {
+				x0 = prev[0];
+				y0 = prev[1];
+			} else {
+				x0 = pos[0];
+				y0 = pos[1];
+			}
+		} else {
+			if ((pos[1] > longitude) == (prev[1] > longitude)) continue;
+			x0 = prev[0];
+			y0 = prev[1];
+		}
+
+		if (latitude < (interval_x / interval_y) * (longitude - y0) + x0) crossing++;
+	}
+	return crossing;
+}
+
+/* Length of a degree of latitude, the shortest one, so that the distances are lower bounds (meters) */
+#define METERS_PER_DEGREE_MIN	110574.0
+
+static gdouble
+_get_longitude_gap (gdouble longitude, gdouble reference)
+{
+	gdouble gap = longitude - reference;
+	if (gap > 180) gap -= 360;
+	else if (gap < -180) gap += 360;
+	return gap;
+}
+
+/* Length of a degree of longitude relative to one of latitude, at the greatest |latitude| the distance may run through,
+ * where it is the shortest */
+static gdouble
+_get_longitude_scale (gdouble latitude1, gdouble latitude2)
+{
+	gdouble latitude = MIN(MAX(fabs (latitude1), fabs (latitude2)), 90);
+	return cos (latitude * M_PI / 180);
+}
+
+/* Distances are measured on the plane tangent at the position, which is accurate enough at fence scale */
+gdouble
+polygon_segment_distance (gdouble latitude, gdouble longitude,
+	gdouble latitude1, gdouble longitude1,
+	gdouble latitude2, gdouble longitude2)
+{
+	gdouble scale = _get_longitude_scale (latitude, MAX(fabs (latitude1), fabs (latitude2)));
+	gdouble x1 = _get_longitude_gap (longitude1, longitude) * scale, y1 = latitude1 - latitude;
+	gdouble x2 = _get_longitude_gap (longitude2, longitude) * scale, y2 = latitude2 - latitude;
+	gdouble dx = x2 - x1, dy = y2 - y1;
+	gdouble length = dx * dx + dy * dy;
+	gdouble t = 0.0;
+
+	if (length > 0) t = CLAMP(-(x1 * dx + y1 * dy) / length, 0.0, 1.0);
+	return hypot (x1 + t * dx, y1 + t * dy) * METERS_PER_DEGREE_MIN;
+}
+
+gdouble
+polygon_vertices_distance (const gdouble *vertices, guint count, gdouble latitude, gdouble longitude)
+{
+	g_return_val_if_fail(vertices, 0.0);
+	g_return_val_if_fail(count, 0.0);
+
+	guint i;
+	const gdouble *prev = vertices + (count - 1) * 2;
+	gdouble distance = G_MAXDOUBLE;
+
+	for (i = 0; i < count; i++) {
+		const gdouble *pos = vertices + i * 2;
+		distance = MIN(distance, polygon_segment_distance (latitude, longitude, prev[0], prev[1], pos[0], pos[1]));
+		prev = pos;
+	}
+	return distance;
+}
+
+gdouble
+polygon_box_distance (gdouble latitude, gdouble longitude,
+	gdouble min_latitude, gdouble max_latitude,
+	gdouble min_longitude, gdouble max_longitude)
+{
+	gdouble scale = _get_longitude_scale (latitude, MAX(fabs (min_latitude), fabs (max_latitude)));
+	gdouble width = max_longitude - min_longitude;
+	gdouble west = 0.0, east = 0.0, dx = 0.0, dy = 0.0;
+
+	if (width < 0) width += 360;
+	west = _get_longitude_gap (longitude, min_longitude);
+	if (west < 0 && west + 360 <= width) west += 360;
+	east = width - west;
+
+	if (west >= 0 && east >= 0 && latitude >= min_latitude && latitude <= max_latitude) {
+		/* Inside: the nearest side, negated */
+		dy = MIN(latitude - min_latitude, max_latitude - latitude);
+		dx = MIN(west, east) * scale;
+		return -MIN(dx, dy) * METERS_PER_DEGREE_MIN;
+	}
+
+	if (west < 0 || east < 0) dx = MAX(-west, -east) * scale;
+	if (latitude < min_latitude) dy = min_latitude - latitude;
+	else if (latitude > max_latitude) dy = latitude - max_latitude;
+	return hypot (dx, dy) * METERS_PER_DEGREE_MIN;
+}
+
+gdouble
+polygon_circle_distance (gdouble latitude, gdouble longitude,
+	gdouble center_latitude, gdouble center_longitude,
+	gdouble radius)
+{
+	/* The haversine distance off by its worst error on either side */
+	gdouble distance = geodesic_haversine (center_latitude, center_longitude, latitude, longitude);
+	gdouble outside = distance * (1 - GEODESIC_HAVERSINE_ERROR) - radius;
+	gdouble inside = radius - distance * (1 + GEODESIC_HAVERSINE_ERROR);
+
+	return MAX(MAX(outside, inside), 0);
+}
@@ -0,0 +1,53 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_POLYGON_H__
+#define __LOCATION_POLYGON_H__
+
+#include <glib.h>
+
+/**
+ * @file location-polygon.h
+ * @brief This file contains the compiled edge table used for the polygon boundary test, and the planar distance helpers.
+ */
+
+G_BEGIN_DECLS
+
+typedef struct _LocationPolygonEdges LocationPolygonEdges;
+
+LocationPolygonEdges *polygon_edges_new (GList *position_list);
+void polygon_edges_free (LocationPolygonEdges *edges);
+guint polygon_edges_count_crossing (const LocationPolygonEdges *edges, gdouble latitude, gdouble longitude);
+
+/* Same test on a packed array of count (latitude, longitude) pairs, without building the edge table */
+guint polygon_vertices_count_crossing (const gdouble *vertices, guint count, gdouble latitude, gdouble longitude);
+
+/* Distances in meters from the position to a segment, to the edges of a packed polygon and to the sides of a box.
+ * The distance to the box is negative when the position is inside it. */
+gdouble polygon_segment_distance (gdouble latitude, gdouble longitude, gdouble latitude1, gdouble longitude1, gdouble latitude2, gdouble longitude2);
+gdouble polygon_vertices_distance (const gdouble *vertices, guint count, gdouble latitude, gdouble longitude);
+gdouble polygon_box_distance (gdouble latitude, gdouble longitude, gdouble min_latitude, gdouble max_latitude, gdouble min_longitude, gdouble max_longitude);
+/* Distance in meters from the position to the edge of a circle, inside or outside, never more than the actual one */
+gdouble polygon_circle_distance (gdouble latitude, gdouble longitude, gdouble center_latitude, gdouble center_longitude, gdouble radius);
+
+G_END_DECLS
+
+#endif
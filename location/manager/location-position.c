@@ -28,10 +28,16 @@
 #include <string.h>
 
 #include "location-position.h"
+#include "location-snapshot.h"
+#include "location-geodesic.h"
 #include "location-setting.h"
 #include "location-log.h"
 
-#define		DEG2RAD(x)	((x) * M_PI / 180)
+/* Layout of the position_snapshot_*() copies, see location-snapshot.h */
+typedef struct {
+	LocationPosition position;
+	volatile gint ref_count;
+} PositionSnapshot;
 
 GType
 location_position_get_type (void)
@@ -57,7 +63,7 @@ location_position_new (guint timestamp,
 	if (latitude < -90 || latitude > 90) return NULL;
 	if (longitude < -180 || longitude > 180) return NULL;
 
-	LocationPosition* position = g_slice_new0(LocationPosition);
+	LocationPosition *position = g_slice_new0(LocationPosition);
 	position->timestamp = timestamp;
 	position->latitude = latitude;
 	position->longitude = longitude;
@@ -73,6 +79,48 @@ location_position_free (LocationPosition* position)
 	g_slice_free(LocationPosition, position);
 }
 
+LocationPosition *
+position_snapshot_new (const LocationPosition *position)
+{
+	PositionSnapshot *snapshot = g_slice_new0(PositionSnapshot);
+	if (position) snapshot->position = *position;
+	snapshot->ref_count = 1;
+	return &snapshot->position;
+}
+
+LocationPosition *
+position_snapshot_ref (LocationPosition *snapshot)
+{
+	g_return_val_if_fail(snapshot, NULL);
+
+	g_atomic_int_inc(&((PositionSnapshot *) snapshot)->ref_count);
+	return snapshot;
+}
+
+void
+position_snapshot_unref (LocationPosition *snapshot)
+{
+	g_return_if_fail(snapshot);
+
+	if (g_atomic_int_dec_and_test(&((PositionSnapshot *) snapshot)->ref_count))
+		g_slice_free(PositionSnapshot, (PositionSnapshot *) snapshot);
+}
+
+void
+position_snapshot_update (LocationPosition **snapshot, const LocationPosition *position)
+{
+	g_return_if_fail(snapshot);
+	g_return_if_fail(position);
+
+	/* Written in place while nobody else holds it, replaced otherwise */
+	if (*snapshot && g_atomic_int_get(&((PositionSnapshot *) *snapshot)->ref_count) == 1) {
+		**snapshot = *position;
+		return;
+	}
+	if (*snapshot) position_snapshot_unref(*snapshot);
+	*snapshot = position_snapshot_new(position);
+}
+
 EXPORT_API gboolean
 location_position_equal (const LocationPosition *position1, const LocationPosition *position2)
 {
@@ -111,69 +159,52 @@ location_get_distance(const LocationPosition *pos1, const LocationPosition *pos2
 	g_return_val_if_fail(pos2, LOCATION_ERROR_PARAMETER);
 	g_return_val_if_fail(distance, LOCATION_ERROR_PARAMETER);
 
-	*distance = 0;
-
-	const double a = 6378137.0, b = 6356752.314245,  f = 1/298.257223563;
-	double delta_lon = DEG2RAD(pos2->longitude-pos1->longitude);
-	double u_1 = atan((1-f) * tan(DEG2RAD(pos1->latitude)));
-	double u_2 = atan((1-f) * tan(DEG2RAD(pos2->latitude)));
-
-	double lambdaP, iter_limit = 100.0;
-	double lambda = delta_lon;
-
-	double sin_sigma, sin_alpha, cos_sigma, sigma,  sq_cos_alpha, cos_2sigma, C;
-	double sq_u, cal1, cal2, delta_sigma, cal_dist;
-	double sin_lambda, cos_lambda;
+	int ret = LOCATION_ERROR_NONE;
+	gdouble cal_dist = 0.0;
 
-	double sin_u1 = sin(u_1);
-	double cos_u1 = cos(u_1);
-	double sin_u2 = sin(u_2);
-	double cos_u2 = cos(u_2);
-
-	do {
-		sin_lambda = sin(lambda);
-		cos_lambda = cos(lambda);
-
-		sin_sigma = sqrt((cos_u2*sin_lambda)*(cos_u2*sin_lambda) + \
-			(cos_u1*sin_u2-sin_u1*cos_u2*cos_lambda) * \
-			(cos_u1*sin_u2-sin_u1*cos_u2*cos_lambda));
-
-		if (sin_sigma ==0)
-			return LOCATION_ERROR_NONE;  // co-incident points
-
-		cos_sigma = sin_u1*sin_u2 + cos_u1*cos_u2*cos_lambda;
-		sigma = atan2(sin_sigma, cos_sigma);
-
-		sin_alpha = cos_u1 * cos_u2 * sin_lambda / sin_sigma;
-		sq_cos_alpha = 1.0 - sin_alpha*sin_alpha;
-		cos_2sigma = cos_sigma - 2.0*sin_u1*sin_u2/sq_cos_alpha;
-
-		if (isnan(cos_2sigma))
-			cos_2sigma = 0;
-
-		C = f/16.0*sq_cos_alpha*(4.0+f*(4.0-3.0*sq_cos_alpha));
+	*distance = 0;
 
-		lambdaP = lambda;
-		lambda = delta_lon + (1.0-C) * f * sin_alpha * \
-			 (sigma + C*sin_sigma*(cos_2sigma+C*cos_sigma*(-1.0+2.0*cos_2sigma*cos_2sigma)));
+	ret = geodesic_vincenty(pos1->latitude, pos1->longitude, pos2->latitude, pos2->longitude, &cal_dist);
+	if (ret != LOCATION_ERROR_NONE) return ret;
 
-	} while (abs(lambda-lambdaP) > 1e-12 && --iter_limit>0);
+	*distance = (gulong) cal_dist;
 
-	if (iter_limit==0) return LOCATION_ERROR_UNKNOWN;
+	return LOCATION_ERROR_NONE;
+}
 
-	sq_u = sq_cos_alpha * (a*a - b*b) / (b*b);
+EXPORT_API int
+location_get_distance_with_precision(const LocationPosition *pos1, const LocationPosition *pos2, LocationDistancePrecision precision, gdouble *distance)
+{
+	g_return_val_if_fail(pos1, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(pos2, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(distance, LOCATION_ERROR_PARAMETER);
 
-	cal1 = 1.0 + sq_u/16384.0*(4096.0+sq_u*(-768.0+sq_u*(320.0-175.0*sq_u)));
-	cal2 = sq_u/1024.0 * (256.0+sq_u*(-128.0+sq_u*(74.0-47.0*sq_u)));
+	switch (precision) {
+		case LOCATION_DISTANCE_EQUIRECTANGULAR:
+			*distance = geodesic_equirectangular(pos1->latitude, pos1->longitude, pos2->latitude, pos2->longitude);
+			return LOCATION_ERROR_NONE;
+		case LOCATION_DISTANCE_HAVERSINE:
+			*distance = geodesic_haversine(pos1->latitude, pos1->longitude, pos2->latitude, pos2->longitude);
+			return LOCATION_ERROR_NONE;
+		case LOCATION_DISTANCE_VINCENTY:
+			return geodesic_vincenty(pos1->latitude, pos1->longitude, pos2->latitude, pos2->longitude, distance);
+		default:
+			break;
+	}
 
-	delta_sigma = cal2*sin_sigma*(cos_2sigma+cal2/4.0*(cos_sigma*(-1.0+2.0*cos_2sigma*cos_2sigma)- \
-				cal2/6.0*cos_2sigma*(-3.0+4.0*sin_sigma*sin_sigma)*(-3.0+4.0*cos_2sigma*cos_2sigma)));
-	cal_dist = b*cal1*(sigma-delta_sigma);
+	return LOCATION_ERROR_PARAMETER;
+}
 
-	*distance = (gulong) cal_dist;
+EXPORT_API int
+location_get_distance_batch(const LocationPosition *reference, const LocationPosition *positions, guint count, gdouble *distances)
+{
+	g_return_val_if_fail(reference, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(positions || !count, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail(distances || !count, LOCATION_ERROR_PARAMETER);
 
-	return LOCATION_ERROR_NONE;
+	if (!count) return LOCATION_ERROR_NONE;
 
+	return geodesic_vincenty_batch(reference->latitude, reference->longitude, positions, count, distances);
 }
 
 EXPORT_API void
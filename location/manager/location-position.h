@@ -56,6 +56,16 @@ typedef enum
 	LOCATION_STATUS_3D_FIX 		///< 3D fix status (altitude/climb as well).
 } LocationStatus;
 
+/**
+ * @brief This represents the precision of a distance, from the cheapest to the most accurate.
+ */
+typedef enum
+{
+	LOCATION_DISTANCE_EQUIRECTANGULAR = 0,	///< Flat approximation with the radii of curvature at the middle latitude. Error below 0.05% up to 100 km between latitudes 80S and 80N, unbounded beyond.
+	LOCATION_DISTANCE_HAVERSINE,		///< Great circle on the sphere of mean radius. Error below 0.6% at any distance.
+	LOCATION_DISTANCE_VINCENTY		///< Geodesic on the WGS84 ellipsoid. Error below 1 mm.
+} LocationDistancePrecision;
+
 /**
  * @brief This represents position information such as latitude-longitude-altitude values and timestamp.
  */
@@ -155,6 +165,44 @@ LocationPosition *location_position_copy (const LocationPosition *position);
  */
 int location_get_distance(const LocationPosition *pos1, const LocationPosition *pos2, gulong *distance);
 
+/**
+ * @brief   Gets the distances from a reference point to each of an array of points, on the WGS84 ellipsoid.
+ * @remarks Uses meters as a unit of measurement, without truncation. The terms of the reference are computed once and
+ *          the points are iterated in vector lanes, so this is much cheaper than calling #location_get_distance for each.
+ *          A point for which the iteration does not converge (nearly antipodal to the reference) gets NAN.
+ * @pre     None.
+ * @post    None.
+ * @param [in]  reference - a #LocationPosition (decimal degree)
+ * @param [in]  positions - an array of count #LocationPosition (decimal degree)
+ * @param [in]  count - the number of positions
+ * @param [out]  distances - an array of count #gdouble (meters)
+ * @return int
+ * @retval 0                              Success.
+ * @retval LOCATION_ERROR_UNKNOWN         Some distances did not converge, the others are set.
+ *
+ * Please refer #LocationError for more information.
+ */
+int location_get_distance_batch(const LocationPosition *reference, const LocationPosition *positions, guint count, gdouble *distances);
+
+/**
+ * @brief   Gets the distance between two points with the given precision.
+ * @remarks Uses meters as a unit of measurement, without truncation. The error of each #LocationDistancePrecision is relative
+ *          to the distance, so a cheaper one is enough whenever the distance is compared far from a threshold.
+ *          #LOCATION_DISTANCE_VINCENTY is the distance of #location_get_distance.
+ * @pre     None.
+ * @post    None.
+ * @param [in]  pos1 - a #LocationPosition (decimal degree)
+ * @param [in]  pos2 - a #LocationPosition (decimal degree)
+ * @param [in]  precision - a #LocationDistancePrecision
+ * @param [out]  distance - a #gdouble (meters)
+ * @return int
+ * @retval 0                              Success.
+ * @retval LOCATION_ERROR_UNKNOWN         The Vincenty iteration did not converge (nearly antipodal points).
+ *
+ * Please refer #LocationError for more information.
+ */
+int location_get_distance_with_precision(const LocationPosition *pos1, const LocationPosition *pos2, LocationDistancePrecision precision, gdouble *distance);
+
 /**
  * @brief   Change position string to latitude and longitude integer.
  * @remarks None.
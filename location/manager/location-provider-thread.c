@@ -0,0 +1,443 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include "location-provider-thread.h"
+#include "location-log.h"
+
+/**
+ * The module callbacks reach a location object on the main loop of the module connection. With a
+ * provider thread, they only queue copies of their arguments there: the thread calls them back,
+ * with the object locked, to process the fix and evaluate the zones. The application side takes
+ * the same lock through the start and stop calls, the getters and the properties.
+ * What is emitted meanwhile goes to the application main context as messages. The updates are
+ * kept in one slot per kind, swapped atomically, so a late application gets the latest of each
+ * instead of a backlog, while the other messages, the zone changes among them, are all delivered.
+ * Both are merged back in the order they were posted.
+ */
+
+typedef enum {
+	CALL_STATUS,
+	CALL_POSITION,
+	CALL_VELOCITY,
+	CALL_SATELLITE,
+	CALL_SOURCE,
+	CALL_STOP
+} ProviderCallType;
+
+typedef struct _ProviderCall {
+	ProviderCallType type;
+	GCallback callback;
+	gboolean enabled;
+	LocationStatus status;
+	LocationPosition *position;
+	LocationVelocity *velocity;
+	LocationAccuracy *accuracy;
+	LocationSatellite *satellite;
+	gint64 received_time;
+} ProviderCall;
+
+struct _ProviderThread {
+	LocationObject *obj;
+	GThread *thread;
+	GAsyncQueue *calls;
+	volatile gint stopping;
+	GStaticRecMutex lock;
+	gint64 received_time;	/* of the call being processed */
+
+	GMainContext *context;
+	gpointer slots[PROVIDER_SLOT_MAX];
+	GAsyncQueue *messages;
+	volatile gint sequence;
+	volatile gint scheduled;
+	guint source;
+	gboolean delivering;
+	gboolean released;	/* freed while delivering */
+};
+
+static GQuark
+_provider_thread_quark (void)
+{
+	static GQuark quark = 0;
+	if (!quark) quark = g_quark_from_static_string ("location-provider-thread");
+	return quark;
+}
+
+static ProviderThread *
+_provider_thread_get (LocationObject *obj)
+{
+	return g_object_get_qdata (G_OBJECT (obj), _provider_thread_quark ());
+}
+
+static void
+_provider_call_free (ProviderCall *call)
+{
+	if (call->position) location_position_free (call->position);
+	if (call->velocity) location_velocity_free (call->velocity);
+	if (call->accuracy) location_accuracy_free (call->accuracy);
+	if (call->satellite) location_satellite_free (call->satellite);
+	g_slice_free (ProviderCall, call);
+}
+
+static void
+_provider_call (ProviderThread *thread, ProviderCall *call)
+{
+	switch (call->type) {
+		case CALL_STATUS:
+			((LocModStatusCB) call->callback) (call->enabled, call->status, thread->obj);
+			break;
+		case CALL_POSITION:
+			((LocModPositionCB) call->callback) (call->enabled, call->position, call->accuracy, thread->obj);
+			break;
+		case CALL_VELOCITY:
+			((LocModVelocityCB) call->callback) (call->enabled, call->velocity, call->accuracy, thread->obj);
+			break;
+		case CALL_SATELLITE:
+			((LocModSatelliteCB) call->callback) (call->enabled, call->satellite, thread->obj);
+			break;
+		case CALL_SOURCE:
+			((GSourceFunc) call->callback) (thread->obj);
+			break;
+		default:
+			break;
+	}
+}
+
+static gpointer
+_provider_thread_main (gpointer data)
+{
+	ProviderThread *thread = data;
+	ProviderCall *call = NULL;
+
+	while ((call = g_async_queue_pop (thread->calls))->type != CALL_STOP) {
+		g_static_rec_mutex_lock (&thread->lock);
+		thread->received_time = call->received_time;
+		if (!g_atomic_int_get (&thread->stopping)) _provider_call (thread, call);
+		g_static_rec_mutex_unlock (&thread->lock);
+		_provider_call_free (call);
+	}
+	_provider_call_free (call);
+	return NULL;
+}
+
+ProviderThread *
+provider_thread_new (LocationObject *obj)
+{
+	g_return_val_if_fail(obj, NULL);
+	g_return_val_if_fail(!_provider_thread_get (obj), NULL);
+
+	if (!g_thread_supported ()) g_thread_init (NULL);
+
+	ProviderThread *thread = g_slice_new0 (ProviderThread);
+	thread->obj = obj;
+	thread->calls = g_async_queue_new ();
+	thread->messages = g_async_queue_new ();
+	g_static_rec_mutex_init (&thread->lock);
+	thread->context = g_main_context_get_thread_default ();
+	if (!thread->context) thread->context = g_main_context_default ();
+	g_main_context_ref (thread->context);
+
+	thread->thread = g_thread_create (_provider_thread_main, thread, TRUE, NULL);
+	if (!thread->thread) {
+		LOCATION_LOGW("Fail to create the provider thread");
+		g_async_queue_unref (thread->calls);
+		g_async_queue_unref (thread->messages);
+		g_static_rec_mutex_free (&thread->lock);
+		g_main_context_unref (thread->context);
+		g_slice_free (ProviderThread, thread);
+		return NULL;
+	}
+	g_object_set_qdata (G_OBJECT (obj), _provider_thread_quark (), thread);
+	return thread;
+}
+
+static void
+_provider_message_free (ProviderMessage *message)
+{
+	message->free (message);
+}
+
+static void
+_provider_thread_destroy (ProviderThread *thread)
+{
+	ProviderMessage *message = NULL;
+	ProviderCall *call = NULL;
+	guint i;
+
+	if (g_atomic_int_get (&thread->scheduled)) {
+		GSource *source = g_main_context_find_source_by_id (thread->context, thread->source);
+		if (source) g_source_destroy (source);
+	}
+	for (i = 0; i < PROVIDER_SLOT_MAX; i++) {
+		if (thread->slots[i]) _provider_message_free (thread->slots[i]);
+	}
+	while ((message = g_async_queue_try_pop (thread->messages))) _provider_message_free (message);
+	while ((call = g_async_queue_try_pop (thread->calls))) _provider_call_free (call);
+	g_async_queue_unref (thread->messages);
+	g_async_queue_unref (thread->calls);
+	g_static_rec_mutex_free (&thread->lock);
+	g_main_context_unref (thread->context);
+	g_slice_free (ProviderThread, thread);
+}
+
+void
+provider_thread_free (ProviderThread *thread)
+{
+	g_return_if_fail(thread);
+
+	/* The calls still queued are dropped, the one running completes */
+	g_atomic_int_set (&thread->stopping, TRUE);
+	ProviderCall *stop = g_slice_new0 (ProviderCall);
+	stop->type = CALL_STOP;
+	g_async_queue_push (thread->calls, stop);
+	g_thread_join (thread->thread);
+
+	g_object_set_qdata (G_OBJECT (thread->obj), _provider_thread_quark (), NULL);
+
+	/* The delivery running frees it once done */
+	if (thread->delivering) {
+		thread->released = TRUE;
+		return;
+	}
+	_provider_thread_destroy (thread);
+}
+
+static ProviderThread *
+_provider_thread_deferring (LocationObject *obj)
+{
+	ProviderThread *thread = _provider_thread_get (obj);
+	if (!thread || thread->thread == g_thread_self ()) return NULL;
+	return thread;
+}
+
+static gboolean
+_provider_thread_defer (LocationObject *obj, ProviderCall *call)
+{
+	ProviderThread *thread = _provider_thread_deferring (obj);
+	if (!thread) {
+		g_slice_free (ProviderCall, call);
+		return FALSE;
+	}
+	call->received_time = g_get_monotonic_time () / 1000;
+	g_async_queue_push (thread->calls, call);
+	return TRUE;
+}
+
+gboolean
+provider_thread_defer_status (LocationObject *obj, LocModStatusCB callback, gboolean enabled, LocationStatus status)
+{
+	g_return_val_if_fail(obj, FALSE);
+	if (!_provider_thread_deferring (obj)) return FALSE;
+
+	ProviderCall *call = g_slice_new0 (ProviderCall);
+	call->type = CALL_STATUS;
+	call->callback = (GCallback) callback;
+	call->enabled = enabled;
+	call->status = status;
+	return _provider_thread_defer (obj, call);
+}
+
+gboolean
+provider_thread_defer_position (LocationObject *obj, LocModPositionCB callback, gboolean enabled, const LocationPosition *position, const LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail(obj, FALSE);
+	if (!_provider_thread_deferring (obj)) return FALSE;
+
+	ProviderCall *call = g_slice_new0 (ProviderCall);
+	call->type = CALL_POSITION;
+	call->callback = (GCallback) callback;
+	call->enabled = enabled;
+	if (position) call->position = location_position_copy (position);
+	if (accuracy) call->accuracy = location_accuracy_copy (accuracy);
+	return _provider_thread_defer (obj, call);
+}
+
+gboolean
+provider_thread_defer_velocity (LocationObject *obj, LocModVelocityCB callback, gboolean enabled, const LocationVelocity *velocity, const LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail(obj, FALSE);
+	if (!_provider_thread_deferring (obj)) return FALSE;
+
+	ProviderCall *call = g_slice_new0 (ProviderCall);
+	call->type = CALL_VELOCITY;
+	call->callback = (GCallback) callback;
+	call->enabled = enabled;
+	if (velocity) call->velocity = location_velocity_copy (velocity);
+	if (accuracy) call->accuracy = location_accuracy_copy (accuracy);
+	return _provider_thread_defer (obj, call);
+}
+
+gboolean
+provider_thread_defer_satellite (LocationObject *obj, LocModSatelliteCB callback, gboolean enabled, const LocationSatellite *satellite)
+{
+	g_return_val_if_fail(obj, FALSE);
+	if (!_provider_thread_deferring (obj)) return FALSE;
+
+	ProviderCall *call = g_slice_new0 (ProviderCall);
+	call->type = CALL_SATELLITE;
+	call->callback = (GCallback) callback;
+	call->enabled = enabled;
+	if (satellite) call->satellite = location_satellite_copy (satellite);
+	return _provider_thread_defer (obj, call);
+}
+
+gboolean
+provider_thread_defer_source (LocationObject *obj, GSourceFunc func)
+{
+	g_return_val_if_fail(obj, FALSE);
+	if (!_provider_thread_deferring (obj)) return FALSE;
+
+	ProviderCall *call = g_slice_new0 (ProviderCall);
+	call->type = CALL_SOURCE;
+	call->callback = (GCallback) func;
+	return _provider_thread_defer (obj, call);
+}
+
+gint64
+provider_thread_get_received_time (LocationObject *obj)
+{
+	g_return_val_if_fail(obj, 0);
+	ProviderThread *thread = _provider_thread_get (obj);
+	if (thread && thread->thread == g_thread_self ()) return thread->received_time;
+	return g_get_monotonic_time () / 1000;
+}
+
+ProviderThread *
+provider_thread_lock (LocationObject *obj)
+{
+	g_return_val_if_fail(obj, NULL);
+	ProviderThread *thread = _provider_thread_get (obj);
+	if (thread) g_static_rec_mutex_lock (&thread->lock);
+	return thread;
+}
+
+void
+provider_thread_unlock (ProviderThread *thread)
+{
+	if (thread) g_static_rec_mutex_unlock (&thread->lock);
+}
+
+gboolean
+provider_thread_posting (LocationObject *obj)
+{
+	g_return_val_if_fail(obj, FALSE);
+	return _provider_thread_get (obj) != NULL;
+}
+
+static gint
+_provider_message_cmp (gconstpointer a, gconstpointer b)
+{
+	/* Wrapping sequences */
+	return (*(ProviderMessage * const *) a)->sequence - (*(ProviderMessage * const *) b)->sequence;
+}
+
+static gboolean
+_provider_thread_deliver_cb (gpointer data)
+{
+	ProviderThread *thread = data;
+	LocationObject *obj = thread->obj;
+	ProviderMessage *latest[PROVIDER_SLOT_MAX];
+	ProviderMessage *message = NULL;
+	GQueue ordered = G_QUEUE_INIT;
+	guint count = 0, i = 0;
+
+	/* Posted from now on, a message schedules another delivery */
+	g_atomic_int_set (&thread->scheduled, FALSE);
+
+	for (i = 0; i < PROVIDER_SLOT_MAX; i++) {
+		do {
+			message = g_atomic_pointer_get (&thread->slots[i]);
+		} while (message && !g_atomic_pointer_compare_and_exchange (&thread->slots[i], message, NULL));
+		if (message) latest[count++] = message;
+	}
+	qsort (latest, count, sizeof (ProviderMessage *), _provider_message_cmp);
+	while ((message = g_async_queue_try_pop (thread->messages))) g_queue_push_tail (&ordered, message);
+
+	/* A handler may drop the last reference or the thread */
+	g_object_ref (obj);
+	thread->delivering = TRUE;
+	i = 0;
+	while (i < count || !g_queue_is_empty (&ordered)) {
+		ProviderMessage *next = g_queue_peek_head (&ordered);
+		if (i < count && (!next || latest[i]->sequence - next->sequence < 0)) message = latest[i++];
+		else message = g_queue_pop_head (&ordered);
+
+		if (!thread->released) message->deliver (obj, message);
+		_provider_message_free (message);
+	}
+	thread->delivering = FALSE;
+	if (thread->released) _provider_thread_destroy (thread);
+	g_object_unref (obj);
+	return FALSE;
+}
+
+static void
+_provider_thread_schedule (ProviderThread *thread)
+{
+	if (!g_atomic_int_compare_and_exchange (&thread->scheduled, FALSE, TRUE)) return;
+
+	GSource *source = g_idle_source_new ();
+	g_source_set_callback (source, _provider_thread_deliver_cb, thread, NULL);
+	thread->source = g_source_attach (source, thread->context);
+	g_source_unref (source);
+}
+
+void
+provider_thread_post (LocationObject *obj, ProviderMessage *message)
+{
+	g_return_if_fail(obj);
+	g_return_if_fail(message);
+
+	ProviderThread *thread = _provider_thread_get (obj);
+	if (!thread) {
+		_provider_message_free (message);
+		return;
+	}
+	message->sequence = g_atomic_int_add (&thread->sequence, 1);
+	g_async_queue_push (thread->messages, message);
+	_provider_thread_schedule (thread);
+}
+
+void
+provider_thread_post_latest (LocationObject *obj, ProviderSlot slot, ProviderMessage *message)
+{
+	g_return_if_fail(obj);
+	g_return_if_fail(slot < PROVIDER_SLOT_MAX);
+	g_return_if_fail(message);
+
+	ProviderThread *thread = _provider_thread_get (obj);
+	ProviderMessage *replaced = NULL;
+	if (!thread) {
+		_provider_message_free (message);
+		return;
+	}
+	message->sequence = g_atomic_int_add (&thread->sequence, 1);
+	do {
+		replaced = g_atomic_pointer_get (&thread->slots[slot]);
+	} while (!g_atomic_pointer_compare_and_exchange (&thread->slots[slot], replaced, message));
+	if (replaced) _provider_message_free (replaced);
+	_provider_thread_schedule (thread);
+}
@@ -0,0 +1,83 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_PROVIDER_THREAD_H__
+#define __LOCATION_PROVIDER_THREAD_H__
+
+#include <location.h>
+#include <location-module.h>
+
+/**
+ * @file location-provider-thread.h
+ * @brief This file contains the thread handling the module callbacks of a LocationObject away from the application loop.
+ */
+
+G_BEGIN_DECLS
+
+typedef struct _ProviderThread ProviderThread;
+typedef struct _ProviderMessage ProviderMessage;
+
+typedef void (*ProviderDeliverFunc) (LocationObject *obj, ProviderMessage *message);
+
+/* Head of the messages sent from the thread to the application loop */
+struct _ProviderMessage {
+	ProviderDeliverFunc deliver;
+	GDestroyNotify free;
+	gint sequence;
+};
+
+/* Slots of the mailbox, where a message replaces the one of the same slot not delivered yet */
+typedef enum {
+	PROVIDER_SLOT_POSITION = 0,
+	PROVIDER_SLOT_VELOCITY,
+	PROVIDER_SLOT_SATELLITE,
+	PROVIDER_SLOT_FIX,
+	PROVIDER_SLOT_MAX
+} ProviderSlot;
+
+/* The messages are delivered on the main context which is the thread default one of the caller */
+ProviderThread *provider_thread_new (LocationObject *obj);
+/* The callbacks and messages pending are dropped. Not to be called with the object locked */
+void provider_thread_free (ProviderThread *thread);
+
+/* TRUE if obj has a thread and the caller is not on it: the callback is called there later,
+ * with copies of the arguments and the object locked */
+gboolean provider_thread_defer_status (LocationObject *obj, LocModStatusCB callback, gboolean enabled, LocationStatus status);
+gboolean provider_thread_defer_position (LocationObject *obj, LocModPositionCB callback, gboolean enabled, const LocationPosition *position, const LocationAccuracy *accuracy);
+gboolean provider_thread_defer_velocity (LocationObject *obj, LocModVelocityCB callback, gboolean enabled, const LocationVelocity *velocity, const LocationAccuracy *accuracy);
+gboolean provider_thread_defer_satellite (LocationObject *obj, LocModSatelliteCB callback, gboolean enabled, const LocationSatellite *satellite);
+gboolean provider_thread_defer_source (LocationObject *obj, GSourceFunc func);
+/* Monotonic time in milliseconds when the call being processed was deferred, now off the thread of obj */
+gint64 provider_thread_get_received_time (LocationObject *obj);
+
+/* Serialize the application side with the thread of obj, nothing without thread. The lock is recursive */
+ProviderThread *provider_thread_lock (LocationObject *obj);
+void provider_thread_unlock (ProviderThread *thread);
+
+/* TRUE if obj has a thread: then every message is posted instead of being delivered by the caller */
+gboolean provider_thread_posting (LocationObject *obj);
+/* Delivered in the order posted. With a slot, the message replaces the one of the slot not delivered yet */
+void provider_thread_post (LocationObject *obj, ProviderMessage *message);
+void provider_thread_post_latest (LocationObject *obj, ProviderSlot slot, ProviderMessage *message);
+
+G_END_DECLS
+
+#endif
@@ -23,9 +23,21 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "location-satellite.h"
+#include "location-snapshot.h"
 #include "location-log.h"
 
+/* The details follow the satellite in the same block */
+typedef struct {
+	LocationSatellite satellite;
+	guint capacity;
+	LocationSatelliteDetail sat_inview[];
+} SatelliteBlock;
+
+#define SATELLITE_BLOCK_SIZE(capacity)	(sizeof (SatelliteBlock) + (capacity) * sizeof (LocationSatelliteDetail))
+
 GType
 location_satellite_get_type (void)
 {
@@ -55,10 +67,15 @@ update_num_of_used (LocationSatellite *satellite)
 EXPORT_API LocationSatellite*
 location_satellite_new (int num_of_sat_inview)
 {
-	LocationSatellite* satellite = g_slice_new0(LocationSatellite);
+	g_return_val_if_fail(num_of_sat_inview >= 0, NULL);
+
+	guint capacity = MAX((guint) num_of_sat_inview, LOCATION_SATELLITE_MAX_INVIEW);
+	SatelliteBlock *block = g_slice_alloc0 (SATELLITE_BLOCK_SIZE(capacity));
+	LocationSatellite* satellite = &block->satellite;
+	block->capacity = capacity;
 	satellite->num_of_sat_inview = num_of_sat_inview;
 	satellite->num_of_sat_used = 0;
-	satellite->sat_inview = g_new0(LocationSatelliteDetail, satellite->num_of_sat_inview);
+	satellite->sat_inview = block->sat_inview;
 	return satellite;
 }
 
@@ -66,8 +83,9 @@ EXPORT_API void
 location_satellite_free (LocationSatellite* satellite)
 {
 	g_return_if_fail(satellite);
-	g_free(satellite->sat_inview);
-	g_slice_free(LocationSatellite, satellite);
+
+	SatelliteBlock *block = (SatelliteBlock *) satellite;
+	g_slice_free1 (SATELLITE_BLOCK_SIZE(block->capacity), block);
 }
 
 EXPORT_API LocationSatellite*
@@ -77,17 +95,39 @@ location_satellite_copy (const LocationSatellite *satellite)
 	LocationSatellite* satellite_dup = location_satellite_new(satellite->num_of_sat_inview);
 	satellite_dup->timestamp = satellite->timestamp;
 	satellite_dup->num_of_sat_used = satellite->num_of_sat_used;
-	int i = 0;
-	for (i = 0 ; i < satellite_dup->num_of_sat_inview ; i++)
-		location_satellite_set_satellite_details(satellite_dup, i,
-												satellite->sat_inview[i].prn,
-												satellite->sat_inview[i].used,
-												satellite->sat_inview[i].elevation,
-												satellite->sat_inview[i].azimuth,
-												satellite->sat_inview[i].snr);
+	if (satellite->num_of_sat_inview && satellite->sat_inview)
+		memcpy (satellite_dup->sat_inview, satellite->sat_inview, satellite->num_of_sat_inview * sizeof (LocationSatelliteDetail));
 	return satellite_dup;
 }
 
+gboolean
+satellite_snapshot_update (LocationSatellite **snapshot, const LocationSatellite *satellite)
+{
+	g_return_val_if_fail(snapshot, FALSE);
+	g_return_val_if_fail(satellite, FALSE);
+
+	LocationSatellite *current = *snapshot;
+	gsize size = satellite->sat_inview ? satellite->num_of_sat_inview * sizeof (LocationSatelliteDetail) : 0;
+
+	/* Kept in its block while the satellites in view fit, only the details which differ make a change */
+	if (current && satellite->num_of_sat_inview <= ((SatelliteBlock *) current)->capacity) {
+		gboolean changed = current->num_of_sat_inview != satellite->num_of_sat_inview ||
+				current->num_of_sat_used != satellite->num_of_sat_used ||
+				memcmp (current->sat_inview, satellite->sat_inview, size) != 0;
+		current->timestamp = satellite->timestamp;
+		if (changed) {
+			current->num_of_sat_inview = size ? satellite->num_of_sat_inview : 0;
+			current->num_of_sat_used = satellite->num_of_sat_used;
+			if (size) memcpy (current->sat_inview, satellite->sat_inview, size);
+		}
+		return changed;
+	}
+
+	if (current) location_satellite_free (current);
+	*snapshot = location_satellite_copy (satellite);
+	return TRUE;
+}
+
 EXPORT_API gboolean
 location_satellite_get_satellite_details (const LocationSatellite *satellite,
 	guint index,
@@ -128,11 +168,30 @@ location_satellite_set_satellite_details (LocationSatellite *satellite,
 	g_return_val_if_fail(satellite->sat_inview, FALSE);
 	g_return_val_if_fail(index < satellite->num_of_sat_inview, FALSE);
 
+	/* Counted from the change of this one only, so that filling all the details stays linear */
+	if (satellite->sat_inview[index].used && !used && satellite->num_of_sat_used) satellite->num_of_sat_used--;
+	else if (!satellite->sat_inview[index].used && used) satellite->num_of_sat_used++;
+
 	satellite->sat_inview[index].prn= prn;
 	satellite->sat_inview[index].used= used;
 	satellite->sat_inview[index].elevation= elevation;
 	satellite->sat_inview[index].azimuth= azimuth;
 	satellite->sat_inview[index].snr= snr;
+
+	return TRUE;
+}
+
+EXPORT_API gboolean
+location_satellite_set_all_details (LocationSatellite *satellite,
+	const LocationSatelliteDetail *details,
+	guint num_of_sat_inview)
+{
+	g_return_val_if_fail(satellite, FALSE);
+	g_return_val_if_fail(details || !num_of_sat_inview, FALSE);
+	g_return_val_if_fail(num_of_sat_inview <= ((SatelliteBlock *) satellite)->capacity, FALSE);
+
+	if (num_of_sat_inview) memcpy (satellite->sat_inview, details, num_of_sat_inview * sizeof (LocationSatelliteDetail));
+	satellite->num_of_sat_inview = num_of_sat_inview;
 	update_num_of_used (satellite);
 
 	return TRUE;
@@ -42,6 +42,11 @@ GType location_satellite_get_type (void);
  * @{
  */
 
+/**
+ * @brief The number of satellites in view a #LocationSatellite holds without growing, enough for several GNSS constellations.
+ */
+#define LOCATION_SATELLITE_MAX_INVIEW	64
+
 /**
  * @brief This represents one satellite information in view.
  */
@@ -61,12 +66,12 @@ struct _LocationSatellite
 	guint timestamp;                           ///< Time stamp.
 	guint num_of_sat_inview;                   ///< The number of satellites in view.
 	guint num_of_sat_used;                     ///< The number of satellites in used.
-	LocationSatelliteDetail* sat_inview;       ///< The information of satellites in view .
+	LocationSatelliteDetail* sat_inview;       ///< The information of satellites in view, stored in the same allocation.
 };
 
 /**
  * @brief   Create a new #LocationSatellite with given number of #LocationSatelliteDetail.
- * @remarks None.
+ * @remarks The details are allocated with the #LocationSatellite, with room for at least #LOCATION_SATELLITE_MAX_INVIEW of them.
  * @pre     #location_init should be called before.\n
  * @post    None.
  * @param [in]  num_of_sat_inview - number of #LocationSatelliteDetail.
@@ -87,7 +92,7 @@ void location_satellite_free (LocationSatellite *satellite);
 
 /**
  * @brief   Makes a copy of #LocationSatellite
- * @remarks None.
+ * @remarks The details are copied at once.
  * @pre     #location_init should be called before.\n
  * @post    None.
  * @param [in]  satellite - a #LocationSatellite
@@ -134,6 +139,22 @@ gboolean location_satellite_get_satellite_details (const LocationSatellite *sate
  */
 gboolean location_satellite_set_satellite_details( LocationSatellite *satellite, guint index, guint prn,	gboolean used, guint elevation, guint azimuth, gint snr);
 
+/**
+ * @brief   Set all the #LocationSatelliteDetail of #LocationSatellite at once.
+ * @remarks The number of satellites in view and in used are updated. The satellite must be created by #location_satellite_new
+ *          or #location_satellite_copy, and num_of_sat_inview must not be larger than #LOCATION_SATELLITE_MAX_INVIEW or the number it was created with.
+ * @pre     #location_init should be called before.\n
+ * @post    None.
+ * @param [in]  satellite - a #LocationSatellite
+ * @param [in]  details - an array of num_of_sat_inview #LocationSatelliteDetail
+ * @param [in]  num_of_sat_inview - the number of satellites in view
+ * @return gboolean
+ * @retval\n
+ * TRUE - if success\n
+ * FALSE - if error occured\n
+ */
+gboolean location_satellite_set_all_details (LocationSatellite *satellite, const LocationSatelliteDetail *details, guint num_of_sat_inview);
+
 /**
  * @} @}
  */
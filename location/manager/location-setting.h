@@ -35,6 +35,10 @@
 #define LOCATION_UPDATE_INTERVAL_MAX		120
 #define LOCATION_UPDATE_INTERVAL_DEFAULT 	LOCATION_UPDATE_INTERVAL_MIN
 
+#define LOCATION_UPDATE_INTERVAL_MS_MIN		100
+#define LOCATION_UPDATE_INTERVAL_MS_MAX		(LOCATION_UPDATE_INTERVAL_MAX * 1000)
+#define LOCATION_UPDATE_INTERVAL_MS_DEFAULT	(LOCATION_UPDATE_INTERVAL_DEFAULT * 1000)
+
 typedef void (*SettingCB)(keynode_t *key, gpointer data);
 
 gint location_setting_get_key_val(keynode_t *key);
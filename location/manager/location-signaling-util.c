@@ -24,8 +24,355 @@
 #endif
 
 #include "location-signaling-util.h"
+#include "location-snapshot.h"
+#include "location-provider-thread.h"
+#include "location-fence-set.h"
 #include "location-log.h"
 
+#define UPDATE_JITTER_MS	50
+
+/* Reports come with some jitter, one slightly early for the interval is still delivered */
+static gboolean
+_interval_elapsed (gint64 time, gint64 updated_time, guint interval_ms)
+{
+	return time - updated_time >= (gint64) interval_ms - MIN(interval_ms / 4, UPDATE_JITTER_MS);
+}
+
+typedef struct {
+	guint id;
+	guint mask;		/* 0 once removed */
+	LocationUpdateCB callback;
+	gpointer user_data;
+} Subscription;
+
+/* Removed entries are only dropped outside of a dispatch, the callbacks may unsubscribe */
+typedef struct {
+	GArray *subscriptions;
+	guint last_id;
+	guint dispatching;
+	gboolean removed;
+} SubscriptionList;
+
+static GQuark
+_subscription_quark (void)
+{
+	static GQuark quark = 0;
+	if (!quark) quark = g_quark_from_static_string ("location-subscriptions");
+	return quark;
+}
+
+static void
+_subscription_list_free (gpointer data)
+{
+	SubscriptionList *list = (SubscriptionList *) data;
+	g_array_free (list->subscriptions, TRUE);
+	g_slice_free (SubscriptionList, list);
+}
+
+static void
+_subscription_list_compact (SubscriptionList *list)
+{
+	guint i = list->subscriptions->len;
+
+	while (i--) {
+		if (!g_array_index (list->subscriptions, Subscription, i).mask)
+			g_array_remove_index (list->subscriptions, i);
+	}
+	list->removed = FALSE;
+}
+
+guint
+signaling_subscribe (LocationObject *obj,
+	guint mask,
+	LocationUpdateCB callback,
+	gpointer user_data)
+{
+	g_return_val_if_fail(obj, 0);
+	g_return_val_if_fail(mask, 0);
+	g_return_val_if_fail(callback, 0);
+
+	SubscriptionList *list = g_object_get_qdata (obj, _subscription_quark ());
+	Subscription subscription = {0, mask, callback, user_data};
+
+	if (!list) {
+		list = g_slice_new0 (SubscriptionList);
+		list->subscriptions = g_array_new (FALSE, FALSE, sizeof (Subscription));
+		g_object_set_qdata_full (obj, _subscription_quark (), list, _subscription_list_free);
+	}
+	subscription.id = ++list->last_id;
+	g_array_append_val (list->subscriptions, subscription);
+	return subscription.id;
+}
+
+gboolean
+signaling_unsubscribe (LocationObject *obj,
+	guint id)
+{
+	g_return_val_if_fail(obj, FALSE);
+
+	SubscriptionList *list = g_object_get_qdata (obj, _subscription_quark ());
+	guint i = 0;
+
+	if (!list || !id) return FALSE;
+	for (i = 0; i < list->subscriptions->len; i++) {
+		Subscription *subscription = &g_array_index (list->subscriptions, Subscription, i);
+		if (subscription->id != id || !subscription->mask) continue;
+
+		subscription->mask = 0;
+		list->removed = TRUE;
+		if (!list->dispatching) _subscription_list_compact (list);
+		return TRUE;
+	}
+	return FALSE;
+}
+
+static void
+_update_dispatch (LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	LocationUpdateType type,
+	gconstpointer data,
+	const LocationAccuracy *acc)
+{
+	SubscriptionList *list = g_object_get_qdata (obj, _subscription_quark ());
+	guint i = 0;
+	guint len = 0;
+
+	if (list) {
+		/* Only the subscriptions present before the dispatch are called, the array may grow meanwhile */
+		len = list->subscriptions->len;
+		list->dispatching++;
+		for (i = 0; i < len; i++) {
+			Subscription subscription = g_array_index (list->subscriptions, Subscription, i);
+			if (subscription.mask & (1 << type))
+				subscription.callback (obj, type, data, acc, subscription.user_data);
+		}
+		if (!--list->dispatching && list->removed) _subscription_list_compact (list);
+	}
+
+	/* Marshalling the arguments into GValues costs more than most handlers, skipped when none is connected */
+	if (g_signal_has_handler_pending (obj, signals[SERVICE_UPDATED], 0, FALSE))
+		g_signal_emit (obj, signals[SERVICE_UPDATED], 0, type, data, acc);
+}
+
+/* An update posted by an object with a provider thread, holding its data */
+typedef struct {
+	ProviderMessage message;
+	guint32 *signals;
+	LocationUpdateType type;
+	gpointer data;
+	LocationAccuracy acc;
+	gboolean has_acc;
+} UpdateMessage;
+
+static void
+_update_message_deliver (LocationObject *obj, ProviderMessage *message)
+{
+	UpdateMessage *update = (UpdateMessage *) message;
+	_update_dispatch (obj, update->signals, update->type, update->data, update->has_acc ? &update->acc : NULL);
+}
+
+static void
+_update_message_free (gpointer data)
+{
+	UpdateMessage *update = (UpdateMessage *) data;
+	LocationBatch *batch = NULL;
+
+	switch (update->type) {
+		case POSITION_UPDATED:
+			position_snapshot_unref (update->data);
+			break;
+		case VELOCITY_UPDATED:
+			velocity_snapshot_unref (update->data);
+			break;
+		case SATELLITE_UPDATED:
+			location_satellite_free (update->data);
+			break;
+		case FIX_UPDATED:
+			location_fix_free (update->data);
+			break;
+		case BATCH_UPDATED:
+			batch = update->data;
+			g_free (batch->positions);
+			g_free (batch->accuracies);
+			g_slice_free (LocationBatch, batch);
+			break;
+		default:
+			break;
+	}
+	g_slice_free (UpdateMessage, update);
+}
+
+/* The snapshots are shared by reference, they are replaced rather than modified while referenced */
+static void
+_update_post (LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	LocationUpdateType type,
+	gconstpointer data,
+	const LocationAccuracy *acc)
+{
+	UpdateMessage *update = g_slice_new0 (UpdateMessage);
+	const LocationBatch *batch = NULL;
+	LocationBatch *copy = NULL;
+
+	update->message.deliver = _update_message_deliver;
+	update->message.free = _update_message_free;
+	update->signals = signals;
+	update->type = type;
+	if (acc) {
+		update->acc = *acc;
+		update->has_acc = TRUE;
+	}
+
+	switch (type) {
+		case POSITION_UPDATED:
+			update->data = position_snapshot_ref ((LocationPosition *) data);
+			provider_thread_post_latest (obj, PROVIDER_SLOT_POSITION, &update->message);
+			break;
+		case VELOCITY_UPDATED:
+			update->data = velocity_snapshot_ref ((LocationVelocity *) data);
+			provider_thread_post_latest (obj, PROVIDER_SLOT_VELOCITY, &update->message);
+			break;
+		case SATELLITE_UPDATED:
+			update->data = location_satellite_copy (data);
+			provider_thread_post_latest (obj, PROVIDER_SLOT_SATELLITE, &update->message);
+			break;
+		case FIX_UPDATED:
+			update->data = location_fix_ref ((LocationFix *) data);
+			provider_thread_post_latest (obj, PROVIDER_SLOT_FIX, &update->message);
+			break;
+		case BATCH_UPDATED:
+			/* Every position of a batch is delivered */
+			batch = data;
+			copy = g_slice_new0 (LocationBatch);
+			copy->count = batch->count;
+			copy->positions = g_memdup (batch->positions, batch->count * sizeof (LocationPosition));
+			copy->accuracies = g_memdup (batch->accuracies, batch->count * sizeof (LocationAccuracy));
+			update->data = copy;
+			provider_thread_post (obj, &update->message);
+			break;
+		default:
+			g_slice_free (UpdateMessage, update);
+			break;
+	}
+}
+
+void
+update_signaling (LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	LocationUpdateType type,
+	gconstpointer data,
+	const LocationAccuracy *acc)
+{
+	g_return_if_fail(obj);
+	g_return_if_fail(signals);
+
+	/* The handlers run on the application loop, never under the lock of the provider thread */
+	if (provider_thread_posting (obj)) _update_post (obj, signals, type, data, acc);
+	else _update_dispatch (obj, signals, type, data, acc);
+}
+
+/* The other signals posted by an object with a provider thread, holding copies of their arguments */
+typedef struct {
+	ProviderMessage message;
+	guint32 *signals;
+	guint index;
+	LocationStatus status;
+	gpointer in;		/* boundaries for ZONE_CHANGED, fence ids for FENCE_CHANGED */
+	gpointer out;
+	LocationPosition *pos;
+	LocationAccuracy *acc;
+} SignalMessage;
+
+static void
+_signal_message_deliver (LocationObject *obj, ProviderMessage *message)
+{
+	SignalMessage *signal = (SignalMessage *) message;
+
+	switch (signal->index) {
+		case SERVICE_ENABLED:
+		case SERVICE_DISABLED:
+			g_signal_emit (obj, signal->signals[signal->index], 0, signal->status);
+			break;
+		case ZONE_IN:
+		case ZONE_OUT:
+			g_signal_emit (obj, signal->signals[signal->index], 0, NULL, signal->pos, signal->acc);
+			break;
+		default:
+			g_signal_emit (obj, signal->signals[signal->index], 0, signal->in, signal->out, signal->pos, signal->acc);
+			break;
+	}
+}
+
+static GList *
+_boundary_list_copy (const GList *list)
+{
+	GList *copy = NULL;
+	for (; list; list = list->next) copy = g_list_prepend (copy, location_boundary_copy (list->data));
+	return g_list_reverse (copy);
+}
+
+static GArray *
+_id_array_copy (const GArray *ids)
+{
+	GArray *copy = g_array_sized_new (FALSE, FALSE, sizeof (guint), ids->len);
+	g_array_append_vals (copy, ids->data, ids->len);
+	return copy;
+}
+
+static void
+_signal_message_free (gpointer data)
+{
+	SignalMessage *signal = (SignalMessage *) data;
+
+	if (signal->index == ZONE_CHANGED) {
+		g_list_foreach (signal->in, (GFunc) location_boundary_free, NULL);
+		g_list_foreach (signal->out, (GFunc) location_boundary_free, NULL);
+		g_list_free (signal->in);
+		g_list_free (signal->out);
+	} else if (signal->index == FENCE_CHANGED) {
+		g_array_free (signal->in, TRUE);
+		g_array_free (signal->out, TRUE);
+	}
+	if (signal->pos) location_position_free (signal->pos);
+	if (signal->acc) location_accuracy_free (signal->acc);
+	g_slice_free (SignalMessage, signal);
+}
+
+/* Emits signals[index], or posts it with copies of the arguments when the object has a provider thread */
+static void
+_signal_emit (LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	guint index,
+	LocationStatus status,
+	gconstpointer in,
+	gconstpointer out,
+	const LocationPosition *pos,
+	const LocationAccuracy *acc)
+{
+	SignalMessage signal = {{NULL, NULL, 0}, signals, index, status, (gpointer) in, (gpointer) out, (LocationPosition *) pos, (LocationAccuracy *) acc};
+	SignalMessage *copy = NULL;
+
+	if (!provider_thread_posting (obj)) {
+		_signal_message_deliver (obj, &signal.message);
+		return;
+	}
+
+	copy = g_slice_new0 (SignalMessage);
+	*copy = signal;
+	copy->message.deliver = _signal_message_deliver;
+	copy->message.free = _signal_message_free;
+	if (index == ZONE_CHANGED) {
+		copy->in = _boundary_list_copy (in);
+		copy->out = _boundary_list_copy (out);
+	} else if (index == FENCE_CHANGED) {
+		copy->in = _id_array_copy (in);
+		copy->out = _id_array_copy (out);
+	}
+	if (pos) copy->pos = location_position_copy (pos);
+	if (acc) copy->acc = location_accuracy_copy (acc);
+	provider_thread_post (obj, &copy->message);
+}
+
 void
 enable_signaling (LocationObject *obj,
 	guint32 signals[LAST_SIGNAL],
@@ -39,11 +386,11 @@ enable_signaling (LocationObject *obj,
 	if (*prev_enabled == TRUE && enabled == FALSE) {
 		*prev_enabled = FALSE;
 		LOCATION_LOGD("Signal emit: SERVICE_DISABLED");
-		g_signal_emit (obj, signals[SERVICE_DISABLED], 0, LOCATION_STATUS_NO_FIX);
+		_signal_emit (obj, signals, SERVICE_DISABLED, LOCATION_STATUS_NO_FIX, NULL, NULL, NULL, NULL);
 	} else if (*prev_enabled == FALSE && enabled == TRUE){
 		*prev_enabled = TRUE;
 		LOCATION_LOGD("Signal emit: SERVICE_ENABLED");
-		g_signal_emit (obj, signals[SERVICE_ENABLED], 0, status);
+		_signal_emit (obj, signals, SERVICE_ENABLED, status, NULL, NULL, NULL, NULL);
 	}
 }
 
@@ -51,14 +398,16 @@ void
 position_signaling (LocationObject *obj,
 	guint32 signals[LAST_SIGNAL],
 	gboolean *prev_enabled,
-	int interval,
+	guint interval_ms,
 	gboolean emit,
-	guint *updated_timestamp,
+	gint64 *updated_time,
 	LocationPosition **prev_pos,
-	GList *prev_bound,
+	LatestFix *latest,
+	LocationBoundaryIndex *boundary_index,
 	ZoneStatus *zone_status,
 	const LocationPosition *pos,
-	const LocationAccuracy *acc)
+	const LocationAccuracy *acc,
+	gint64 received_time)
 {
 	g_return_if_fail(zone_status);
 	g_return_if_fail(pos);
@@ -66,44 +415,80 @@ position_signaling (LocationObject *obj,
 	g_return_if_fail(obj);
 	g_return_if_fail(signals);
 
-	int index = 0;
 	gboolean is_inside = FALSE;
-	GList *boundary_list = prev_bound;
-	LocationBoundary *boundary = NULL;
+	gboolean is_crossed = FALSE;
+	LocationPosition last_pos;
+	gboolean has_last_pos = FALSE;
+	GList *entered = NULL;
+	GList *left = NULL;
+	LocationBoundaryStore *store = NULL;
+	GArray *entered_ids = NULL;
+	GArray *left_ids = NULL;
 
 	if (!pos->timestamp)	return;
 
-	if (*prev_pos) location_position_free (*prev_pos);
-
-	*prev_pos = location_position_copy(pos);
+	/* Kept by value until the zone is evaluated, for the path from the last position */
+	if (*prev_pos) {
+		last_pos = **prev_pos;
+		has_last_pos = TRUE;
+	}
+	position_snapshot_update(prev_pos, pos);
+	if (latest) latest_fix_update(latest, pos, NULL, acc);
 	LOCATION_LOGD("timestamp[%d], lat [%f], lon [%f]", (*prev_pos)->timestamp, (*prev_pos)->latitude, (*prev_pos)->longitude);
 
-	if (emit && pos->timestamp - *updated_timestamp >= interval) {
+	if (emit && _interval_elapsed(received_time, *updated_time, interval_ms)) {
 		LOCATION_LOGD("POSITION SERVICE_UPDATED");
-		g_signal_emit(obj, signals[SERVICE_UPDATED], 0, POSITION_UPDATED, pos, acc);
-		*updated_timestamp = pos->timestamp;
+		/* The handlers get the snapshot kept by the object, not a copy */
+		update_signaling(obj, signals, POSITION_UPDATED, *prev_pos, acc);
+		*updated_time = received_time;
 	}
 
-	if(boundary_list) {
-		while((boundary = (LocationBoundary *)g_list_nth_data(boundary_list, index))!= NULL) {
-			is_inside = location_boundary_if_inside(boundary, pos);
-			if(is_inside) {
-				break;
+	if(boundary_index && boundary_index_is_watching(boundary_index)) {
+		/* On a provider thread, the fences of the sets reported are kept until they are copied into the message.
+		 * The handlers called in place run on the application thread, which is the only one removing fences */
+		gboolean posting = provider_thread_posting(obj);
+		if (posting) fence_set_lock();
+
+		/* Exact tests only on the boundaries sharing the grid cell of the position, own ones and subscribed fence sets */
+		is_inside = boundary_index_update_zone(boundary_index, has_last_pos ? &last_pos : NULL, pos, &entered, &left);
+		/* Only boundaries passed through between two positions can be entered while outside of all */
+		is_crossed = !is_inside && entered != NULL;
+
+		if (entered || left) {
+			LOCATION_LOGD("Signal emit: ZONE_CHANGED in [%d] out [%d]", g_list_length(entered), g_list_length(left));
+			_signal_emit(obj, signals, ZONE_CHANGED, 0, entered, left, pos, acc);
+			g_list_free(entered);
+			g_list_free(left);
+		}
+		if (posting) fence_set_unlock();
+
+		store = boundary_index_get_store(boundary_index);
+		if (store) {
+			/* Fences of the store are evaluated in place in the mapped file */
+			if (boundary_store_update_zone(store, pos, &entered_ids, &left_ids)) is_inside = TRUE;
+
+			if (entered_ids->len || left_ids->len) {
+				LOCATION_LOGD("Signal emit: FENCE_CHANGED in [%d] out [%d]", entered_ids->len, left_ids->len);
+				_signal_emit(obj, signals, FENCE_CHANGED, 0, entered_ids, left_ids, pos, acc);
 			}
-			index++;
 		}
 
 		if(is_inside) {
 			if(*zone_status != ZONE_STATUS_IN) {
 				LOCATION_LOGD("Signal emit: ZONE IN");
-				g_signal_emit(obj, signals[ZONE_IN], 0, NULL, pos, acc);
+				_signal_emit(obj, signals, ZONE_IN, 0, NULL, NULL, pos, acc);
 				*zone_status = ZONE_STATUS_IN;
 			}
 		}
 		else {
+			if (is_crossed && *zone_status != ZONE_STATUS_IN) {
+				LOCATION_LOGD("Signal emit: ZONE IN (crossed)");
+				_signal_emit(obj, signals, ZONE_IN, 0, NULL, NULL, pos, acc);
+				*zone_status = ZONE_STATUS_IN;
+			}
 			if (*zone_status != ZONE_STATUS_OUT) {
 				LOCATION_LOGD("Signal emit : ZONE_OUT");
-				g_signal_emit(obj, signals[ZONE_OUT], 0, NULL, pos, acc);
+				_signal_emit(obj, signals, ZONE_OUT, 0, NULL, NULL, pos, acc);
 				*zone_status = ZONE_STATUS_OUT;
 			}
 		}
@@ -114,13 +499,15 @@ void
 velocity_signaling (LocationObject *obj,
 	guint32 signals[LAST_SIGNAL],
 	gboolean *prev_enabled,
-	int interval,
+	guint interval_ms,
 	gboolean emit,
-	guint *updated_timestamp,
+	gint64 *updated_time,
 	LocationVelocity **prev_vel,
 	LocationAccuracy **prev_acc,
+	LatestFix *latest,
 	const LocationVelocity *vel,
-	const LocationAccuracy *acc)
+	const LocationAccuracy *acc,
+	gint64 received_time)
 {
 	g_return_if_fail(obj);
 	g_return_if_fail(signals);
@@ -128,17 +515,20 @@ velocity_signaling (LocationObject *obj,
 
 	if (!vel->timestamp) return;
 
-	if (*prev_vel) location_velocity_free (*prev_vel);
-	if (*prev_acc) location_accuracy_free (*prev_acc);
-
-	*prev_vel = location_velocity_copy (vel);
-	*prev_acc = location_accuracy_copy (acc);
+	velocity_snapshot_update (prev_vel, vel);
+	if (acc) {
+		accuracy_snapshot_update (prev_acc, acc);
+	} else if (*prev_acc) {
+		accuracy_snapshot_unref (*prev_acc);
+		*prev_acc = NULL;
+	}
+	if (latest) latest_fix_update(latest, NULL, vel, acc);
 	LOCATION_LOGD("timestamp[%d]", (*prev_vel)->timestamp);
 
-	if (emit && vel->timestamp - *updated_timestamp >= interval) {
+	if (emit && _interval_elapsed(received_time, *updated_time, interval_ms)) {
 		LOCATION_LOGD("VELOCITY SERVICE_UPDATED");
-		g_signal_emit(obj, signals[SERVICE_UPDATED], 0, VELOCITY_UPDATED, vel, acc);
-		*updated_timestamp = vel->timestamp;
+		update_signaling(obj, signals, VELOCITY_UPDATED, *prev_vel, acc ? *prev_acc : NULL);
+		*updated_time = received_time;
 	}
 }
 
@@ -149,22 +539,231 @@ satellite_signaling(LocationObject *obj,
 	int interval,
 	gboolean emit,
 	guint *updated_timestamp,
+	gboolean *sat_changed,
 	LocationSatellite **prev_sat,
 	const LocationSatellite *sat)
 {
 	g_return_if_fail(obj);
 	g_return_if_fail(signals);
+	g_return_if_fail(sat_changed);
 	g_return_if_fail(sat);
 
 	if (!sat->timestamp) return;
 
-	if (*prev_sat) location_satellite_free (*prev_sat);
-	*prev_sat = location_satellite_copy (sat);
+	/* Receivers report the same sky several times per second. A change within the interval
+	 * is kept pending until it is emitted, so the sky signaled last is never older than it */
+	if (satellite_snapshot_update (prev_sat, sat)) *sat_changed = TRUE;
+	if (!*sat_changed) return;
 
 	if (emit && sat->timestamp - *updated_timestamp >= interval) {
 		LOCATION_LOGD("SATELLITE SERVICE_UPDATED");
-		g_signal_emit(obj, signals[SERVICE_UPDATED], 0, SATELLITE_UPDATED, sat, NULL);
+		update_signaling(obj, signals, SATELLITE_UPDATED, sat, NULL);
 		*updated_timestamp = sat->timestamp;
+		*sat_changed = FALSE;
 	}
 
 }
+
+static void
+_fix_emit (LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	guint interval_ms,
+	gint64 *updated_time,
+	LocationFix *fix)
+{
+	if (!(fix->fields & (LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY))) return;
+	if (fix->monotonic_time == *updated_time || !_interval_elapsed(fix->monotonic_time, *updated_time, interval_ms)) return;
+
+	LOCATION_LOGD("FIX SERVICE_UPDATED");
+	update_signaling(obj, signals, FIX_UPDATED, fix, (fix->fields & LOCATION_FIX_ACCURACY) ? &fix->accuracy : NULL);
+	*updated_time = fix->monotonic_time;
+}
+
+void
+fix_signaling (LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	guint interval_ms,
+	gboolean emit,
+	guint complete,
+	gint64 *updated_time,
+	LocationFix **prev_fix,
+	const LocationPosition *pos,
+	const LocationVelocity *vel,
+	const LocationAccuracy *acc,
+	const LocationSatellite *sat,
+	gint64 received_time)
+{
+	g_return_if_fail(obj);
+	g_return_if_fail(signals);
+	g_return_if_fail(prev_fix);
+
+	guint timestamp = pos ? pos->timestamp : (vel ? vel->timestamp : 0);
+
+	if ((pos || vel) && !timestamp) return;
+	if (sat && !sat->timestamp) return;
+
+	/* An epoch still missing a part is delivered as it is when the next one starts */
+	if (emit && *prev_fix && fix_snapshot_starts_epoch(*prev_fix, pos, vel))
+		_fix_emit(obj, signals, interval_ms, updated_time, *prev_fix);
+
+	fix_snapshot_update(prev_fix, pos, vel, acc, sat, received_time);
+
+	/* Satellites are delivered with the next epoch */
+	if (emit && timestamp && ((*prev_fix)->fields & complete) == complete)
+		_fix_emit(obj, signals, interval_ms, updated_time, *prev_fix);
+}
+
+void
+fix_timeout_signaling (LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	LocationFix *fix)
+{
+	g_return_if_fail(obj);
+	g_return_if_fail(signals);
+
+	fix = fix ? location_fix_ref (fix) : location_fix_new ();
+
+	LOCATION_LOGD("FIX SERVICE_UPDATED");
+	update_signaling(obj, signals, FIX_UPDATED, fix, (fix->fields & LOCATION_FIX_ACCURACY) ? &fix->accuracy : NULL);
+	location_fix_free (fix);
+}
+
+/* The batch given to the handlers, followed by what the object needs to fill and deliver it */
+typedef struct {
+	LocationBatch batch;
+	guint size;
+	guint latency;
+	guint timer;
+	gboolean delivering;
+	gboolean released;	/* while delivering, freed once done */
+	LocationObject *obj;
+	guint32 *signals;
+} BatchBuffer;
+
+static void
+_batch_free (BatchBuffer *buffer)
+{
+	if (buffer->timer) g_source_remove (buffer->timer);
+	g_free (buffer->batch.positions);
+	g_free (buffer->batch.accuracies);
+	g_slice_free (BatchBuffer, buffer);
+}
+
+static void
+_batch_deliver (BatchBuffer *buffer)
+{
+	if (buffer->timer) {
+		g_source_remove (buffer->timer);
+		buffer->timer = 0;
+	}
+	if (buffer->delivering || !buffer->batch.count) return;
+
+	LOCATION_LOGD("BATCH SERVICE_UPDATED [%u]", buffer->batch.count);
+	/* The handlers may change the batch of the object */
+	buffer->delivering = TRUE;
+	update_signaling(buffer->obj, buffer->signals, BATCH_UPDATED, &buffer->batch, NULL);
+	buffer->delivering = FALSE;
+	buffer->batch.count = 0;
+
+	if (buffer->released) _batch_free (buffer);
+}
+
+static gboolean
+_batch_timeout_cb (gpointer data)
+{
+	BatchBuffer *buffer = (BatchBuffer *) data;
+	ProviderThread *thread = provider_thread_lock (buffer->obj);
+
+	/* Delivered by the provider thread while waiting for the lock */
+	if (buffer->timer == g_source_get_id (g_main_current_source ())) {
+		buffer->timer = 0;
+		_batch_deliver (buffer);
+	}
+	provider_thread_unlock (thread);
+	return FALSE;
+}
+
+void
+batch_signaling_free (LocationBatch *batch)
+{
+	g_return_if_fail(batch);
+
+	BatchBuffer *buffer = (BatchBuffer *) batch;
+	if (buffer->delivering) buffer->released = TRUE;
+	else _batch_free (buffer);
+}
+
+void
+batch_signaling_set (LocationBatch **batch,
+	LocationObject *obj,
+	guint32 signals[LAST_SIGNAL],
+	guint size,
+	guint latency)
+{
+	g_return_if_fail(batch);
+	g_return_if_fail(obj);
+	g_return_if_fail(signals);
+
+	BatchBuffer *buffer = (BatchBuffer *) *batch;
+
+	size = MIN(size, LOCATION_BATCH_SIZE_MAX);
+	latency = CLAMP(latency, 1, LOCATION_BATCH_LATENCY_MAX);
+
+	/* A new latency applies from the next batch */
+	if (buffer && buffer->size == size) {
+		buffer->latency = latency;
+		return;
+	}
+
+	/* Detached first, the handlers of the last positions may set another batch */
+	if (buffer) {
+		*batch = NULL;
+		_batch_deliver (buffer);
+		batch_signaling_free (&buffer->batch);
+	}
+	if (!size || *batch) return;
+
+	buffer = g_slice_new0 (BatchBuffer);
+	buffer->batch.positions = g_new (LocationPosition, size);
+	buffer->batch.accuracies = g_new (LocationAccuracy, size);
+	buffer->size = size;
+	buffer->latency = latency;
+	buffer->obj = obj;
+	buffer->signals = signals;
+	*batch = &buffer->batch;
+}
+
+void
+batch_signaling (LocationBatch *batch,
+	const LocationPosition *pos,
+	const LocationAccuracy *acc)
+{
+	g_return_if_fail(batch);
+	g_return_if_fail(pos);
+
+	BatchBuffer *buffer = (BatchBuffer *) batch;
+	guint index = batch->count;
+
+	if (!pos->timestamp || buffer->delivering) return;
+
+	batch->positions[index] = *pos;
+	if (acc) {
+		batch->accuracies[index] = *acc;
+	} else {
+		batch->accuracies[index].level = LOCATION_ACCURACY_LEVEL_NONE;
+		batch->accuracies[index].horizontal_accuracy = 0.0;
+		batch->accuracies[index].vertical_accuracy = 0.0;
+	}
+	batch->count++;
+
+	if (batch->count >= buffer->size) _batch_deliver (buffer);
+	else if (!buffer->timer) buffer->timer = g_timeout_add_seconds (buffer->latency, _batch_timeout_cb, buffer);
+}
+
+void
+batch_flush_signaling (LocationBatch *batch)
+{
+	g_return_if_fail(batch);
+
+	_batch_deliver ((BatchBuffer *) batch);
+}
@@ -24,6 +24,8 @@
 
 #include <location.h>
 #include <location-ielement.h>
+#include <location-boundary-index.h>
+#include <location-snapshot.h>
 
 /**
  * @file location-signaling.h
@@ -38,24 +40,47 @@ typedef enum {
 	ZONE_STATUS_OUT,
 } ZoneStatus;
 
+/* Callbacks called on each update of the types of mask, from the thread signaling the object. 0 if error */
+guint signaling_subscribe (LocationObject *obj, guint mask, LocationUpdateCB callback, gpointer user_data);
+gboolean signaling_unsubscribe (LocationObject *obj, guint id);
+
+/* Calls the subscribed callbacks, then emits "service-updated" only if a handler is connected.
+ * Positions and velocities are snapshots, see location-snapshot.h, referenced while the update is posted. */
+void update_signaling (LocationObject *obj, guint32 signals[LAST_SIGNAL], LocationUpdateType type, gconstpointer data, const LocationAccuracy *acc);
+
 void enable_signaling (LocationObject *obj,	guint32 signals[LAST_SIGNAL], gboolean *prev_enabled, gboolean enabled, LocationStatus status);
 
 void position_signaling (LocationObject *obj, guint32 signals[LAST_SIGNAL],
-		gboolean *prev_enabled, int interval, gboolean emit,
-		guint *updated_interval, LocationPosition **prev_pos,
-		GList *prev_bound, ZoneStatus *zone_status,
-		const LocationPosition *pos, const LocationAccuracy *acc);
+		gboolean *prev_enabled, guint interval_ms, gboolean emit,
+		gint64 *updated_time, LocationPosition **prev_pos, LatestFix *latest,
+		LocationBoundaryIndex *boundary_index, ZoneStatus *zone_status,
+		const LocationPosition *pos, const LocationAccuracy *acc, gint64 received_time);
 
 void velocity_signaling (LocationObject* obj, guint32 signals[LAST_SIGNAL],
-		gboolean *prev_enabled, int interval, gboolean emit,
-		guint *updated_timestamp, LocationVelocity **prev_vel, LocationAccuracy **prev_acc,
-		const LocationVelocity *vel, const LocationAccuracy *acc);
+		gboolean *prev_enabled, guint interval_ms, gboolean emit,
+		gint64 *updated_time, LocationVelocity **prev_vel, LocationAccuracy **prev_acc, LatestFix *latest,
+		const LocationVelocity *vel, const LocationAccuracy *acc, gint64 received_time);
 
 void satellite_signaling(LocationObject *obj, guint32 signals[LAST_SIGNAL],
 		gboolean *prev_enabled, int interval, gboolean emit,
-		guint *updated_timestamp, LocationSatellite **pre_sat,
+		guint *updated_timestamp, gboolean *sat_changed, LocationSatellite **pre_sat,
 		const LocationSatellite *sat);
 
+void fix_signaling (LocationObject *obj, guint32 signals[LAST_SIGNAL],
+		guint interval_ms, gboolean emit, guint complete,
+		gint64 *updated_time, LocationFix **prev_fix,
+		const LocationPosition *pos, const LocationVelocity *vel,
+		const LocationAccuracy *acc, const LocationSatellite *sat, gint64 received_time);
+
+void fix_timeout_signaling (LocationObject *obj, guint32 signals[LAST_SIGNAL], LocationFix *fix);
+
+/* Sets *batch to batch size positions delivered at least every latency seconds, delivering the pending ones first. 0 frees it */
+void batch_signaling_set (LocationBatch **batch, LocationObject *obj, guint32 signals[LAST_SIGNAL], guint size, guint latency);
+/* Frees the batch without delivering its positions */
+void batch_signaling_free (LocationBatch *batch);
+void batch_signaling (LocationBatch *batch, const LocationPosition *pos, const LocationAccuracy *acc);
+void batch_flush_signaling (LocationBatch *batch);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,87 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_SNAPSHOT_H__
+#define __LOCATION_SNAPSHOT_H__
+
+#include <location-position.h>
+#include <location-velocity.h>
+#include <location-accuracy.h>
+#include <location-satellite.h>
+#include <location-fix.h>
+
+/**
+ * @file location-snapshot.h
+ * @brief This file contains the update of the position, velocity, accuracy, satellites and fix kept by the location objects.
+ */
+
+G_BEGIN_DECLS
+
+/* Reference counted copies kept by the objects and shared with the signal handlers and the provider thread mailbox.
+ * Each one is the public struct followed by a reference count, allocated in the .c of its type, so a snapshot is
+ * shared instead of copied while the public functions only see the plain struct.
+ * They are released with *_snapshot_unref(), never with location_*_free(). A NULL value gives a zeroed one, without fix. */
+LocationPosition *position_snapshot_new (const LocationPosition *position);
+LocationPosition *position_snapshot_ref (LocationPosition *snapshot);
+void position_snapshot_unref (LocationPosition *snapshot);
+LocationVelocity *velocity_snapshot_new (const LocationVelocity *velocity);
+LocationVelocity *velocity_snapshot_ref (LocationVelocity *snapshot);
+void velocity_snapshot_unref (LocationVelocity *snapshot);
+LocationAccuracy *accuracy_snapshot_new (const LocationAccuracy *accuracy);
+LocationAccuracy *accuracy_snapshot_ref (LocationAccuracy *snapshot);
+void accuracy_snapshot_unref (LocationAccuracy *snapshot);
+
+/* Set *snapshot to the values of the new fix: in place when no other reference is held, else a new one replaces it */
+void position_snapshot_update (LocationPosition **snapshot, const LocationPosition *position);
+void velocity_snapshot_update (LocationVelocity **snapshot, const LocationVelocity *velocity);
+void accuracy_snapshot_update (LocationAccuracy **snapshot, const LocationAccuracy *accuracy);
+
+/* TRUE if the position or the velocity belongs to an epoch after the one of fix: another second, or a part it already has */
+gboolean fix_snapshot_starts_epoch (const LocationFix *fix, const LocationPosition *position, const LocationVelocity *velocity);
+
+/* Set the given parts of *snapshot, the others are kept unless the position or the velocity starts another epoch,
+ * received at received_time monotonic milliseconds */
+void fix_snapshot_update (LocationFix **snapshot, const LocationPosition *position, const LocationVelocity *velocity,
+		const LocationAccuracy *accuracy, const LocationSatellite *satellite, gint64 received_time);
+
+/* Latest position, velocity and accuracy of an object behind a sequence lock: written by the one thread signaling
+ * the object, read by any thread without lock nor allocation. The sequence is odd while a write is in progress. */
+typedef struct _LatestFix {
+	gint sequence;
+	guint fields;		/* LocationFixField of the parts received */
+	LocationPosition position;
+	LocationVelocity velocity;
+	LocationAccuracy accuracy;
+} LatestFix;
+
+/* Set the given parts, NULL ones are kept */
+void latest_fix_update (LatestFix *latest, const LocationPosition *position, const LocationVelocity *velocity, const LocationAccuracy *accuracy);
+
+/* Copy a consistent set of the parts into the caller ones, which may be NULL. Parts not received yet are zeroed.
+ * LOCATION_ERROR_NOT_AVAILABLE unless one of fields was received */
+int latest_fix_get (const LatestFix *latest, guint fields, LocationPosition *position, LocationVelocity *velocity, LocationAccuracy *accuracy);
+
+/* Set *snapshot to the satellites reported, in place while they fit. Returns FALSE if only the timestamp changed */
+gboolean satellite_snapshot_update (LocationSatellite **snapshot, const LocationSatellite *satellite);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "location-tangent-plane.h"
+#include "location-geodesic.h"
+#include "location-log.h"
+
+struct _LocationTangentPlane {
+	GeodesicPlane plane;
+};
+
+EXPORT_API LocationTangentPlane *
+location_tangent_plane_new (const LocationPosition *anchor)
+{
+	g_return_val_if_fail (anchor, NULL);
+
+	LocationTangentPlane *plane = g_slice_new0 (LocationTangentPlane);
+
+	geodesic_plane_init (&plane->plane, anchor->latitude, anchor->longitude, anchor->altitude);
+
+	return plane;
+}
+
+EXPORT_API void
+location_tangent_plane_free (LocationTangentPlane *plane)
+{
+	g_return_if_fail (plane);
+
+	g_slice_free (LocationTangentPlane, plane);
+}
+
+EXPORT_API int
+location_tangent_plane_forward (const LocationTangentPlane *plane, const LocationPosition *positions, guint count, gdouble *enu)
+{
+	g_return_val_if_fail (plane, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (positions || !count, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (enu || !count, LOCATION_ERROR_PARAMETER);
+
+	guint i;
+
+	for (i = 0; i < count; i++) {
+		geodesic_plane_forward (&plane->plane, positions[i].latitude, positions[i].longitude, positions[i].altitude, enu + 3 * i);
+	}
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API int
+location_tangent_plane_inverse (const LocationTangentPlane *plane, const gdouble *enu, guint count, LocationPosition *positions)
+{
+	g_return_val_if_fail (plane, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (enu || !count, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (positions || !count, LOCATION_ERROR_PARAMETER);
+
+	guint i;
+
+	for (i = 0; i < count; i++) {
+		geodesic_plane_inverse (&plane->plane, enu + 3 * i, &positions[i].latitude, &positions[i].longitude, &positions[i].altitude);
+	}
+
+	return LOCATION_ERROR_NONE;
+}
+
+EXPORT_API gdouble
+location_tangent_plane_get_error (gdouble range)
+{
+	return GEODESIC_PLANE_ERROR(range);
+}
@@ -0,0 +1,121 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_TANGENT_PLANE_H_
+#define __LOCATION_TANGENT_PLANE_H_
+
+#include <location-types.h>
+#include <location-position.h>
+
+G_BEGIN_DECLS
+
+/**
+ * @file location-tangent-plane.h
+ * @brief This file contains the definitions and functions of the local east, north, up frame around an anchor position.
+ */
+/**
+ * @addtogroup LocationAPI
+ * @{
+ * @defgroup LocationAPITangentPlane Location Tangent Plane
+ * @breif This provides APIs to convert positions around an anchor to planar coordinates and back
+ * @addtogroup LocationAPITangentPlane
+ * @{
+ */
+
+typedef struct _LocationTangentPlane LocationTangentPlane;
+
+/**
+ * @brief
+ * Create the east, north, up frame tangent to the WGS84 ellipsoid at an anchor position.
+ * @remarks The trigonometric terms and the earth-centered coordinates of the anchor are computed once,
+    so a conversion costs the terms of the converted position only. \n
+    The conversions are exact rotations and translations: the inverse gives back a position within a micrometer.
+    Distances and angles taken on east and north alone are planar approximations, see #location_tangent_plane_get_error.
+ * @pre     None.
+ * @post    #location_tangent_plane_free should be called when the plane is no longer needed.
+ * @param [in]  anchor - a #LocationPosition, the origin of the frame, its altitude included
+ * @return a new #LocationTangentPlane
+ * @retval NULL if error occured
+ */
+LocationTangentPlane *location_tangent_plane_new (const LocationPosition *anchor);
+
+/**
+ * @brief
+ * Free a #LocationTangentPlane.
+ * @remarks None.
+ * @pre     #location_tangent_plane_new should be called before.\n
+ * @post None.
+ * @param [in]  plane - a #LocationTangentPlane
+ * @return None.
+ */
+void location_tangent_plane_free (LocationTangentPlane *plane);
+
+/**
+ * @brief
+ * Convert positions to east, north, up coordinates.
+ * @remarks enu holds 3 * count values, the east, north and up of each position in meters.
+ * @pre     #location_tangent_plane_new should be called before.\n
+ * @post None.
+ * @param [in]  plane - a #LocationTangentPlane
+ * @param [in]  positions - an array of count #LocationPosition
+ * @param [in]  count - the number of positions
+ * @param [out] enu - an array of 3 * count #gdouble
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_tangent_plane_forward (const LocationTangentPlane *plane, const LocationPosition *positions, guint count, gdouble *enu);
+
+/**
+ * @brief
+ * Convert east, north, up coordinates to positions.
+ * @remarks Only the latitude, longitude and altitude of the positions are set.
+ * @pre     #location_tangent_plane_new should be called before.\n
+ * @post None.
+ * @param [in]  plane - a #LocationTangentPlane
+ * @param [in]  enu - an array of 3 * count #gdouble
+ * @param [in]  count - the number of positions
+ * @param [out] positions - an array of count #LocationPosition
+ * @return int
+ * @retval 0                              Success
+ * Please refer #LocationError for more information.
+ */
+int location_tangent_plane_inverse (const LocationTangentPlane *plane, const gdouble *enu, guint count, LocationPosition *positions);
+
+/**
+ * @brief
+ * Get the relative error of a distance taken on east and north, between positions at most range from the anchor.
+ * @remarks The bound is 0.6 * (range / 6371 km)^2 against the Vincenty distance: about 1.5e-8 at 1 km, 1.5e-6 at 10 km
+    and 1.5e-4 at 100 km. Up is the drop of the ellipsoid below the plane and is not part of the distance.
+ * @pre     None.
+ * @post None.
+ * @param [in]  range - the largest distance of the positions from the anchor, in meters
+ * @return gdouble
+ */
+gdouble location_tangent_plane_get_error (gdouble range);
+
+/**
+ * @} @}
+ */
+
+G_END_DECLS
+
+#endif
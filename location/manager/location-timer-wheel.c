@@ -0,0 +1,292 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "location-timer-wheel.h"
+#include "location-log.h"
+
+/**
+ * All the periodic timers of the process hang off one hashed wheel driven by a single main loop
+ * source, armed for the earliest tick holding a due timer. A timer first fires one full period after
+ * it is added or reprogrammed, as with g_timeout_add (), then its deadlines are the multiples of its
+ * period on the monotonic clock: the timers sharing a period, or whose periods divide each other,
+ * expire on the same tick and cost one wakeup. Each timer sits in the doubly linked list of
+ * its slot, which makes adding, removing and reprogramming it O(1).
+ * The timers may be handled from any thread, the functions are called without the wheel locked.
+ */
+typedef struct _WheelTimer {
+	guint id;
+	guint interval_ms;
+	gint64 deadline;	/* milliseconds on the monotonic clock */
+	gint64 tick;		/* tick the timer fires on */
+	gboolean linked;	/* FALSE while its function is running */
+	GSourceFunc func;
+	gpointer data;
+	struct _WheelTimer *prev;
+	struct _WheelTimer *next;
+} WheelTimer;
+
+static struct {
+	WheelTimer *slots[TIMER_WHEEL_SLOTS];
+	GHashTable *timers;	/* id -> WheelTimer */
+	guint last_id;
+	gint64 tick;		/* last tick dispatched */
+	guint source;
+	gint64 source_tick;	/* tick the source is armed for */
+} wheel;
+
+G_LOCK_DEFINE_STATIC (wheel);
+
+static gint64
+_timer_wheel_now (void)
+{
+	return g_get_monotonic_time () / 1000;
+}
+
+static void
+_timer_wheel_link (WheelTimer *timer)
+{
+	WheelTimer **slot;
+
+	/* Deadlines round up to their tick so no timer fires early, and the current tick was already dispatched */
+	timer->tick = MAX((timer->deadline + TIMER_WHEEL_TICK_MS - 1) / TIMER_WHEEL_TICK_MS, wheel.tick + 1);
+	slot = &wheel.slots[timer->tick % TIMER_WHEEL_SLOTS];
+	timer->prev = NULL;
+	timer->next = *slot;
+	if (*slot) (*slot)->prev = timer;
+	*slot = timer;
+	timer->linked = TRUE;
+}
+
+static void
+_timer_wheel_unlink (WheelTimer *timer)
+{
+	if (!timer->linked) return;
+
+	if (timer->prev) timer->prev->next = timer->next;
+	else wheel.slots[timer->tick % TIMER_WHEEL_SLOTS] = timer->next;
+	if (timer->next) timer->next->prev = timer->prev;
+	timer->prev = timer->next = NULL;
+	timer->linked = FALSE;
+}
+
+/* First deadline, a whole period from now */
+static void
+_timer_wheel_start (WheelTimer *timer, gint64 now)
+{
+	timer->deadline = now + timer->interval_ms;
+	_timer_wheel_link (timer);
+}
+
+/* Next multiple of the period after the last deadline, or after now when periods were missed */
+static void
+_timer_wheel_schedule (WheelTimer *timer, gint64 now)
+{
+	gint64 from = MAX(timer->deadline, now);
+	timer->deadline = (from / timer->interval_ms + 1) * timer->interval_ms;
+	_timer_wheel_link (timer);
+}
+
+static void
+_timer_wheel_free (gpointer data)
+{
+	g_slice_free (WheelTimer, data);
+}
+
+static gboolean _timer_wheel_cb (gpointer data);
+
+/* Makes sure the source fires no later than tick */
+static void
+_timer_wheel_arm (gint64 tick)
+{
+	gint64 delay = tick * TIMER_WHEEL_TICK_MS - _timer_wheel_now ();
+
+	if (wheel.source) {
+		if (wheel.source_tick <= tick) return;
+		g_source_remove (wheel.source);
+	}
+	wheel.source_tick = tick;
+	wheel.source = g_timeout_add (MAX(delay, 0), _timer_wheel_cb, NULL);
+}
+
+/* Earliest tick holding a linked timer, 0 if there is none */
+static gint64
+_timer_wheel_next_tick (void)
+{
+	GHashTableIter iter;
+	gpointer value = NULL;
+	gint64 next = 0;
+	gint64 tick;
+
+	for (tick = wheel.tick + 1; tick <= wheel.tick + TIMER_WHEEL_SLOTS; tick++) {
+		WheelTimer *timer;
+		for (timer = wheel.slots[tick % TIMER_WHEEL_SLOTS]; timer; timer = timer->next) {
+			if (timer->tick <= tick) return tick;
+		}
+	}
+
+	/* Every timer is more than one turn of the wheel away */
+	g_hash_table_iter_init (&iter, wheel.timers);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		WheelTimer *timer = value;
+		if (timer->linked && (!next || timer->tick < next)) next = timer->tick;
+	}
+	return next;
+}
+
+static gboolean
+_timer_wheel_cb (gpointer data)
+{
+	gint64 now = _timer_wheel_now ();
+	gint64 now_tick = now / TIMER_WHEEL_TICK_MS;
+	gint64 ticks;
+	GArray *due = g_array_new (FALSE, FALSE, sizeof (guint));
+	gint64 next;
+	gint64 i;
+	guint idx;
+
+	G_LOCK (wheel);
+	wheel.source = 0;
+	ticks = MIN(now_tick - wheel.tick, TIMER_WHEEL_SLOTS);
+
+	/* The functions may add, remove or reprogram any timer, so the due ones are gathered by id first */
+	for (i = 1; i <= ticks; i++) {
+		WheelTimer *timer;
+		for (timer = wheel.slots[(wheel.tick + i) % TIMER_WHEEL_SLOTS]; timer; timer = timer->next) {
+			if (timer->tick <= now_tick) g_array_append_val (due, timer->id);
+		}
+	}
+	if (now_tick > wheel.tick) wheel.tick = now_tick;
+
+	for (idx = 0; idx < due->len; idx++) {
+		guint id = g_array_index (due, guint, idx);
+		WheelTimer *timer = g_hash_table_lookup (wheel.timers, GUINT_TO_POINTER(id));
+		GSourceFunc func;
+		gpointer func_data;
+		gboolean keep;
+
+		if (!timer || !timer->linked || timer->tick > now_tick) continue;
+
+		_timer_wheel_unlink (timer);
+		func = timer->func;
+		func_data = timer->data;
+		G_UNLOCK (wheel);
+		keep = func (func_data);
+		G_LOCK (wheel);
+
+		/* Removed or reprogrammed by its own function */
+		timer = g_hash_table_lookup (wheel.timers, GUINT_TO_POINTER(id));
+		if (!timer || timer->linked) continue;
+
+		if (!keep) {
+			g_hash_table_remove (wheel.timers, GUINT_TO_POINTER(id));
+			continue;
+		}
+		_timer_wheel_schedule (timer, now);
+	}
+	g_array_free (due, TRUE);
+
+	next = _timer_wheel_next_tick ();
+	if (next) _timer_wheel_arm (next);
+	G_UNLOCK (wheel);
+
+	return FALSE;
+}
+
+guint
+timer_wheel_add (guint interval_ms, GSourceFunc func, gpointer data)
+{
+	g_return_val_if_fail(func, 0);
+
+	WheelTimer *timer = g_slice_new0 (WheelTimer);
+	gint64 now = _timer_wheel_now ();
+	guint id;
+
+	G_LOCK (wheel);
+	if (!wheel.timers) wheel.timers = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, _timer_wheel_free);
+	if (!g_hash_table_size (wheel.timers)) wheel.tick = now / TIMER_WHEEL_TICK_MS;
+
+	do {
+		wheel.last_id++;
+	} while (!wheel.last_id || g_hash_table_lookup (wheel.timers, GUINT_TO_POINTER(wheel.last_id)));
+
+	timer->id = wheel.last_id;
+	timer->interval_ms = MAX(interval_ms, 1);
+	timer->func = func;
+	timer->data = data;
+	_timer_wheel_start (timer, now);
+	g_hash_table_insert (wheel.timers, GUINT_TO_POINTER(timer->id), timer);
+
+	_timer_wheel_arm (timer->tick);
+	id = timer->id;
+	G_UNLOCK (wheel);
+
+	return id;
+}
+
+void
+timer_wheel_set_interval (guint id, guint interval_ms)
+{
+	WheelTimer *timer = NULL;
+
+	G_LOCK (wheel);
+	if (wheel.timers) timer = g_hash_table_lookup (wheel.timers, GUINT_TO_POINTER(id));
+	if (!timer) {
+		G_UNLOCK (wheel);
+		LOCATION_LOGW("No timer [%u] in the wheel", id);
+		return;
+	}
+
+	_timer_wheel_unlink (timer);
+	timer->interval_ms = MAX(interval_ms, 1);
+	_timer_wheel_start (timer, _timer_wheel_now ());
+
+	_timer_wheel_arm (timer->tick);
+	G_UNLOCK (wheel);
+}
+
+gboolean
+timer_wheel_remove (guint id)
+{
+	WheelTimer *timer = NULL;
+
+	G_LOCK (wheel);
+	if (wheel.timers) timer = g_hash_table_lookup (wheel.timers, GUINT_TO_POINTER(id));
+	if (!timer) {
+		G_UNLOCK (wheel);
+		LOCATION_LOGW("No timer [%u] in the wheel", id);
+		return FALSE;
+	}
+
+	_timer_wheel_unlink (timer);
+	g_hash_table_remove (wheel.timers, GUINT_TO_POINTER(id));
+
+	if (!g_hash_table_size (wheel.timers) && wheel.source) {
+		g_source_remove (wheel.source);
+		wheel.source = 0;
+	}
+	G_UNLOCK (wheel);
+
+	return TRUE;
+}
@@ -0,0 +1,48 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCATION_TIMER_WHEEL_H__
+#define __LOCATION_TIMER_WHEEL_H__
+
+#include <glib.h>
+
+/**
+ * @file location-timer-wheel.h
+ * @brief This file contains the timer wheel shared by all the LocationObjects of the process for their periodic updates.
+ */
+
+G_BEGIN_DECLS
+
+#define TIMER_WHEEL_TICK_MS	100	/* deadlines within the same tick fire together */
+#define TIMER_WHEEL_SLOTS	256
+
+/* Same contract as g_timeout_add () on the default main context: func is called every interval_ms
+ * until it returns FALSE or the timer is removed. Returns a non-zero id. The first call comes after
+ * interval_ms, the next ones on the multiples of interval_ms of the monotonic clock, so the second
+ * period may be shorter. */
+guint timer_wheel_add (guint interval_ms, GSourceFunc func, gpointer data);
+/* Changes the period of a timer in place, it next fires a whole new period later */
+void timer_wheel_set_interval (guint id, guint interval_ms);
+gboolean timer_wheel_remove (guint id);
+
+G_END_DECLS
+
+#endif
@@ -24,8 +24,15 @@
 #endif
 
 #include "location-velocity.h"
+#include "location-snapshot.h"
 #include "location-log.h"
 
+/* Layout of the velocity_snapshot_*() copies, see location-snapshot.h */
+typedef struct {
+	LocationVelocity velocity;
+	volatile gint ref_count;
+} VelocitySnapshot;
+
 GType
 location_velocity_get_type (void)
 {
@@ -46,7 +53,7 @@ location_velocity_new (guint timestamp,
 	gdouble direction,
 	gdouble climb)
 {
-	LocationVelocity* velocity = g_slice_new0(LocationVelocity);
+	LocationVelocity *velocity = g_slice_new0(LocationVelocity);
 	velocity->timestamp = timestamp;
 	velocity->speed = speed;
 	velocity->direction = direction;
@@ -61,6 +68,47 @@ location_velocity_free (LocationVelocity* velocity)
 	g_slice_free(LocationVelocity, velocity);
 }
 
+LocationVelocity *
+velocity_snapshot_new (const LocationVelocity *velocity)
+{
+	VelocitySnapshot *snapshot = g_slice_new0(VelocitySnapshot);
+	if (velocity) snapshot->velocity = *velocity;
+	snapshot->ref_count = 1;
+	return &snapshot->velocity;
+}
+
+LocationVelocity *
+velocity_snapshot_ref (LocationVelocity *snapshot)
+{
+	g_return_val_if_fail(snapshot, NULL);
+
+	g_atomic_int_inc(&((VelocitySnapshot *) snapshot)->ref_count);
+	return snapshot;
+}
+
+void
+velocity_snapshot_unref (LocationVelocity *snapshot)
+{
+	g_return_if_fail(snapshot);
+
+	if (g_atomic_int_dec_and_test(&((VelocitySnapshot *) snapshot)->ref_count))
+		g_slice_free(VelocitySnapshot, (VelocitySnapshot *) snapshot);
+}
+
+void
+velocity_snapshot_update (LocationVelocity **snapshot, const LocationVelocity *velocity)
+{
+	g_return_if_fail(snapshot);
+	g_return_if_fail(velocity);
+
+	if (*snapshot && g_atomic_int_get(&((VelocitySnapshot *) *snapshot)->ref_count) == 1) {
+		**snapshot = *velocity;
+		return;
+	}
+	if (*snapshot) velocity_snapshot_unref(*snapshot);
+	*snapshot = velocity_snapshot_new(velocity);
+}
+
 EXPORT_API gboolean
 location_velocity_equal (const LocationVelocity *velocity1, const LocationVelocity *velocity2)
 {
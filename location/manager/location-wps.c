@@ -33,6 +33,9 @@
 #include "location-ielement.h"
 #include "location-signaling-util.h"
 #include "location-common-util.h"
+#include "location-history.h"
+#include "location-timer-wheel.h"
+#include "location-provider-thread.h"
 /*
  * forward definitions
  */
@@ -42,18 +45,29 @@ typedef struct _LocationWpsPrivate {
 	gboolean is_started;
 	gboolean set_noti;
 	gboolean enabled;
-	guint	pos_updated_timestamp;
-	guint	pos_interval;
-	guint	vel_updated_timestamp;
-	guint	vel_interval;
+	gint64	pos_updated_time;
+	guint	pos_interval_ms;
+	gint64	vel_updated_time;
+	guint	vel_interval_ms;
 	LocationPosition *pos;
 	LocationVelocity *vel;
 	LocationAccuracy *acc;
+	LatestFix latest;
 	GList *boundary_list;
+	LocationBoundaryIndex *boundary_index;
 	ZoneStatus zone_status;
+	LocationFix *fix;
+	gint64	fix_updated_time;
+	gboolean fix_updates;
+	LocationHistory *history;
+	LocationBatch *batch;
+	guint batch_size;
+	guint batch_latency;
 
 	guint		pos_timer;
 	guint		vel_timer;
+
+	ProviderThread	*provider_thread;
 } LocationWpsPrivate;
 
 enum {
@@ -64,6 +78,18 @@ enum {
 	PROP_VEL_INTERVAL,
 	PROP_BOUNDARY,
 	PROP_REMOVAL_BOUNDARY,
+	PROP_REMOVAL_BOUNDARY_LIST,
+	PROP_BOUNDARY_STORE,
+	PROP_ZONE_CROSSING,
+	PROP_SUBSCRIBE_FENCE_SET,
+	PROP_UNSUBSCRIBE_FENCE_SET,
+	PROP_FIX_UPDATES,
+	PROP_POS_INTERVAL_MS,
+	PROP_VEL_INTERVAL_MS,
+	PROP_HISTORY_SIZE,
+	PROP_BATCH_SIZE,
+	PROP_BATCH_LATENCY,
+	PROP_PROVIDER_THREAD,
 	PROP_MAX
 };
 
@@ -85,28 +111,39 @@ _position_timeout_cb (gpointer data)
 	LocationWpsPrivate *priv = GET_PRIVATE(object);
 	if (!priv) return FALSE;
 
+	/* Emitted from the provider thread, in order with the updates */
+	if (provider_thread_defer_source (object, _position_timeout_cb)) return TRUE;
+
+	/* Delivered with the batch */
+	if (priv->batch) return TRUE;
+
+	if (priv->fix_updates) {
+		fix_timeout_signaling(object, signals, priv->fix);
+		return TRUE;
+	}
+
 	LocationPosition *pos = NULL;
 	LocationAccuracy *acc = NULL;
 
 	if (priv->pos) {
-		pos = location_position_copy(priv->pos);
+		pos = position_snapshot_ref (priv->pos);
 	}
 	else {
-		pos = location_position_new (0, 0.0, 0.0, 0.0, LOCATION_STATUS_NO_FIX);
+		pos = position_snapshot_new (NULL);
 	}
 
 	if (priv->acc) {
-		acc = location_accuracy_copy (priv->acc);
+		acc = accuracy_snapshot_ref (priv->acc);
 	}
 	else {
-		acc = location_accuracy_new (LOCATION_ACCURACY_LEVEL_NONE, 0.0, 0.0);
+		acc = accuracy_snapshot_new (NULL);
 	}
 
 	LOCATION_LOGD("POSITION SERVICE_UPDATED");
-	g_signal_emit(object, signals[SERVICE_UPDATED], 0, POSITION_UPDATED, pos, acc);
+	update_signaling(object, signals, POSITION_UPDATED, pos, acc);
 
-	location_position_free (pos);
-	location_accuracy_free (acc);
+	position_snapshot_unref (pos);
+	accuracy_snapshot_unref (acc);
 
 	return TRUE;
 }
@@ -118,28 +155,37 @@ _velocity_timeout_cb (gpointer data)
 	LocationWpsPrivate *priv = GET_PRIVATE(object);
 	if (!priv) return FALSE;
 
+	/* Emitted from the provider thread, in order with the updates */
+	if (provider_thread_defer_source (object, _velocity_timeout_cb)) return TRUE;
+
+	/* Delivered with the batch */
+	if (priv->batch) return TRUE;
+
+	/* Carried by the fix of the position timer */
+	if (priv->fix_updates) return TRUE;
+
 	LocationVelocity *vel = NULL;
 	LocationAccuracy *acc = NULL;
 
 	if (priv->vel) {
-		vel = location_velocity_copy(priv->vel);
+		vel = velocity_snapshot_ref (priv->vel);
 	}
 	else {
-		vel = location_velocity_new (0, 0.0, 0.0, 0.0);
+		vel = velocity_snapshot_new (NULL);
 	}
 
 	if (priv->acc) {
-		acc = location_accuracy_copy (priv->acc);
+		acc = accuracy_snapshot_ref (priv->acc);
 	}
 	else {
-		acc = location_accuracy_new (LOCATION_ACCURACY_LEVEL_NONE, 0.0, 0.0);
+		acc = accuracy_snapshot_new (NULL);
 	}
 
 	LOCATION_LOGD("POSITION SERVICE_UPDATED");
-	g_signal_emit(object, signals[SERVICE_UPDATED], 0, VELOCITY_UPDATED, vel, acc);
+	update_signaling(object, signals, VELOCITY_UPDATED, vel, acc);
 
-	location_velocity_free (vel);
-	location_accuracy_free (acc);
+	velocity_snapshot_unref (vel);
+	accuracy_snapshot_unref (acc);
 
 	return TRUE;
 }
@@ -151,15 +197,16 @@ wps_status_cb (gboolean enabled,
 {
 	LOCATION_LOGD("wps_status_cb");
 	g_return_if_fail(self);
+	if (provider_thread_defer_status (self, wps_status_cb, enabled, status)) return;
 	LocationWpsPrivate* priv = GET_PRIVATE(self);
 	enable_signaling(self, signals, &(priv->enabled), enabled, status);
 	if (!priv->enabled) {
 		if (priv->pos_timer) {
-			g_source_remove (priv->pos_timer);
+			timer_wheel_remove (priv->pos_timer);
 			priv->pos_timer = 0;
 		}
 		if (priv->vel_timer) {
-			g_source_remove (priv->vel_timer);
+			timer_wheel_remove (priv->vel_timer);
 			priv->vel_timer = 0;
 		}
 	}
@@ -177,13 +224,20 @@ wps_position_cb (gboolean enabled,
 	g_return_if_fail(acc);
 	LocationWpsPrivate* priv = GET_PRIVATE(self);
 
+	if (provider_thread_defer_position (self, wps_position_cb, enabled, pos, acc)) return;
+	/* Stamped on reception, the timestamp of the provider is in whole seconds */
+	gint64 received_time = provider_thread_get_received_time (self);
+
 	if (!priv->enabled && enabled) {
-		if (!priv->pos_timer) priv->pos_timer = g_timeout_add_seconds (priv->pos_interval, _position_timeout_cb, self);
-		if (!priv->vel_timer) priv->vel_timer = g_timeout_add_seconds (priv->vel_interval, _velocity_timeout_cb, self);
+		if (!priv->pos_timer) priv->pos_timer = timer_wheel_add (priv->pos_interval_ms, _position_timeout_cb, self);
+		if (!priv->vel_timer) priv->vel_timer = timer_wheel_add (priv->vel_interval_ms, _velocity_timeout_cb, self);
 	}
 
 	enable_signaling(self, signals, &(priv->enabled), enabled, pos->status);
-	position_signaling(self, signals, &(priv->enabled), priv->pos_interval, FALSE, &(priv->pos_updated_timestamp), &(priv->pos), priv->boundary_list, &(priv->zone_status), pos, acc);
+	position_signaling(self, signals, &(priv->enabled), priv->pos_interval_ms, FALSE, &(priv->pos_updated_time), &(priv->pos), &(priv->latest), priv->boundary_index, &(priv->zone_status), pos, acc, received_time);
+	fix_signaling(self, signals, priv->pos_interval_ms, FALSE, LOCATION_FIX_POSITION, &(priv->fix_updated_time), &(priv->fix), pos, NULL, acc, NULL, received_time);
+	if (priv->history) history_append(priv->history, pos, acc, received_time);
+	if (priv->batch) batch_signaling(priv->batch, pos, acc);
 }
 
 static void
@@ -194,8 +248,13 @@ wps_velocity_cb(gboolean enabled,
 {
 	LOCATION_LOGD("wps_velocity_cb");
 	g_return_if_fail(self);
+	g_return_if_fail(vel);
 	LocationWpsPrivate* priv = GET_PRIVATE(self);
-	velocity_signaling(self, signals, &(priv->enabled), priv->vel_interval, FALSE, &(priv->vel_updated_timestamp), &(priv->vel), &(priv->acc), vel, acc);
+
+	if (provider_thread_defer_velocity (self, wps_velocity_cb, enabled, vel, acc)) return;
+	gint64 received_time = provider_thread_get_received_time (self);
+	velocity_signaling(self, signals, &(priv->enabled), priv->vel_interval_ms, FALSE, &(priv->vel_updated_time), &(priv->vel), &(priv->acc), &(priv->latest), vel, acc, received_time);
+	fix_signaling(self, signals, priv->pos_interval_ms, FALSE, LOCATION_FIX_POSITION, &(priv->fix_updated_time), &(priv->fix), NULL, vel, acc, NULL, received_time);
 }
 
 static void
@@ -210,6 +269,7 @@ location_setting_wps_cb(keynode_t *key,
 	g_return_if_fail (priv->mod->handler);
 
 	int ret = LOCATION_ERROR_NONE;
+	ProviderThread *thread = provider_thread_lock (self);
 
 	if (location_setting_get_key_val(key) == 0) {
 		if (priv->mod->ops.stop && priv->is_started) {
@@ -228,7 +288,7 @@ location_setting_wps_cb(keynode_t *key,
 			}
 		}
 	}
-
+	provider_thread_unlock (thread);
 }
 
 static int
@@ -300,16 +360,19 @@ location_wps_dispose (GObject *gobject)
 	LOCATION_LOGD("location_wps_dispose");
 
 	LocationWpsPrivate* priv = GET_PRIVATE(gobject);
+
+	/* First, its callbacks may set the timers */
+	set_prop_provider_thread (gobject, &(priv->provider_thread), FALSE);
 	if (priv->set_noti == TRUE) {
 		location_setting_ignore_notify (VCONFKEY_LOCATION_NETWORK_ENABLED, location_setting_wps_cb);
 		priv->set_noti = FALSE;
 
 		if (priv->pos_timer) {
-			g_source_remove (priv->pos_timer);
+			timer_wheel_remove (priv->pos_timer);
 			priv->pos_timer = 0;
 		}
 		if (priv->vel_timer) {
-			g_source_remove (priv->vel_timer);
+			timer_wheel_remove (priv->vel_timer);
 			priv->vel_timer = 0;
 		}
 
@@ -325,25 +388,45 @@ location_wps_finalize (GObject *gobject)
 	LocationWpsPrivate* priv = GET_PRIVATE(gobject);
 	module_free(priv->mod, "wps");
 
+	if (priv->boundary_index) {
+		boundary_index_free (priv->boundary_index);
+		priv->boundary_index = NULL;
+	}
+
 	if (priv->boundary_list) {
 		g_list_free_full (priv->boundary_list, free_boundary_list);
 		priv->boundary_list = NULL;
 	}
 
 	if (priv->pos) {
-		location_position_free(priv->pos);
+		position_snapshot_unref(priv->pos);
 		priv->pos = NULL;
 	}
 
 	if (priv->vel) {
-		location_velocity_free(priv->vel);
+		velocity_snapshot_unref(priv->vel);
 		priv->vel = NULL;
 	}
 
 	if (priv->acc) {
-		location_accuracy_free(priv->acc);
+		accuracy_snapshot_unref(priv->acc);
 		priv->acc = NULL;
 	}
+
+	if (priv->fix) {
+		location_fix_free(priv->fix);
+		priv->fix = NULL;
+	}
+
+	if (priv->history) {
+		history_free(priv->history);
+		priv->history = NULL;
+	}
+
+	if (priv->batch) {
+		batch_signaling_free(priv->batch);
+		priv->batch = NULL;
+	}
 	G_OBJECT_CLASS (location_wps_parent_class)->finalize (gobject);
 }
 
@@ -356,52 +439,93 @@ location_wps_set_property (GObject *object,
 	LocationWpsPrivate* priv = GET_PRIVATE(object);
 	int ret = 0;
 
+	if (property_id == PROP_PROVIDER_THREAD) {
+		LOCATION_LOGD("Set prop>> provider-thread: %d", g_value_get_boolean(value));
+		set_prop_provider_thread(object, &(priv->provider_thread), g_value_get_boolean(value));
+		return;
+	}
+
+	ProviderThread *thread = provider_thread_lock (object);
 	switch (property_id){
 		case PROP_BOUNDARY:{
-			GList *boundary_list = (GList *)g_list_copy(g_value_get_pointer(value));
-			ret = set_prop_boundary(&priv->boundary_list, boundary_list);
+			GList *boundary_list = (GList *) g_value_get_pointer(value);
+			ret = set_prop_boundary(&priv->boundary_list, priv->boundary_index, boundary_list);
 			if(ret != 0) LOCATION_LOGD("Set boundary. Error[%d]", ret);
 			break;
 		}
 		case PROP_REMOVAL_BOUNDARY: {
 			LocationBoundary *req_boundary = (LocationBoundary*) g_value_dup_boxed(value);
-			ret = set_prop_removal_boundary(&priv->boundary_list, req_boundary);
+			ret = set_prop_removal_boundary(&priv->boundary_list, priv->boundary_index, req_boundary);
 			if(ret != 0) LOCATION_LOGD("Set removal boundary. Error[%d]", ret);
+			if (req_boundary) location_boundary_free(req_boundary);
 			break;
 		}
-		case PROP_POS_INTERVAL: {
+		case PROP_REMOVAL_BOUNDARY_LIST: {
+			GList *boundary_list = (GList *) g_value_get_pointer(value);
+			ret = set_prop_removal_boundary_list(&priv->boundary_list, priv->boundary_index, boundary_list);
+			if(ret != 0) LOCATION_LOGD("Set removal boundary list. Error[%d]", ret);
+			break;
+		}
+		case PROP_BOUNDARY_STORE: {
+			LocationBoundaryStore *store = (LocationBoundaryStore *) g_value_get_pointer(value);
+			boundary_index_set_store(priv->boundary_index, store);
+			break;
+		}
+		case PROP_ZONE_CROSSING: {
+			gboolean crossing = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> zone-crossing: %d", crossing);
+			boundary_index_set_crossing(priv->boundary_index, crossing);
+			break;
+		}
+		case PROP_SUBSCRIBE_FENCE_SET: {
+			guint handle = g_value_get_uint(value);
+			ret = boundary_index_subscribe(priv->boundary_index, handle);
+			if(ret != 0) LOCATION_LOGD("Subscribe fence set [%u]. Error[%d]", handle, ret);
+			break;
+		}
+		case PROP_UNSUBSCRIBE_FENCE_SET: {
+			guint handle = g_value_get_uint(value);
+			ret = boundary_index_unsubscribe(priv->boundary_index, handle);
+			if(ret != 0) LOCATION_LOGD("Unsubscribe fence set [%u]. Error[%d]", handle, ret);
+			break;
+		}
+		case PROP_FIX_UPDATES: {
+			priv->fix_updates = g_value_get_boolean(value);
+			LOCATION_LOGD("Set prop>> fix-updates: %d", priv->fix_updates);
+			break;
+		}
+		case PROP_BATCH_SIZE: {
+			priv->batch_size = g_value_get_uint(value);
+			LOCATION_LOGD("Set prop>> batch-size: %u", priv->batch_size);
+			batch_signaling_set(&(priv->batch), object, signals, priv->batch_size, priv->batch_latency);
+			break;
+		}
+		case PROP_BATCH_LATENCY: {
+			priv->batch_latency = g_value_get_uint(value);
+			batch_signaling_set(&(priv->batch), object, signals, priv->batch_size, priv->batch_latency);
+			break;
+		}
+		case PROP_HISTORY_SIZE: {
+			history_set_size(&(priv->history), g_value_get_uint(value));
+			break;
+		}
+		case PROP_POS_INTERVAL:
+		case PROP_POS_INTERVAL_MS: {
 			guint interval = g_value_get_uint(value);
-			if(interval > 0) {
-				if(interval < LOCATION_UPDATE_INTERVAL_MAX)
-					priv->pos_interval = interval;
-				else
-					priv->pos_interval = (guint)LOCATION_UPDATE_INTERVAL_MAX;
-			}
-			else
-				priv->pos_interval = (guint)LOCATION_UPDATE_INTERVAL_DEFAULT;
+			if (property_id == PROP_POS_INTERVAL) interval = MIN(interval, LOCATION_UPDATE_INTERVAL_MAX) * 1000;
+			priv->pos_interval_ms = get_update_interval_ms(interval);
 
-			if (priv->pos_timer) {
-				g_source_remove (priv->pos_timer);
-				priv->pos_timer = g_timeout_add_seconds (priv->pos_interval, _position_timeout_cb, object);
-			}
+			if (priv->pos_timer) timer_wheel_set_interval (priv->pos_timer, priv->pos_interval_ms);
 
 			break;
 		}
-		case PROP_VEL_INTERVAL: {
+		case PROP_VEL_INTERVAL:
+		case PROP_VEL_INTERVAL_MS: {
 			guint interval = g_value_get_uint(value);
-			if(interval > 0) {
-				if(interval < LOCATION_UPDATE_INTERVAL_MAX)
-					priv->vel_interval = interval;
-				else
-					priv->vel_interval = (guint)LOCATION_UPDATE_INTERVAL_MAX;
-			}
-			else
-				priv->vel_interval = (guint)LOCATION_UPDATE_INTERVAL_DEFAULT;
+			if (property_id == PROP_VEL_INTERVAL) interval = MIN(interval, LOCATION_UPDATE_INTERVAL_MAX) * 1000;
+			priv->vel_interval_ms = get_update_interval_ms(interval);
 
-			if (priv->vel_timer) {
-				g_source_remove (priv->vel_timer);
-				priv->vel_timer = g_timeout_add_seconds (priv->vel_interval, _velocity_timeout_cb, object);
-			}
+			if (priv->vel_timer) timer_wheel_set_interval (priv->vel_timer, priv->vel_interval_ms);
 
 			break;
 		}
@@ -409,6 +533,7 @@ location_wps_set_property (GObject *object,
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
 			break;
 	}
+	provider_thread_unlock (thread);
 }
 
 static void
@@ -419,6 +544,7 @@ location_wps_get_property (GObject *object,
 {
 	LocationWpsPrivate *priv = GET_PRIVATE (object);
 
+	ProviderThread *thread = provider_thread_lock (object);
 	switch (property_id){
 		case PROP_METHOD_TYPE:
 			g_value_set_int(value, LOCATION_METHOD_WPS);
@@ -429,16 +555,41 @@ location_wps_get_property (GObject *object,
 		case PROP_BOUNDARY:
 			g_value_set_pointer(value, g_list_first(priv->boundary_list));
 			break;
+		case PROP_ZONE_CROSSING:
+			g_value_set_boolean(value, boundary_index_get_crossing(priv->boundary_index));
+			break;
+		case PROP_FIX_UPDATES:
+			g_value_set_boolean(value, priv->fix_updates);
+			break;
+		case PROP_BATCH_SIZE:
+			g_value_set_uint(value, priv->batch_size);
+			break;
+		case PROP_BATCH_LATENCY:
+			g_value_set_uint(value, priv->batch_latency);
+			break;
+		case PROP_PROVIDER_THREAD:
+			g_value_set_boolean(value, priv->provider_thread != NULL);
+			break;
+		case PROP_HISTORY_SIZE:
+			g_value_set_uint(value, history_get_size(priv->history));
+			break;
 		case PROP_POS_INTERVAL:
-			g_value_set_uint(value, priv->pos_interval);
+			g_value_set_uint(value, MAX(priv->pos_interval_ms / 1000, LOCATION_UPDATE_INTERVAL_MIN));
 			break;
 		case PROP_VEL_INTERVAL:
-			g_value_set_uint(value, priv->vel_interval);
+			g_value_set_uint(value, MAX(priv->vel_interval_ms / 1000, LOCATION_UPDATE_INTERVAL_MIN));
+			break;
+		case PROP_POS_INTERVAL_MS:
+			g_value_set_uint(value, priv->pos_interval_ms);
+			break;
+		case PROP_VEL_INTERVAL_MS:
+			g_value_set_uint(value, priv->vel_interval_ms);
 			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
 			break;
 	}
+	provider_thread_unlock (thread);
 }
 
 static int
@@ -453,6 +604,7 @@ location_wps_get_position (LocationWps *self,
 	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
 	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
 
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
 	if (priv->pos) {
 		*position = location_position_copy (priv->pos);
 		ret = LOCATION_ERROR_NONE;
@@ -460,6 +612,7 @@ location_wps_get_position (LocationWps *self,
 	if (priv->acc) {
 		*accuracy = location_accuracy_copy (priv->acc);
 	}
+	provider_thread_unlock (thread);
 
 	return ret;
 }
@@ -496,6 +649,7 @@ location_wps_get_velocity (LocationWps *self,
 	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
 	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
 
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
 	if (priv->vel) {
 		*velocity = location_velocity_copy (priv->vel);
 		ret = LOCATION_ERROR_NONE;
@@ -504,6 +658,7 @@ location_wps_get_velocity (LocationWps *self,
 	if (priv->acc) {
 		*accuracy = location_accuracy_copy (priv->acc);
 	}
+	provider_thread_unlock (thread);
 
 	return ret;
 }
@@ -543,6 +698,141 @@ location_wps_get_last_satellite (LocationWps *self,
 	return LOCATION_ERROR_NOT_SUPPORTED;
 }
 
+static int
+location_wps_get_fix (LocationWps *self,
+	LocationFix **fix)
+{
+	int ret = LOCATION_ERROR_NOT_AVAILABLE;
+	LOCATION_LOGD("location_wps_get_fix");
+
+	LocationWpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	if (priv->fix) {
+		*fix = location_fix_ref (priv->fix);
+		ret = LOCATION_ERROR_NONE;
+	}
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
+static int
+location_wps_get_position_into (LocationWps *self,
+	LocationPosition *position,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_wps_get_position_into");
+
+	LocationWpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_POSITION, position, NULL, accuracy);
+}
+
+static int
+location_wps_get_velocity_into (LocationWps *self,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_wps_get_velocity_into");
+
+	LocationWpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_VELOCITY, NULL, velocity, accuracy);
+}
+
+static int
+location_wps_get_latest_fix (LocationWps *self,
+	LocationPosition *position,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	LOCATION_LOGD("location_wps_get_latest_fix");
+
+	LocationWpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
+
+	return latest_fix_get (&(priv->latest), LOCATION_FIX_POSITION | LOCATION_FIX_VELOCITY, position, velocity, accuracy);
+}
+
+static int
+location_wps_get_satellite_into (LocationWps *self,
+	LocationSatellite *satellite,
+	LocationSatelliteDetail *details,
+	guint max_details)
+{
+	LOCATION_LOGD("location_wps_get_satellite_into");
+	return LOCATION_ERROR_NOT_SUPPORTED;
+}
+
+static int
+location_wps_get_history (LocationWps *self,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	guint max,
+	guint *count)
+{
+	LOCATION_LOGD("location_wps_get_history");
+
+	LocationWpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	int ret = history_get_last (priv->history, positions, accuracies, max, count);
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
+static int
+location_wps_get_history_range (LocationWps *self,
+	gint64 from,
+	gint64 to,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	gint64 *times,
+	guint max,
+	guint *count)
+{
+	LOCATION_LOGD("location_wps_get_history_range");
+
+	LocationWpsPrivate *priv = GET_PRIVATE (self);
+	g_return_val_if_fail (priv->mod, LOCATION_ERROR_NOT_AVAILABLE);
+	setting_retval_if_fail(VCONFKEY_LOCATION_NETWORK_ENABLED);
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	int ret = history_get_range (priv->history, from, to, positions, accuracies, times, max, count);
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
+static int
+location_wps_flush_batch (LocationWps *self)
+{
+	LOCATION_LOGD("location_wps_flush_batch");
+	LocationWpsPrivate *priv = GET_PRIVATE (self);
+
+	int ret = LOCATION_ERROR_NOT_AVAILABLE;
+
+	ProviderThread *thread = provider_thread_lock (G_OBJECT (self));
+	if (priv->batch) {
+		batch_flush_signaling (priv->batch);
+		ret = LOCATION_ERROR_NONE;
+	}
+	provider_thread_unlock (thread);
+
+	return ret;
+}
+
 static void
 location_ielement_interface_init (LocationIElementInterface *iface)
 {
@@ -554,6 +844,14 @@ location_ielement_interface_init (LocationIElementInterface *iface)
 	iface->get_last_velocity = (TYPE_GET_VELOCITY)location_wps_get_last_velocity;
 	iface->get_satellite = (TYPE_GET_SATELLITE)location_wps_get_satellite;
 	iface->get_last_satellite = (TYPE_GET_SATELLITE)location_wps_get_last_satellite;
+	iface->get_fix = (TYPE_GET_FIX)location_wps_get_fix;
+	iface->get_position_into = (TYPE_GET_POSITION_INTO)location_wps_get_position_into;
+	iface->get_velocity_into = (TYPE_GET_VELOCITY_INTO)location_wps_get_velocity_into;
+	iface->get_satellite_into = (TYPE_GET_SATELLITE_INTO)location_wps_get_satellite_into;
+	iface->get_history = (TYPE_GET_HISTORY)location_wps_get_history;
+	iface->get_history_range = (TYPE_GET_HISTORY_RANGE)location_wps_get_history_range;
+	iface->flush_batch = (TYPE_FLUSH_BATCH)location_wps_flush_batch;
+	iface->get_latest_fix = (TYPE_GET_LATEST_FIX)location_wps_get_latest_fix;
 }
 
 static void
@@ -569,17 +867,25 @@ location_wps_init (LocationWps *self)
 	priv->set_noti = FALSE;
 	priv->enabled= FALSE;
 
-	priv->pos_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
-	priv->vel_interval = LOCATION_UPDATE_INTERVAL_DEFAULT;
+	priv->pos_interval_ms = LOCATION_UPDATE_INTERVAL_MS_DEFAULT;
+	priv->vel_interval_ms = LOCATION_UPDATE_INTERVAL_MS_DEFAULT;
 
-	priv->pos_updated_timestamp = 0;
-	priv->vel_updated_timestamp = 0;
+	priv->pos_updated_time = 0;
+	priv->vel_updated_time = 0;
 
 	priv->pos = NULL;
 	priv->vel = NULL;
 	priv->acc = NULL;
+	priv->fix = NULL;
+	priv->fix_updated_time = 0;
+	priv->fix_updates = FALSE;
+	priv->history = NULL;
+	priv->batch = NULL;
+	priv->batch_size = 0;
+	priv->batch_latency = LOCATION_BATCH_LATENCY_DEFAULT;
 	priv->zone_status = ZONE_STATUS_NONE;
 	priv->boundary_list = NULL;
+	priv->boundary_index = boundary_index_new();
 
 	priv->pos_timer = 0;
 	priv->vel_timer = 0;
@@ -655,6 +961,32 @@ location_wps_class_init (LocationWpsClass *klass)
 			G_TYPE_POINTER,
 			G_TYPE_POINTER);
 
+	signals[ZONE_CHANGED] = g_signal_new ("zone-changed",
+			G_TYPE_FROM_CLASS (klass),
+			G_SIGNAL_RUN_FIRST |
+			G_SIGNAL_NO_RECURSE,
+			G_STRUCT_OFFSET (LocationWpsClass, zone_changed),
+			NULL, NULL,
+			location_VOID__POINTER_POINTER_POINTER_POINTER,
+			G_TYPE_NONE, 4,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER);
+
+	signals[FENCE_CHANGED] = g_signal_new ("fence-changed",
+			G_TYPE_FROM_CLASS (klass),
+			G_SIGNAL_RUN_FIRST |
+			G_SIGNAL_NO_RECURSE,
+			G_STRUCT_OFFSET (LocationWpsClass, fence_changed),
+			NULL, NULL,
+			location_VOID__POINTER_POINTER_POINTER_POINTER,
+			G_TYPE_NONE, 4,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER,
+			G_TYPE_POINTER);
+
 	properties[PROP_METHOD_TYPE] = g_param_spec_int ("method",
 			"method type",
 			"location method type name",
@@ -685,6 +1017,22 @@ location_wps_class_init (LocationWpsClass *klass)
 			LOCATION_UPDATE_INTERVAL_DEFAULT,
 			G_PARAM_READWRITE);
 
+	properties[PROP_POS_INTERVAL_MS] = g_param_spec_uint ("pos-interval-ms",
+			"wps position interval in milliseconds prop",
+			"wps position interval in milliseconds data",
+			LOCATION_UPDATE_INTERVAL_MS_MIN,
+			LOCATION_UPDATE_INTERVAL_MS_MAX,
+			LOCATION_UPDATE_INTERVAL_MS_DEFAULT,
+			G_PARAM_READWRITE);
+
+	properties[PROP_VEL_INTERVAL_MS] = g_param_spec_uint ("vel-interval-ms",
+			"wps velocity interval in milliseconds prop",
+			"wps velocity interval in milliseconds data",
+			LOCATION_UPDATE_INTERVAL_MS_MIN,
+			LOCATION_UPDATE_INTERVAL_MS_MAX,
+			LOCATION_UPDATE_INTERVAL_MS_DEFAULT,
+			G_PARAM_READWRITE);
+
 	properties[PROP_BOUNDARY] = g_param_spec_pointer ("boundary",
 			"wps boundary prop",
 			"wps boundary data",
@@ -696,6 +1044,70 @@ location_wps_class_init (LocationWpsClass *klass)
 			LOCATION_TYPE_BOUNDARY,
 			G_PARAM_READWRITE);
 
+	properties[PROP_REMOVAL_BOUNDARY_LIST] = g_param_spec_pointer ("removal-boundary-list",
+			"wps removal boundary list prop",
+			"wps removal boundary list data",
+			G_PARAM_WRITABLE);
+
+	properties[PROP_BOUNDARY_STORE] = g_param_spec_pointer ("boundary-store",
+			"wps boundary store prop",
+			"wps memory-mapped boundary store",
+			G_PARAM_WRITABLE);
+
+	properties[PROP_ZONE_CROSSING] = g_param_spec_boolean ("zone-crossing",
+			"wps zone crossing prop",
+			"wps zone check on the path between positions",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_SUBSCRIBE_FENCE_SET] = g_param_spec_uint ("subscribe-fence-set",
+			"wps subscribe fence set prop",
+			"wps handle of the shared fence set to watch",
+			0, G_MAXUINT, 0,
+			G_PARAM_WRITABLE);
+
+	properties[PROP_UNSUBSCRIBE_FENCE_SET] = g_param_spec_uint ("unsubscribe-fence-set",
+			"wps unsubscribe fence set prop",
+			"wps handle of the shared fence set to stop watching",
+			0, G_MAXUINT, 0,
+			G_PARAM_WRITABLE);
+
+	properties[PROP_FIX_UPDATES] = g_param_spec_boolean ("fix-updates",
+			"wps fix updates prop",
+			"wps one fix update per interval instead of position and velocity updates",
+			FALSE,
+			G_PARAM_READWRITE);
+
+	properties[PROP_HISTORY_SIZE] = g_param_spec_uint ("history-size",
+			"wps history size prop",
+			"wps number of the last positions kept, 0 for none",
+			0,
+			LOCATION_HISTORY_SIZE_MAX,
+			0,
+			G_PARAM_READWRITE);
+
+	properties[PROP_BATCH_SIZE] = g_param_spec_uint ("batch-size",
+			"wps batch size prop",
+			"wps number of positions delivered at once by a BATCH_UPDATED update, 0 for none",
+			0,
+			LOCATION_BATCH_SIZE_MAX,
+			0,
+			G_PARAM_READWRITE);
+
+	properties[PROP_BATCH_LATENCY] = g_param_spec_uint ("batch-latency",
+			"wps batch latency prop",
+			"wps maximum seconds a position waits in a batch",
+			1,
+			LOCATION_BATCH_LATENCY_MAX,
+			LOCATION_BATCH_LATENCY_DEFAULT,
+			G_PARAM_READWRITE);
+
+	properties[PROP_PROVIDER_THREAD] = g_param_spec_boolean ("provider-thread",
+			"wps provider thread prop",
+			"wps updates processed on a thread of their own, then delivered to the main context of the caller",
+			FALSE,
+			G_PARAM_READWRITE);
+
 	g_object_class_install_properties (gobject_class,
 			PROP_MAX,
 			properties);
@@ -39,6 +39,7 @@
 #include "map-service.h"
 #include "module-internal.h"
 #include "location-common-util.h"
+#include "location-signaling-util.h"
 
 EXPORT_API
 int location_init (void)
@@ -214,6 +215,133 @@ location_get_last_velocity (LocationObject *obj,
 	return location_ielement_get_last_velocity (LOCATION_IELEMENT(obj), velocity, accuracy);
 }
 
+EXPORT_API int
+location_get_fix (LocationObject *obj, LocationFix **fix)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (fix, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_get_fix (LOCATION_IELEMENT(obj), fix);
+}
+
+EXPORT_API int
+location_get_position_into (LocationObject *obj,
+	LocationPosition *position,
+	LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (position, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_get_position_into (LOCATION_IELEMENT(obj), position, accuracy);
+}
+
+EXPORT_API int
+location_get_velocity_into (LocationObject *obj,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (velocity, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_get_velocity_into (LOCATION_IELEMENT(obj), velocity, accuracy);
+}
+
+EXPORT_API int
+location_get_satellite_into (LocationObject *obj,
+	LocationSatellite *satellite,
+	LocationSatelliteDetail *details,
+	guint max_details)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (satellite, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_get_satellite_into (LOCATION_IELEMENT(obj), satellite, details, max_details);
+}
+
+EXPORT_API int
+location_get_history (LocationObject *obj,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	guint max,
+	guint *count)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (positions || !max, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (count, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_get_history (LOCATION_IELEMENT(obj), positions, accuracies, max, count);
+}
+
+EXPORT_API int
+location_get_history_range (LocationObject *obj,
+	gint64 from,
+	gint64 to,
+	LocationPosition *positions,
+	LocationAccuracy *accuracies,
+	gint64 *times,
+	guint max,
+	guint *count)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (from <= to, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (positions || !max, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (count, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_get_history_range (LOCATION_IELEMENT(obj), from, to, positions, accuracies, times, max, count);
+}
+
+EXPORT_API int
+location_flush_batch (LocationObject *obj)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_flush_batch (LOCATION_IELEMENT(obj));
+}
+
+EXPORT_API int
+location_get_latest_fix (LocationObject *obj,
+	LocationPosition *position,
+	LocationVelocity *velocity,
+	LocationAccuracy *accuracy)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (position || velocity || accuracy, LOCATION_ERROR_PARAMETER);
+
+	return location_ielement_get_latest_fix (LOCATION_IELEMENT(obj), position, velocity, accuracy);
+}
+
+EXPORT_API guint
+location_subscribe (LocationObject *obj,
+	guint mask,
+	LocationUpdateCB callback,
+	gpointer userdata)
+{
+	g_return_val_if_fail (obj, 0);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, 0);
+	g_return_val_if_fail (callback, 0);
+
+	return signaling_subscribe (obj, mask, callback, userdata);
+}
+
+EXPORT_API int
+location_unsubscribe (LocationObject *obj,
+	guint subscription)
+{
+	g_return_val_if_fail (obj, LOCATION_ERROR_PARAMETER);
+	g_return_val_if_fail (G_OBJECT_TYPE(obj) != MAP_TYPE_SERVICE, LOCATION_ERROR_PARAMETER);
+
+	if (!signaling_unsubscribe (obj, subscription)) return LOCATION_ERROR_PARAMETER;
+	return LOCATION_ERROR_NONE;
+}
+
 
 EXPORT_API int
 location_send_command(const char *cmd)
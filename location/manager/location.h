@@ -32,6 +32,10 @@
 #include <location-address.h>
 #include <location-boundary.h>
 #include <location-satellite.h>
+#include <location-fix.h>
+#include <location-batch.h>
+#include <location-point-index.h>
+#include <location-tangent-plane.h>
 
 G_BEGIN_DECLS
 
@@ -69,7 +73,11 @@ int location_init (void);
  * @brief
  * Create a new #LocationObject by using given #LocationMethod.
  * @remarks
- * Returned object is necessary for other APIs.
+ * Returned object is necessary for other APIs.\n
+ * With its "provider-thread" property set to TRUE, a #LOCATION_METHOD_GPS, #LOCATION_METHOD_WPS or #LOCATION_METHOD_CPS object
+ * processes its updates, zones included, on a thread of its own. Signals and callbacks still run on the main context of the thread
+ * which set the property: of the positions, velocities, satellites and fixes not delivered yet, only the latest of each is,
+ * the other signals are all delivered in order. The boundaries given by "zone-changed" are then copies.
  * @pre
  * #location_init should be called before.
  * @post None.
@@ -721,6 +729,424 @@ int main (int argc, char *argv[])
  */
 int location_get_last_velocity (LocationObject *obj, LocationVelocity **velocity, LocationAccuracy **accuracy);
 
+/**
+ * @brief
+ * Get the position, velocity, accuracy and satellite information of the current epoch in a single record.
+ * @remarks Out parameter should be freed. It is shared with the object and read-only, see #location_fix_ref.\n
+ * Only the parts given by the fields of the #LocationFix are set. With the "fix-updates" property set to TRUE,
+ * the object emits one "service-updated" signal of #FIX_UPDATED type per epoch instead of the position, velocity and satellite ones.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [out]
+ * fix - a #LocationFix
+ * @return int
+ * @retval 0                              Success
+ *
+ * Please refer #LocationError for more information.
+ * @see location_get_position
+ * @par Example
+ * @code
+#include <location.h>
+
+static void cb_service_updated (GObject *self, guint type, gpointer data, gpointer accuracy, gpointer userdata)
+{
+	LocationFix *fix = (LocationFix *) data;
+
+	if (type != FIX_UPDATED) return;
+	if (fix->fields & LOCATION_FIX_POSITION)
+		g_debug ("ASYNC>> Fix> time: %d, lat: %f, long: %f", fix->timestamp, fix->position.latitude, fix->position.longitude);
+	if (fix->fields & LOCATION_FIX_VELOCITY)
+		g_debug ("\tspeed: %f, direction: %f", fix->velocity.speed, fix->velocity.direction);
+}
+
+int main (int argc, char *argv[])
+{
+	LocationObject *loc = NULL;
+	LocationFix *fix = NULL;
+
+	location_init ();
+	loc  = location_new (LOCATION_METHOD_GPS);
+	if(!loc){
+		g_debug("location_new failed");
+		return -1;
+	}
+
+	g_object_set (loc, "fix-updates", TRUE, NULL);
+	g_signal_connect (loc, "service-updated", G_CALLBACK(cb_service_updated), loc);
+	location_start (loc);
+	...
+	if (LOCATION_ERROR_NONE == location_get_fix (loc, &fix)) {
+		g_debug ("SYNC>> Current fix> time: %d, satellites in view: %d", fix->timestamp, fix->satellite.num_of_sat_inview);
+		location_fix_free (fix);
+	}
+	...
+}
+ * @endcode
+ */
+int location_get_fix (LocationObject *obj, LocationFix **fix);
+
+/**
+ * @brief
+ * Get current position information with estimate of the accuracy into the storage of the caller.
+ * @remarks Nothing is allocated and no lock is taken, so this suits polling at a high rate from any thread.
+ * The structures are owned by the caller and must not be given to #location_position_free or #location_accuracy_free.\n
+ * accuracy may be NULL. It is set to #LOCATION_ACCURACY_LEVEL_NONE if the object has no accuracy.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [out]
+ * position - a #LocationPosition of the caller
+ * @param [out]
+ * accuracy - a #LocationAccuracy of the caller, or NULL
+ * @return int
+ * @retval 0                              Success
+ *
+ * Please refer #LocationError for more information.
+ * @see location_get_position
+ * @par Example
+ * @code
+#include <location.h>
+
+static gboolean on_frame (gpointer userdata)
+{
+	LocationObject *loc = (LocationObject*)userdata;
+	LocationPosition pos;
+	LocationAccuracy acc;
+
+	if (LOCATION_ERROR_NONE == location_get_position_into (loc, &pos, &acc)) {
+		g_debug ("SYNC>> Current position> time: %d, lat: %f, long: %f, alt: %f, status: %d",
+			pos.timestamp, pos.latitude, pos.longitude, pos.altitude, pos.status);
+	}
+	return TRUE;
+}
+ * @endcode
+ */
+int location_get_position_into (LocationObject *obj, LocationPosition *position, LocationAccuracy *accuracy);
+
+/**
+ * @brief
+ * Get current velocity information with estimate of the accuracy into the storage of the caller.
+ * @remarks Nothing is allocated and no lock is taken, it can be called from any thread.
+ * The structures are owned by the caller and must not be given to #location_velocity_free or #location_accuracy_free.\n
+ * accuracy may be NULL. It is set to #LOCATION_ACCURACY_LEVEL_NONE if the object has no accuracy.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [out]
+ * velocity - a #LocationVelocity of the caller
+ * @param [out]
+ * accuracy - a #LocationAccuracy of the caller, or NULL
+ * @return int
+ * @retval 0                              Success
+ *
+ * Please refer #LocationError for more information.
+ * @see location_get_velocity
+ */
+int location_get_velocity_into (LocationObject *obj, LocationVelocity *velocity, LocationAccuracy *accuracy);
+
+/**
+ * @brief
+ * Get current satellite information into the storage of the caller.
+ * @remarks Nothing is allocated. The sat_inview of satellite is set to details, which receives the satellites in view.
+ * An array of #LOCATION_SATELLITE_MAX_INVIEW details holds the satellites of any usual receiver.
+ * The structures are owned by the caller and must not be given to #location_satellite_free.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [out]
+ * satellite - a #LocationSatellite of the caller
+ * @param [out]
+ * details - an array of max_details #LocationSatelliteDetail of the caller
+ * @param [in]
+ * max_details - the number of elements of details
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_PARAMETER       details is too small, the num_of_sat_inview of satellite is set to the number needed.
+ *
+ * Please refer #LocationError for more information.
+ * @see location_get_satellite
+ */
+int location_get_satellite_into (LocationObject *obj, LocationSatellite *satellite, LocationSatelliteDetail *details, guint max_details);
+
+/**
+ * @brief
+ * Get the last positions received by the object, with their accuracies, into the storage of the caller.
+ * @remarks The object keeps them only if its "history-size" property is set, to the number of positions to keep.
+ * They are copied oldest first, and only positions are recorded, as given by the "service-updated" signals of #POSITION_UPDATED type
+ * whatever the interval of the signals. GPS, WPS and hybrid objects support it.\n
+ * accuracies may be NULL. Otherwise it has max elements as well.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [out]
+ * positions - an array of max #LocationPosition of the caller
+ * @param [out]
+ * accuracies - an array of max #LocationAccuracy of the caller, or NULL
+ * @param [in]
+ * max - the number of positions wanted
+ * @param [out]
+ * count - the number of positions copied, up to max
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_NOT_AVAILABLE   The object keeps no history.
+ *
+ * Please refer #LocationError for more information.
+ * @see location_get_history_range
+ * @par Example
+ * @code
+#include <location.h>
+
+int main (int argc, char *argv[])
+{
+	LocationObject *loc = NULL;
+	LocationPosition trail[60];
+	guint count = 0;
+
+	location_init ();
+	loc  = location_new (LOCATION_METHOD_GPS);
+	if(!loc){
+		g_debug("location_new failed");
+		return -1;
+	}
+
+	g_object_set (loc, "history-size", 3600, NULL);
+	location_start (loc);
+	...
+	if (LOCATION_ERROR_NONE == location_get_history (loc, trail, NULL, 60, &count) && count)
+		g_debug ("SYNC>> %u positions, latest lat: %f, long: %f", count, trail[count - 1].latitude, trail[count - 1].longitude);
+	...
+}
+ * @endcode
+ */
+int location_get_history (LocationObject *obj, LocationPosition *positions, LocationAccuracy *accuracies, guint max, guint *count);
+
+/**
+ * @brief
+ * Get the positions received by the object between two times, with their accuracies and reception times, into the storage of the caller.
+ * @remarks The times are monotonic milliseconds of reception, as g_get_monotonic_time() / 1000, both included.
+ * The first max positions of the range are copied, oldest first. The next ones are read from the last time copied plus one.\n
+ * accuracies and times may be NULL. Otherwise they have max elements as well.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [in]
+ * from - the monotonic time of the first position wanted, in milliseconds
+ * @param [in]
+ * to - the monotonic time of the last position wanted, in milliseconds
+ * @param [out]
+ * positions - an array of max #LocationPosition of the caller
+ * @param [out]
+ * accuracies - an array of max #LocationAccuracy of the caller, or NULL
+ * @param [out]
+ * times - an array of max reception times of the caller, or NULL
+ * @param [in]
+ * max - the number of elements of positions
+ * @param [out]
+ * count - the number of positions copied, up to max
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_NOT_AVAILABLE   The object keeps no history.
+ *
+ * Please refer #LocationError for more information.
+ * @see location_get_history
+ */
+int location_get_history_range (LocationObject *obj, gint64 from, gint64 to, LocationPosition *positions, LocationAccuracy *accuracies, gint64 *times, guint max, guint *count);
+
+/**
+ * @brief
+ * Deliver now the positions batched by the object.
+ * @remarks With the "batch-size" property set, the positions received are kept and delivered together by one "service-updated" signal
+ * of #BATCH_UPDATED type, once batch-size of them are received or when the first one has waited "batch-latency" seconds.
+ * The signals of #POSITION_UPDATED, #VELOCITY_UPDATED, #SATELLITE_UPDATED and #FIX_UPDATED types are not emitted meanwhile.\n
+ * Nothing is delivered if no position is pending.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_NOT_AVAILABLE   The object does not batch positions.
+ *
+ * Please refer #LocationError for more information.
+ * @par Example
+ * @code
+#include <location.h>
+
+static void cb_service_updated (GObject *self, guint type, gpointer data, gpointer accuracy, gpointer userdata)
+{
+	LocationBatch *batch = (LocationBatch *) data;
+	guint i = 0;
+
+	if (type != BATCH_UPDATED) return;
+	for (i = 0; i < batch->count; i++)
+		g_debug ("ASYNC>> Batch> time: %d, lat: %f, long: %f", batch->positions[i].timestamp, batch->positions[i].latitude, batch->positions[i].longitude);
+}
+
+int main (int argc, char *argv[])
+{
+	LocationObject *loc = NULL;
+
+	location_init ();
+	loc  = location_new (LOCATION_METHOD_GPS);
+	if(!loc){
+		g_debug("location_new failed");
+		return -1;
+	}
+
+	g_object_set (loc, "batch-size", 300, "batch-latency", 300, NULL);
+	g_signal_connect (loc, "service-updated", G_CALLBACK(cb_service_updated), loc);
+	location_start (loc);
+	...
+	location_flush_batch (loc);
+	...
+}
+ * @endcode
+ */
+int location_flush_batch (LocationObject *obj);
+
+/**
+ * @brief
+ * Get the latest position, velocity and accuracy of the object together, into the storage of the caller.
+ * @remarks This can be called from any thread: the three are read consistently, without lock nor allocation,
+ * while the object keeps updating them. A reader running during an update copies them again.\n
+ * Any of position, velocity and accuracy may be NULL. The ones not received yet are zeroed, with a timestamp of 0.
+ * The accuracy is the one of the latest position or velocity.
+ * @pre
+ * #location_init should be called before.\n
+ * #location_start should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [out]
+ * position - a #LocationPosition of the caller, or NULL
+ * @param [out]
+ * velocity - a #LocationVelocity of the caller, or NULL
+ * @param [out]
+ * accuracy - a #LocationAccuracy of the caller, or NULL
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_NOT_AVAILABLE   Neither a position nor a velocity was received yet.
+ *
+ * Please refer #LocationError for more information.
+ * @see location_get_position_into
+ * @par Example
+ * @code
+#include <location.h>
+
+static gpointer render_thread (gpointer userdata)
+{
+	LocationObject *loc = (LocationObject*)userdata;
+	LocationPosition pos;
+	LocationVelocity vel;
+	LocationAccuracy acc;
+
+	while (rendering) {
+		if (LOCATION_ERROR_NONE == location_get_latest_fix (loc, &pos, &vel, &acc)) {
+			g_debug ("Latest fix> time: %d, lat: %f, long: %f, speed: %f, horizontal accuracy: %f",
+				pos.timestamp, pos.latitude, pos.longitude, vel.speed, acc.horizontal_accuracy);
+		}
+		...
+	}
+	return NULL;
+}
+ * @endcode
+ */
+int location_get_latest_fix (LocationObject *obj, LocationPosition *position, LocationVelocity *velocity, LocationAccuracy *accuracy);
+
+/**
+ * @brief
+ * Add a callback called directly on each update of the given types, without the marshalling of the "service-updated" signal.
+ * @remarks The callback gets the same data and accuracy as the signal, at the same intervals, and is called before it.
+ * They are owned by the object and valid only during the call.
+ * The "service-updated" signal is not emitted at all while no handler is connected to it.\n
+ * The callback is called from the thread running the main loop of the object. It may unsubscribe itself.
+ * @pre
+ * #location_init should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [in]
+ * mask - the #LocationUpdateMask of the update types wanted
+ * @param [in]
+ * callback - a #LocationUpdateCB
+ * @param [in]
+ * userdata - data given to callback
+ * @return guint
+ * @retval 0                              Error
+ * @retval others                         The subscription, to give to #location_unsubscribe
+ * @see location_unsubscribe
+ * @par Example
+ * @code
+#include <location.h>
+
+static void cb_position (LocationObject *obj, LocationUpdateType type, gconstpointer data, const LocationAccuracy *accuracy, gpointer userdata)
+{
+	const LocationPosition *pos = (const LocationPosition *) data;
+	g_debug ("ASYNC>> Current position> time: %d, lat: %f, long: %f", pos->timestamp, pos->latitude, pos->longitude);
+}
+
+int main (int argc, char *argv[])
+{
+	LocationObject *loc = NULL;
+	guint subscription = 0;
+
+	location_init ();
+	loc  = location_new (LOCATION_METHOD_GPS);
+	if(!loc){
+		g_debug("location_new failed");
+		return -1;
+	}
+
+	subscription = location_subscribe (loc, LOCATION_UPDATE_MASK_POSITION, cb_position, NULL);
+	location_start (loc);
+	...
+	location_unsubscribe (loc, subscription);
+}
+ * @endcode
+ */
+guint location_subscribe (LocationObject *obj, guint mask, LocationUpdateCB callback, gpointer userdata);
+
+/**
+ * @brief
+ * Remove a callback added by #location_subscribe.
+ * @remarks None.
+ * @pre
+ * #location_init should be called before.
+ * @post None.
+ * @param [in]
+ * obj - a #LocationObject created by #location_new
+ * @param [in]
+ * subscription - the subscription returned by #location_subscribe
+ * @return int
+ * @retval 0                              Success
+ * @retval LOCATION_ERROR_PARAMETER       The subscription is not of obj.
+ *
+ * Please refer #LocationError for more information.
+ * @see location_subscribe
+ */
+int location_unsubscribe (LocationObject *obj, guint subscription);
+
 /**
  * @brief
  * Send command to the server.
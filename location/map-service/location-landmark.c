@@ -526,3 +526,20 @@ location_landmark_free (LocationLandmark *landmark)
 
 	g_slice_free (LocationLandmark, landmark);
 }
+
+EXPORT_API LocationPointIndex *
+location_landmark_point_index_new (GList *landmark_list)
+{
+	LocationPointIndex *index = location_point_index_new (NULL);
+	LocationLandmark *landmark = NULL;
+	GList *cur = NULL;
+	guint point_id = 0;
+
+	for (cur = landmark_list; cur; cur = g_list_next (cur)) {
+		landmark = (LocationLandmark *) cur->data;
+		if (landmark == NULL || landmark->position == NULL) continue;
+		location_point_index_insert (index, landmark->position, landmark, &point_id);
+	}
+
+	return index;
+}
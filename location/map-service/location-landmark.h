@@ -23,6 +23,7 @@
 #define __LOCATION_LANDMARK_H__
 
 #include <location-map-types.h>
+#include <location-point-index.h>
 
 G_BEGIN_DECLS
 
@@ -114,6 +115,11 @@ GList *location_landmark_get_property_key (const LocationLandmark *landmark);
  */
 gconstpointer location_landmark_get_property (const LocationLandmark *landmark, gconstpointer key);
 
+/**
+ * @brief Create a #LocationPointIndex of the positions of the given landmarks, with each landmark as the data of its point
+ */
+LocationPointIndex *location_landmark_point_index_new (GList *landmark_list);
+
 /**
  * @brief Create a new #LocationLandmarkUrl
  */
@@ -0,0 +1,271 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks that boundary_store_open() maps a written store and refuses damaged or truncated ones */
+
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <location.h>
+#include "location-boundary-store.h"
+
+/* Mirrors the leading part of the file layout in location-boundary-store.c */
+typedef struct {
+	gchar magic[8];
+	guint32 version;
+	guint32 byte_order;
+	guint32 fence_count;
+	guint32 vertex_count;
+	guint32 cell_count;
+	guint32 cell_ref_count;
+	guint32 wide_count;
+	guint32 reserved;
+	gdouble cell_size;
+	guint64 fence_offset;
+	guint64 vertex_offset;
+	guint64 cell_offset;
+	guint64 cell_ref_offset;
+	guint64 wide_offset;
+	guint64 file_size;
+} TestHeader;
+
+typedef struct {
+	guint32 type;
+	guint32 vertex_count;
+	guint32 vertex_first;
+	guint32 reserved;
+	gdouble bounds[7];
+} TestFence;
+
+typedef struct {
+	guint32 key;
+	guint32 first;
+	guint32 count;
+} TestCell;
+
+typedef void (*CorruptFunc) (gchar *contents, gsize *length);
+
+static gchar *store_path = NULL;
+static gchar *damaged_path = NULL;
+static gchar *valid_contents = NULL;
+static gsize valid_length = 0;
+
+static TestHeader *
+_header (gchar *contents)
+{
+	return (TestHeader *) contents;
+}
+
+static TestFence *
+_polygon_fence (gchar *contents)
+{
+	TestHeader *header = _header (contents);
+	TestFence *fence = (TestFence *) (contents + header->fence_offset);
+	guint i;
+
+	for (i = 0; i < header->fence_count; i++) {
+		if (fence[i].type == LOCATION_BOUNDARY_POLYGON) return &fence[i];
+	}
+	return NULL;
+}
+
+static void _bad_magic (gchar *contents, gsize *length) { _header (contents)->magic[0] ^= 0x20; }
+static void _bad_version (gchar *contents, gsize *length) { _header (contents)->version++; }
+static void _bad_byte_order (gchar *contents, gsize *length) { _header (contents)->byte_order = GUINT32_SWAP_LE_BE (_header (contents)->byte_order); }
+static void _bad_cell_size (gchar *contents, gsize *length) { _header (contents)->cell_size *= 2; }
+static void _bad_file_size (gchar *contents, gsize *length) { _header (contents)->file_size += sizeof (guint32); }
+static void _short_header (gchar *contents, gsize *length) { *length = sizeof (TestHeader) - 1; }
+static void _truncated (gchar *contents, gsize *length) { *length -= sizeof (guint32); _header (contents)->file_size = *length; }
+static void _bad_fence_count (gchar *contents, gsize *length) { _header (contents)->fence_count = G_MAXUINT32; }
+static void _bad_vertex_count (gchar *contents, gsize *length) { _header (contents)->vertex_count += 1000; }
+static void _misaligned_vertices (gchar *contents, gsize *length) { _header (contents)->vertex_offset += sizeof (guint32); }
+static void _bad_cell_offset (gchar *contents, gsize *length) { _header (contents)->cell_offset = G_MAXUINT64 - 3; }
+static void _bad_vertex_first (gchar *contents, gsize *length) { _polygon_fence (contents)->vertex_first = _header (contents)->vertex_count; }
+static void _bad_polygon_count (gchar *contents, gsize *length) { _polygon_fence (contents)->vertex_count = 2; }
+static void _bad_polygon_overflow (gchar *contents, gsize *length) { _polygon_fence (contents)->vertex_first = 1; _polygon_fence (contents)->vertex_count = G_MAXUINT32; }
+
+static void
+_bad_cell_range (gchar *contents, gsize *length)
+{
+	TestHeader *header = _header (contents);
+	TestCell *cell = (TestCell *) (contents + header->cell_offset);
+	cell[header->cell_count - 1].count = header->cell_ref_count + 1;
+}
+
+static void
+_bad_cell_first (gchar *contents, gsize *length)
+{
+	TestHeader *header = _header (contents);
+	TestCell *cell = (TestCell *) (contents + header->cell_offset);
+	cell[0].first = G_MAXUINT32;
+}
+
+static void
+_bad_cell_ref (gchar *contents, gsize *length)
+{
+	TestHeader *header = _header (contents);
+	guint32 *ref = (guint32 *) (contents + header->cell_ref_offset);
+	ref[0] = header->fence_count;
+}
+
+static void
+_bad_wide_ref (gchar *contents, gsize *length)
+{
+	TestHeader *header = _header (contents);
+	guint32 *ref = (guint32 *) (contents + header->wide_offset);
+	ref[0] = header->fence_count;
+}
+
+static const struct {
+	const gchar *name;
+	CorruptFunc corrupt;
+} damages[] = {
+	{ "magic", _bad_magic },
+	{ "version", _bad_version },
+	{ "byte order", _bad_byte_order },
+	{ "cell size", _bad_cell_size },
+	{ "file size", _bad_file_size },
+	{ "short header", _short_header },
+	{ "truncated", _truncated },
+	{ "fence count", _bad_fence_count },
+	{ "vertex count", _bad_vertex_count },
+	{ "misaligned vertices", _misaligned_vertices },
+	{ "cell offset", _bad_cell_offset },
+	{ "polygon first vertex", _bad_vertex_first },
+	{ "polygon vertex count", _bad_polygon_count },
+	{ "polygon vertex overflow", _bad_polygon_overflow },
+	{ "cell range", _bad_cell_range },
+	{ "cell first", _bad_cell_first },
+	{ "cell fence id", _bad_cell_ref },
+	{ "wide fence id", _bad_wide_ref },
+};
+
+static GList *
+_make_boundaries (void)
+{
+	GList *boundary_list = NULL;
+	GList *position_list = NULL;
+	LocationPosition *center = location_position_new (0, 37.258, 127.056, 0, LOCATION_STATUS_2D_FIX);
+	LocationPosition *left_top = location_position_new (0, 37.30, 126.90, 0, LOCATION_STATUS_2D_FIX);
+	LocationPosition *right_bottom = location_position_new (0, 37.20, 127.10, 0, LOCATION_STATUS_2D_FIX);
+	LocationPosition *wide_left_top = location_position_new (0, 60.0, 100.0, 0, LOCATION_STATUS_2D_FIX);
+	LocationPosition *wide_right_bottom = location_position_new (0, 10.0, 150.0, 0, LOCATION_STATUS_2D_FIX);
+
+	boundary_list = g_list_append (boundary_list, location_boundary_new_for_circle (center, 1000.0));
+	boundary_list = g_list_append (boundary_list, location_boundary_new_for_rect (left_top, right_bottom));
+	boundary_list = g_list_append (boundary_list, location_boundary_new_for_rect (wide_left_top, wide_right_bottom));
+
+	position_list = g_list_append (position_list, location_position_new (0, 37.30, 127.00, 0, LOCATION_STATUS_2D_FIX));
+	position_list = g_list_append (position_list, location_position_new (0, 37.25, 127.10, 0, LOCATION_STATUS_2D_FIX));
+	position_list = g_list_append (position_list, location_position_new (0, 37.20, 127.00, 0, LOCATION_STATUS_2D_FIX));
+	position_list = g_list_append (position_list, location_position_new (0, 37.25, 126.95, 0, LOCATION_STATUS_2D_FIX));
+	boundary_list = g_list_append (boundary_list, location_boundary_new_for_polygon (position_list));
+
+	location_position_free (center);
+	location_position_free (left_top);
+	location_position_free (right_bottom);
+	location_position_free (wide_left_top);
+	location_position_free (wide_right_bottom);
+	g_list_free_full (position_list, (GDestroyNotify) location_position_free);
+	return boundary_list;
+}
+
+static int
+_check_valid (void)
+{
+	LocationBoundaryStore *store = boundary_store_open (store_path);
+	LocationPosition *inside = location_position_new (0, 37.258, 127.056, 0, LOCATION_STATUS_2D_FIX);
+	GArray *entered = NULL, *left = NULL;
+	int failed = 0;
+
+	if (!store) {
+		g_printerr ("valid store: not opened\n");
+		location_position_free (inside);
+		return 1;
+	}
+	if (boundary_store_size (store) != 4) {
+		g_printerr ("valid store: %u fences, expected 4\n", boundary_store_size (store));
+		failed++;
+	}
+	if (!boundary_store_update_zone (store, inside, &entered, &left) || entered->len < 3 || left->len) {
+		g_printerr ("valid store: position is not in its fences\n");
+		failed++;
+	}
+	boundary_store_close (store);
+	location_position_free (inside);
+	return failed;
+}
+
+static int
+_check_damaged (guint i)
+{
+	gchar *contents = g_memdup (valid_contents, valid_length);
+	gsize length = valid_length;
+	LocationBoundaryStore *store = NULL;
+	int failed = 0;
+
+	damages[i].corrupt (contents, &length);
+	g_file_set_contents (damaged_path, contents, length, NULL);
+	store = boundary_store_open (damaged_path);
+	if (store) {
+		g_printerr ("%s: damaged store was opened\n", damages[i].name);
+		boundary_store_close (store);
+		failed++;
+	}
+	g_free (contents);
+	return failed;
+}
+
+int
+main (int argc, char *argv[])
+{
+	GList *boundary_list = NULL;
+	int failed = 0;
+	guint i;
+
+	store_path = g_build_filename (g_get_tmp_dir (), "boundary-store-test.bin", NULL);
+	damaged_path = g_build_filename (g_get_tmp_dir (), "boundary-store-test-damaged.bin", NULL);
+
+	boundary_list = _make_boundaries ();
+	if (boundary_store_write (store_path, boundary_list) != LOCATION_ERROR_NONE ||
+		!g_file_get_contents (store_path, &valid_contents, &valid_length, NULL)) {
+		g_printerr ("boundary store: fail to write [%s]\n", store_path);
+		return 1;
+	}
+
+	failed += _check_valid ();
+	if (_header (valid_contents)->wide_count == 0) {
+		g_printerr ("boundary store: no wide fence in the test set\n");
+		failed++;
+	}
+	for (i = 0; i < G_N_ELEMENTS (damages); i++)
+		failed += _check_damaged (i);
+
+	g_unlink (store_path);
+	g_unlink (damaged_path);
+	g_free (valid_contents);
+	g_free (store_path);
+	g_free (damaged_path);
+	g_list_free_full (boundary_list, (GDestroyNotify) location_boundary_free);
+
+	g_print ("boundary store: %s (%d failures)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}
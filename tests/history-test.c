@@ -0,0 +1,203 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the range and last position queries of the history ring buffer against a linear scan of what it was fed */
+
+#include <string.h>
+#include <glib.h>
+#include <location.h>
+#include "location-history.h"
+
+#define ROUND_COUNT	200
+#define APPEND_COUNT	400
+#define QUERY_COUNT	50
+
+typedef struct {
+	guint sequence;
+	gint64 time;
+} Entry;
+
+static GArray *expected = NULL;		/* Entry kept by the history, oldest first */
+static LocationPosition *positions = NULL;
+static LocationAccuracy *accuracies = NULL;
+static gint64 *times = NULL;
+
+/* The latest size entries the reference accepted */
+static void
+_reference_trim (guint size)
+{
+	if (expected->len > size) g_array_remove_range (expected, 0, expected->len - size);
+}
+
+static void
+_append (LocationHistory *history, guint sequence, gint64 time, gboolean with_timestamp)
+{
+	LocationPosition position = { with_timestamp ? 1000 + sequence : 0, sequence, -(gdouble) sequence, 0, LOCATION_STATUS_2D_FIX };
+	LocationAccuracy accuracy = { LOCATION_ACCURACY_LEVEL_DETAILED, sequence % 7, 0 };
+	Entry entry = { sequence, time };
+
+	history_append (history, &position, sequence % 5 ? &accuracy : NULL, time);
+	if (!with_timestamp) return;
+	if (expected->len && time < g_array_index (expected, Entry, expected->len - 1).time) return;
+	g_array_append_val (expected, entry);
+	_reference_trim (history_get_size (history));
+}
+
+static gboolean
+_check_entry (const gchar *query, guint i, const Entry *entry, gboolean with_time)
+{
+	guint sequence = (guint) positions[i].latitude;
+	gboolean with_accuracy = entry->sequence % 5;
+
+	if (sequence != entry->sequence || positions[i].longitude != -(gdouble) entry->sequence ||
+		(with_time && times[i] != entry->time) ||
+		accuracies[i].level != (with_accuracy ? LOCATION_ACCURACY_LEVEL_DETAILED : LOCATION_ACCURACY_LEVEL_NONE) ||
+		accuracies[i].horizontal_accuracy != (with_accuracy ? entry->sequence % 7 : 0)) {
+		g_printerr ("%s: position %u is %u, expected %u\n", query, i, sequence, entry->sequence);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static int
+_check_range (LocationHistory *history, gint64 from, gint64 to, guint max)
+{
+	guint first = 0, last = 0, count = 0, i;
+
+	while (first < expected->len && g_array_index (expected, Entry, first).time < from) first++;
+	for (last = first; last < expected->len && g_array_index (expected, Entry, last).time <= to; last++);
+
+	if (history_get_range (history, from, to, positions, accuracies, times, max, &count) != LOCATION_ERROR_NONE ||
+		count != MIN(max, last - first)) {
+		g_printerr ("range [%lld, %lld] max %u: %u positions, expected %u\n",
+			(long long) from, (long long) to, max, count, MIN(max, last - first));
+		return 1;
+	}
+	for (i = 0; i < count; i++) {
+		if (!_check_entry ("range", i, &g_array_index (expected, Entry, first + i), TRUE)) return 1;
+	}
+	return 0;
+}
+
+static int
+_check_last (LocationHistory *history, guint max)
+{
+	guint count = 0, i;
+	guint first = expected->len - MIN(max, expected->len);
+
+	if (history_get_last (history, positions, accuracies, max, &count) != LOCATION_ERROR_NONE ||
+		count != expected->len - first) {
+		g_printerr ("last %u: %u positions, expected %u\n", max, count, expected->len - first);
+		return 1;
+	}
+	for (i = 0; i < count; i++) {
+		if (!_check_entry ("last", i, &g_array_index (expected, Entry, first + i), FALSE)) return 1;
+	}
+	return 0;
+}
+
+/* Reads the whole history a page at a time, each page starting after the time of the previous one */
+static int
+_check_paging (LocationHistory *history, guint page)
+{
+	gint64 from = G_MININT64;
+	guint read = 0, count = 0, i;
+
+	do {
+		if (history_get_range (history, from, G_MAXINT64, positions, accuracies, times, page, &count) != LOCATION_ERROR_NONE) return 1;
+		for (i = 0; i < count; i++, read++) {
+			if (read >= expected->len || !_check_entry ("page", i, &g_array_index (expected, Entry, read), TRUE)) return 1;
+		}
+		if (count) from = times[count - 1] + 1;
+	} while (count == page);
+
+	if (read != expected->len) {
+		g_printerr ("paging by %u: %u positions, expected %u\n", page, read, expected->len);
+		return 1;
+	}
+	return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+	LocationHistory *history = NULL;
+	guint count = 0;
+	int failed = 0;
+	guint round, i;
+
+	g_random_set_seed (2011);
+	expected = g_array_new (FALSE, FALSE, sizeof (Entry));
+	positions = g_new0 (LocationPosition, LOCATION_HISTORY_SIZE_MAX);
+	accuracies = g_new0 (LocationAccuracy, LOCATION_HISTORY_SIZE_MAX);
+	times = g_new0 (gint64, LOCATION_HISTORY_SIZE_MAX);
+
+	if (history_get_range (history, 0, 10, positions, NULL, NULL, 10, &count) != LOCATION_ERROR_NOT_AVAILABLE || count) {
+		g_printerr ("range without history is available\n");
+		failed++;
+	}
+
+	for (round = 0; round < ROUND_COUNT; round++) {
+		/* Odd rounds keep distinct times so paging by the last time plus one sees every position */
+		gboolean distinct = round % 2;
+		gint64 time = g_random_int_range (0, 100000);
+
+		history_set_size (&history, 0);
+		history_set_size (&history, g_random_int_range (1, 64));
+		g_array_set_size (expected, 0);
+
+		for (i = 0; i < APPEND_COUNT; i++) {
+			gint32 step = distinct ? g_random_int_range (1, 50) : g_random_int_range (-20, 50);
+			/* A resize in the middle keeps the latest positions */
+			if (i == APPEND_COUNT / 2) {
+				history_set_size (&history, g_random_int_range (1, 64));
+				_reference_trim (history_get_size (history));
+			}
+			if (step < 0 && !expected->len) step = 0;
+			_append (history, i, time + step, g_random_int_range (0, 20) != 0);
+			if (step >= 0) time += step;
+		}
+
+		for (i = 0; i < QUERY_COUNT; i++) {
+			gint64 from = time - g_random_int_range (0, 3000);
+			gint64 to = from + g_random_int_range (0, 2000);
+			failed += _check_range (history, from, to, g_random_int_range (0, 80));
+		}
+		failed += _check_range (history, G_MININT64, G_MAXINT64, LOCATION_HISTORY_SIZE_MAX);
+		failed += _check_range (history, time + 1, G_MAXINT64, LOCATION_HISTORY_SIZE_MAX);
+		failed += _check_last (history, g_random_int_range (0, 80));
+		if (distinct) failed += _check_paging (history, g_random_int_range (1, 10));
+	}
+
+	history_set_size (&history, 0);
+	if (history) {
+		g_printerr ("history is kept at size 0\n");
+		failed++;
+	}
+
+	g_array_free (expected, TRUE);
+	g_free (positions);
+	g_free (accuracies);
+	g_free (times);
+
+	g_print ("history: %s (%d failures)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}
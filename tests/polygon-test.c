@@ -0,0 +1,133 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the polygon edge table, lowered to AVX, SSE2 or NEON when available, against the list walk it replaced */
+
+#include <math.h>
+#include <glib.h>
+#include <location.h>
+#include "location-polygon.h"
+
+#define POLYGON_COUNT	500
+#define QUERY_COUNT	200
+
+/* Crossing number of the position as the original LocationBoundary list walk counted it */
+static guint
+reference_crossing (GList *position_list, gdouble latitude, gdouble longitude)
+{
+	GList *pos1_list = g_list_first (position_list);
+	GList *pos2_list = g_list_last (position_list);
+	guint crossing = 0;
+
+	while (pos1_list) {
+		LocationPosition *pos1 = pos1_list->data;
+		LocationPosition *pos2 = pos2_list->data;
+		gdouble interval_y = pos1->longitude - pos2->longitude;
+		gdouble interval_x = pos1->latitude - pos2->latitude;
+		gboolean edge_area = FALSE;
+		gdouble x0, y0;
+
+		if (interval_y > 180) {
+			interval_y = interval_y - 360;
+			edge_area = TRUE;
+		} else if (interval_y < -180) {
+			interval_y = interval_y + 360;
+			edge_area = TRUE;
+		}
+
+		if (edge_area && (pos1->longitude > longitude) == (pos2->longitude > longitude)) {
+			if (pos2->longitude * longitude > 0) {
+				x0 = pos2->latitude;
+				y0 = pos2->longitude;
+			} else {
+				x0 = pos1->latitude;
+				y0 = pos1->longitude;
+			}
+			if (latitude < ((interval_x / interval_y) * (longitude - y0) + x0)) crossing++;
+		} else if (!edge_area && (pos1->longitude > longitude) != (pos2->longitude > longitude)) {
+			x0 = pos2->latitude;
+			y0 = pos2->longitude;
+			if (latitude < ((interval_x / interval_y) * (longitude - y0) + x0)) crossing++;
+		}
+
+		pos2_list = pos1_list;
+		pos1_list = g_list_next (pos1_list);
+	}
+	return crossing;
+}
+
+static gdouble
+wrap_longitude (gdouble longitude)
+{
+	if (longitude > 180) return longitude - 360;
+	if (longitude < -180) return longitude + 360;
+	return longitude;
+}
+
+int
+main (int argc, char *argv[])
+{
+	int failed = 0;
+	guint p, q, i;
+
+	g_random_set_seed (2011);
+
+	for (p = 0; p < POLYGON_COUNT; p++) {
+		/* Star shaped around a center, a few of them across the 180th meridian */
+		guint count = g_random_int_range (3, 40);
+		gdouble center_latitude = g_random_double_range (-60, 60);
+		gdouble center_longitude = (p % 10 == 0) ? 179.5 : g_random_double_range (-179, 179);
+		gdouble *vertices = g_new (gdouble, count * 2);
+		GList *position_list = NULL;
+		LocationPolygonEdges *edges = NULL;
+
+		for (i = 0; i < count; i++) {
+			gdouble angle = 2 * G_PI * i / count;
+			gdouble radius = g_random_double_range (0.1, 1.0);
+			vertices[i * 2] = center_latitude + radius * sin (angle);
+			vertices[i * 2 + 1] = wrap_longitude (center_longitude + radius * cos (angle));
+			position_list = g_list_append (position_list,
+				location_position_new (0, vertices[i * 2], vertices[i * 2 + 1], 0, LOCATION_STATUS_2D_FIX));
+		}
+		edges = polygon_edges_new (position_list);
+
+		for (q = 0; q < QUERY_COUNT; q++) {
+			gdouble latitude = center_latitude + g_random_double_range (-1.2, 1.2);
+			gdouble longitude = wrap_longitude (center_longitude + g_random_double_range (-1.2, 1.2));
+			guint expected = reference_crossing (position_list, latitude, longitude);
+			guint table = polygon_edges_count_crossing (edges, latitude, longitude);
+			guint packed = polygon_vertices_count_crossing (vertices, count, latitude, longitude);
+
+			if (table != expected || packed != expected) {
+				g_printerr ("polygon %u (%u vertices) at (%f, %f): expected %u, table %u, packed %u\n",
+					p, count, latitude, longitude, expected, table, packed);
+				failed++;
+			}
+		}
+
+		polygon_edges_free (edges);
+		g_list_free_full (position_list, (GDestroyNotify) location_position_free);
+		g_free (vertices);
+	}
+
+	g_print ("polygon kernels: %s (%d mismatches)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}
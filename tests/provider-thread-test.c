@@ -0,0 +1,227 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the mailbox of the provider thread: the slot updates are coalesced to the latest one,
+ * the other messages are all delivered, and both reach the main loop in the order they were posted */
+
+#include <glib.h>
+#include <glib-object.h>
+#include "location-provider-thread.h"
+
+#define BURST_COUNT	1000
+#define STREAM_COUNT	2000
+#define ZONE_EVERY	7		/* a plain message every that many updates */
+#define TIMEOUT_MS	10000
+
+typedef enum {
+	TEST_UPDATE,
+	TEST_ZONE,
+} TestKind;
+
+typedef struct {
+	ProviderMessage message;
+	TestKind kind;
+	guint value;
+} TestMessage;
+
+static GMainLoop *loop = NULL;
+static volatile gint produced = 0;
+static volatile gint freed = 0;
+static guint expected_last = 0;
+static gint last_sequence = 0;
+static gboolean delivered_any = FALSE;
+static guint update_count = 0;
+static guint update_last = 0;
+static guint zone_count = 0;
+static guint zone_next = 0;
+static int failed = 0;
+
+static void
+_message_free (gpointer data)
+{
+	g_atomic_int_inc (&freed);
+	g_slice_free (TestMessage, data);
+}
+
+static void
+_deliver (LocationObject *obj, ProviderMessage *message)
+{
+	TestMessage *test = (TestMessage *) message;
+
+	if (delivered_any && message->sequence - last_sequence <= 0) {
+		g_printerr ("message %d delivered after %d\n", message->sequence, last_sequence);
+		failed++;
+	}
+	delivered_any = TRUE;
+	last_sequence = message->sequence;
+
+	if (test->kind == TEST_UPDATE) {
+		if (update_count && test->value <= update_last) {
+			g_printerr ("update %u delivered after %u\n", test->value, update_last);
+			failed++;
+		}
+		update_count++;
+		update_last = test->value;
+	} else {
+		if (test->value != zone_next) {
+			g_printerr ("zone message %u delivered, expected %u\n", test->value, zone_next);
+			failed++;
+		}
+		zone_count++;
+		zone_next = test->value + ZONE_EVERY;
+	}
+	if (update_last == expected_last && zone_next > expected_last) g_main_loop_quit (loop);
+}
+
+static ProviderMessage *
+_message_new (TestKind kind, guint value)
+{
+	TestMessage *test = g_slice_new0 (TestMessage);
+	test->message.deliver = _deliver;
+	test->message.free = _message_free;
+	test->kind = kind;
+	test->value = value;
+	return &test->message;
+}
+
+static void
+_produce (LocationObject *obj, guint count, gboolean pace)
+{
+	guint i;
+
+	for (i = 0; i < count; i++) {
+		provider_thread_post_latest (obj, PROVIDER_SLOT_POSITION, _message_new (TEST_UPDATE, i));
+		if (i % ZONE_EVERY == 0) provider_thread_post (obj, _message_new (TEST_ZONE, i));
+		if (pace && i % 50 == 0) g_usleep (1000);
+	}
+	g_atomic_int_set (&produced, TRUE);
+}
+
+/* Called on the provider thread */
+static gboolean
+_burst_cb (gpointer data)
+{
+	_produce (data, BURST_COUNT, FALSE);
+	return FALSE;
+}
+
+static gboolean
+_stream_cb (gpointer data)
+{
+	_produce (data, STREAM_COUNT, TRUE);
+	return FALSE;
+}
+
+static gboolean
+_timeout_cb (gpointer data)
+{
+	g_printerr ("%s: timed out\n", (const gchar *) data);
+	failed++;
+	g_main_loop_quit (loop);
+	return FALSE;
+}
+
+static void
+_reset (guint count)
+{
+	expected_last = count - 1;
+	delivered_any = FALSE;
+	update_count = update_last = 0;
+	zone_count = zone_next = 0;
+	g_atomic_int_set (&produced, FALSE);
+}
+
+static void
+_run (const gchar *name)
+{
+	guint timeout = g_timeout_add (TIMEOUT_MS, _timeout_cb, (gpointer) name);
+	g_main_loop_run (loop);
+	g_source_remove (timeout);
+}
+
+static void
+_check_zones (const gchar *name, guint count)
+{
+	guint expected = (count + ZONE_EVERY - 1) / ZONE_EVERY;
+	if (zone_count != expected) {
+		g_printerr ("%s: %u zone messages, expected %u\n", name, zone_count, expected);
+		failed++;
+	}
+}
+
+int
+main (int argc, char *argv[])
+{
+	LocationObject *obj = NULL;
+	ProviderThread *thread = NULL;
+	gint posted = 0;
+
+	g_type_init ();
+	loop = g_main_loop_new (NULL, FALSE);
+	obj = g_object_new (G_TYPE_OBJECT, NULL);
+
+	/* Without thread, nothing is posted and the message is freed */
+	provider_thread_post (obj, _message_new (TEST_ZONE, 0));
+	provider_thread_post_latest (obj, PROVIDER_SLOT_POSITION, _message_new (TEST_UPDATE, 0));
+	if (provider_thread_posting (obj) || g_atomic_int_get (&freed) != 2) {
+		g_printerr ("messages kept without thread\n");
+		failed++;
+	}
+
+	thread = provider_thread_new (obj);
+	if (!thread || !provider_thread_posting (obj)) {
+		g_printerr ("no provider thread\n");
+		return 1;
+	}
+
+	/* A burst posted before the loop runs again reaches it as the latest update and every zone message */
+	_reset (BURST_COUNT);
+	provider_thread_defer_source (obj, _burst_cb);
+	while (!g_atomic_int_get (&produced)) g_usleep (1000);
+	_run ("burst");
+	if (update_count != 1) {
+		g_printerr ("burst: %u updates delivered, expected only the latest\n", update_count);
+		failed++;
+	}
+	_check_zones ("burst", BURST_COUNT);
+
+	/* Posted while the loop delivers, the updates are thinned out but the last one and the order are kept */
+	_reset (STREAM_COUNT);
+	provider_thread_defer_source (obj, _stream_cb);
+	_run ("stream");
+	_check_zones ("stream", STREAM_COUNT);
+
+	/* What is still pending when the thread goes is dropped */
+	posted = g_atomic_int_get (&freed);
+	provider_thread_post (obj, _message_new (TEST_ZONE, 0));
+	provider_thread_post_latest (obj, PROVIDER_SLOT_POSITION, _message_new (TEST_UPDATE, 0));
+	provider_thread_free (thread);
+	if (g_atomic_int_get (&freed) != posted + 2 || provider_thread_posting (obj)) {
+		g_printerr ("messages pending at free are not dropped\n");
+		failed++;
+	}
+
+	g_object_unref (obj);
+	g_main_loop_unref (loop);
+
+	g_print ("provider thread mailbox: %s (%d failures)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}
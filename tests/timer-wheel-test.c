@@ -0,0 +1,184 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Runs timers of the shared wheel on the main loop: first call, period, removal and reprogramming from the callbacks */
+
+#include <glib.h>
+#include "location-timer-wheel.h"
+
+#define RUN_MS		3000
+#define SLACK_MS	150	/* main loop latency allowed on a loaded machine */
+
+typedef struct {
+	const gchar *name;
+	guint interval_ms;
+	guint id;
+	guint count;
+	guint stop_after;		/* returns FALSE on that call, 0 never */
+	gint64 added;
+	gint64 first;
+	gint64 second;
+	gint64 last;
+	gint64 min_gap;		/* from the third call, the second period may be shorter */
+} TestTimer;
+
+static GMainLoop *loop = NULL;
+static TestTimer steady = { "steady", 200 };
+static TestTimer self_stop = { "self stop", 300, 0, 0, 3 };
+static TestTimer self_remove = { "self remove", 400 };
+static TestTimer victim = { "victim", 100 };
+static TestTimer remover = { "remover", 500 };
+static TestTimer reprogram = { "reprogram", 1000 };
+static gint64 victim_removed = 0;
+static gint64 reprogrammed = 0;
+static guint victim_count = 0;
+
+static gint64
+_now (void)
+{
+	return g_get_monotonic_time () / 1000;
+}
+
+static void
+_record (TestTimer *timer)
+{
+	gint64 now = _now ();
+
+	if (!timer->count) timer->first = now;
+	else if (timer->count == 1) timer->second = now;
+	else if (!timer->min_gap || now - timer->last < timer->min_gap) timer->min_gap = now - timer->last;
+	timer->last = now;
+	timer->count++;
+}
+
+static gboolean
+_timer_cb (gpointer data)
+{
+	TestTimer *timer = data;
+
+	_record (timer);
+	if (timer == &self_remove) timer_wheel_remove (self_remove.id);
+	if (timer == &remover && timer->count == 1) {
+		victim_count = victim.count;
+		victim_removed = _now ();
+		timer_wheel_remove (victim.id);
+	}
+	if (timer == &reprogram && timer->count == 1) {
+		reprogrammed = _now ();
+		timer_wheel_set_interval (reprogram.id, 250);
+	}
+	return !(timer->stop_after && timer->count == timer->stop_after);
+}
+
+static gboolean
+_quit_cb (gpointer data)
+{
+	g_main_loop_quit (loop);
+	return FALSE;
+}
+
+static void
+_add (TestTimer *timer)
+{
+	timer->added = _now ();
+	timer->id = timer_wheel_add (timer->interval_ms, _timer_cb, timer);
+}
+
+static int
+_check_first (const TestTimer *timer)
+{
+	if (!timer->count || timer->first < timer->added + timer->interval_ms ||
+		timer->first > timer->added + timer->interval_ms + TIMER_WHEEL_TICK_MS + SLACK_MS) {
+		g_printerr ("%s: first call %lld ms after it was added, period %u ms\n",
+			timer->name, (long long) (timer->first - timer->added), timer->interval_ms);
+		return 1;
+	}
+	return 0;
+}
+
+static int
+_check_count (const TestTimer *timer, guint min, guint max)
+{
+	if (timer->count < min || timer->count > max) {
+		g_printerr ("%s: %u calls, expected %u to %u\n", timer->name, timer->count, min, max);
+		return 1;
+	}
+	return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+	int failed = 0;
+
+	loop = g_main_loop_new (NULL, FALSE);
+
+	_add (&steady);
+	_add (&self_stop);
+	_add (&self_remove);
+	_add (&victim);
+	_add (&remover);
+	_add (&reprogram);
+	g_timeout_add (RUN_MS, _quit_cb, NULL);
+	g_main_loop_run (loop);
+
+	/* First call a whole period out, then on the multiples of the period */
+	failed += _check_first (&steady) + _check_first (&self_stop) + _check_first (&self_remove) + _check_first (&victim);
+	failed += _check_first (&remover) + _check_first (&reprogram);
+	failed += _check_count (&steady, RUN_MS / steady.interval_ms - 2, RUN_MS / steady.interval_ms);
+	if (steady.min_gap < steady.interval_ms - TIMER_WHEEL_TICK_MS) {
+		g_printerr ("steady: calls %lld ms apart, period %u ms\n", (long long) steady.min_gap, steady.interval_ms);
+		failed++;
+	}
+
+	/* Returning FALSE or removing itself ends the timer */
+	failed += _check_count (&self_stop, self_stop.stop_after, self_stop.stop_after);
+	failed += _check_count (&self_remove, 1, 1);
+	if (timer_wheel_remove (self_stop.id)) {
+		g_printerr ("self stop: still in the wheel\n");
+		failed++;
+	}
+
+	/* Removed from another callback, it is not called again */
+	if (victim.count != victim_count || victim.last > victim_removed) {
+		g_printerr ("victim: called %u times after its removal\n", victim.count - victim_count);
+		failed++;
+	}
+
+	/* A new period starts a whole period after the change */
+	failed += _check_count (&reprogram, (RUN_MS - 1000 - SLACK_MS) / 250 - 1, (RUN_MS - 1000) / 250 + 2);
+	if (reprogram.count < 2 || reprogram.second < reprogrammed + 250) {
+		g_printerr ("reprogram: next call %lld ms after the change to 250 ms\n", (long long) (reprogram.second - reprogrammed));
+		failed++;
+	}
+
+	timer_wheel_remove (steady.id);
+	timer_wheel_remove (remover.id);
+	timer_wheel_remove (reprogram.id);
+	if (timer_wheel_remove (victim.id)) {
+		g_printerr ("victim: removed twice\n");
+		failed++;
+	}
+	g_main_loop_unref (loop);
+
+	g_print ("timer wheel: %s (%d failures)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}
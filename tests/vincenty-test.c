@@ -0,0 +1,106 @@
+/*
+ * libslp-location
+ *
+ * Copyright (c) 2010-2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Youngae Kang <youngae.kang@samsung.com>, Yunhan Kim <yhan.kim@samsung.com>,
+ *          Genie Kim <daejins.kim@samsung.com>, Minjune Kim <sena06.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the batch Vincenty kernel, one lane per position, against the scalar geodesic_vincenty () */
+
+#include <math.h>
+#include <glib.h>
+#include <location.h>
+#include "location-geodesic.h"
+
+#define BATCH_MAX	37	/* not a multiple of the lanes, so the padded tail is exercised */
+#define ROUND_COUNT	2000
+/* The batch sin, cos and atan2 are within about 1 ulp of libm, the iteration stops at 1e-12 radian */
+#define TOLERANCE(distance)	(1e-4 + (distance) * 1e-10)
+
+static int
+check_batch (gdouble latitude, gdouble longitude, const LocationPosition *positions, guint count)
+{
+	gdouble distances[BATCH_MAX];
+	int failed = 0;
+	guint i;
+	int ret = geodesic_vincenty_batch (latitude, longitude, positions, count, distances);
+	gboolean converged = TRUE;
+
+	for (i = 0; i < count; i++) {
+		gdouble expected = 0;
+
+		if (geodesic_vincenty (latitude, longitude, positions[i].latitude, positions[i].longitude, &expected) != LOCATION_ERROR_NONE) {
+			/* Nearly antipodal, the batch may still converge where the scalar one stops */
+			converged = FALSE;
+			continue;
+		}
+		if (isnan (distances[i]) || fabs (distances[i] - expected) > TOLERANCE(expected)) {
+			g_printerr ("(%f, %f) to (%f, %f): expected %.6f, batch %.6f\n",
+				latitude, longitude, positions[i].latitude, positions[i].longitude, expected, distances[i]);
+			failed++;
+		}
+	}
+	if (ret != LOCATION_ERROR_NONE && converged) {
+		g_printerr ("(%f, %f): batch failed while every scalar distance converged\n", latitude, longitude);
+		failed++;
+	}
+	return failed;
+}
+
+int
+main (int argc, char *argv[])
+{
+	LocationPosition positions[BATCH_MAX];
+	int failed = 0;
+	guint round, i;
+
+	g_random_set_seed (2011);
+
+	for (round = 0; round < ROUND_COUNT; round++) {
+		gdouble latitude = g_random_double_range (-89, 89);
+		gdouble longitude = g_random_double_range (-180, 180);
+		guint count = g_random_int_range (1, BATCH_MAX + 1);
+		/* Near, regional and global spreads */
+		gdouble spread = (round % 3 == 0) ? 0.01 : (round % 3 == 1) ? 2.0 : 170.0;
+
+		for (i = 0; i < count; i++) {
+			positions[i].latitude = latitude + g_random_double_range (-spread, spread);
+			positions[i].latitude = CLAMP(positions[i].latitude, -89.9, 89.9);
+			positions[i].longitude = longitude + g_random_double_range (-spread, spread);
+			if (positions[i].longitude > 180) positions[i].longitude -= 360;
+			if (positions[i].longitude < -180) positions[i].longitude += 360;
+		}
+		/* The reference itself, and a point on the same meridian */
+		if (count > 2) {
+			positions[0].latitude = latitude;
+			positions[0].longitude = longitude;
+			positions[1].latitude = -latitude / 2;
+			positions[1].longitude = longitude;
+		}
+		failed += check_batch (latitude, longitude, positions, count);
+	}
+
+	/* Both points on the equator */
+	for (i = 0; i < 8; i++) {
+		positions[i].latitude = 0;
+		positions[i].longitude = -170.0 + 40.0 * i;
+	}
+	failed += check_batch (0, 10, positions, 8);
+
+	g_print ("vincenty batch: %s (%d mismatches)\n", failed ? "FAIL" : "PASS", failed);
+	return failed ? 1 : 0;
+}